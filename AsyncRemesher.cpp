@@ -0,0 +1,161 @@
+#include "AsyncRemesher.h"
+#include "Boundary.h"
+#include "CGALMeshGenerator.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+AsyncRemesher::AsyncRemesher(const Boundary& boundary) : boundary_(boundary) {
+    triangulate_thread_ = std::thread(&AsyncRemesher::triangulate_loop, this);
+    convert_thread_ = std::thread(&AsyncRemesher::convert_loop, this);
+}
+
+AsyncRemesher::~AsyncRemesher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    triangulate_thread_.join();
+    convert_thread_.join();
+}
+
+void AsyncRemesher::set_options(const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+AsyncRemesher::Options AsyncRemesher::get_options() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+void AsyncRemesher::submit(const std::vector<Simulation2D::Particle>& particles, int step) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (has_particles_) ++dropped_;
+        // 复用上一次交换回来的缓冲区，稳定运行后不再分配
+        pending_particles_.assign(particles.begin(), particles.end());
+        pending_step_ = step;
+        has_particles_ = true;
+    }
+    wake_.notify_all();
+}
+
+std::shared_ptr<const AsyncRemesher::Mesh> AsyncRemesher::get_triangle_mesh() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return triangle_mesh_;
+}
+
+std::shared_ptr<const AsyncRemesher::Mesh> AsyncRemesher::get_quad_mesh() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return quad_mesh_;
+}
+
+bool AsyncRemesher::is_idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !has_particles_ && !triangulating_ && !pending_triangles_ && !converting_;
+}
+
+void AsyncRemesher::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return !has_particles_ && !triangulating_ && !pending_triangles_ && !converting_; });
+}
+
+size_t AsyncRemesher::get_dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+// 第一级：三角剖分。生成器归本线程所有，粒子数不变时沿用上一次的 CDT 做增量更新
+void AsyncRemesher::triangulate_loop() {
+    CGALMeshGenerator generator;
+    std::vector<Simulation2D::Particle> particles;
+    while (true) {
+        int step = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stop_ || has_particles_; });
+            if (stop_) return;
+            particles.swap(pending_particles_);
+            step = pending_step_;
+            has_particles_ = false;
+            triangulating_ = true;
+        }
+
+        const auto start = Clock::now();
+        generator.update_mesh(particles, boundary_);
+        auto mesh = std::make_shared<Mesh>();
+        mesh->step = step;
+        mesh->vertices = generator.get_vertices();
+        mesh->triangles = generator.get_triangles();
+        mesh->elapsed_ms = elapsed_ms(start);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            triangle_mesh_ = mesh;
+            if (options_.convert_quads && !mesh->triangles.empty()) {
+                if (pending_triangles_) ++dropped_;
+                pending_triangles_ = mesh;
+            }
+            triangulating_ = false;
+        }
+        wake_.notify_all();
+        idle_.notify_all();
+    }
+}
+
+// 第二级：四边形转换与光顺，与第一级处理下一份快照同时进行
+void AsyncRemesher::convert_loop() {
+    Qmorph qmorph;
+    MeshSmoother smoother;
+    Mesh2D mesh;
+    while (true) {
+        std::shared_ptr<const Mesh> input;
+        Options options;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_triangles_ != nullptr; });
+            if (stop_) return;
+            input = std::move(pending_triangles_);
+            pending_triangles_.reset();
+            options = options_;
+            converting_ = true;
+        }
+
+        const auto start = Clock::now();
+        qmorph.set_mode(options.quad_mode);
+        qmorph.set_all_quad(options.all_quad);
+        mesh.build(input->vertices, input->triangles);
+        auto result = qmorph.run(mesh);
+
+        auto output = std::make_shared<Mesh>();
+        output->step = input->step;
+        output->vertices = result.vertices.empty() ? input->vertices : std::move(result.vertices);
+        output->triangles = std::move(result.remaining_triangles);
+        output->quads = std::move(result.quads);
+        if (options.smooth && !output->quads.empty()) {
+            Mesh2D quad_mesh;
+            quad_mesh.build(output->vertices, output->triangles, output->quads);
+            smoother.set_options(options.smooth_options);
+            if (smoother.smooth(quad_mesh)) output->vertices = quad_mesh.get_positions();
+        }
+        output->elapsed_ms = elapsed_ms(start);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quad_mesh_ = output;
+            converting_ = false;
+        }
+        idle_.notify_all();
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <glm/glm.hpp>
+#include "Simulation2D.h"
+#include "Mesh2D.h"
+#include "MeshSmoother.h"
+#include "Qmorph.h"
+
+class Boundary;
+
+// 流水线式的后台重剖分：模拟线程只提交粒子快照，不等待网格生成。
+// 第一级线程对最新快照做三角剖分 (保留 CDT 增量更新)，第二级线程同时对上一份三角网格做
+// Q-Morph 转换与光顺；每级只有一个输入槽，来不及处理的旧快照直接被新快照覆盖。
+// 调用方随时通过 get_*_mesh() 取得最近完成的网格
+class AsyncRemesher {
+public:
+    struct Options {
+        bool convert_quads = true;
+        Qmorph::Mode quad_mode = Qmorph::Mode::Matching;
+        bool all_quad = true; // 见 Qmorph::set_all_quad
+        bool smooth = true;
+        MeshSmoother::Options smooth_options;
+    };
+
+    // 一份完成的网格；step 为生成它的粒子快照所在的模拟步
+    struct Mesh {
+        int step = 0;
+        std::vector<glm::vec2> vertices;
+        std::vector<MeshTriangle> triangles; // 三角网格，或四边形网格中剩余的三角形
+        std::vector<MeshQuad> quads;
+        double elapsed_ms = 0.0;             // 本级的耗时
+    };
+
+    explicit AsyncRemesher(const Boundary& boundary);
+    ~AsyncRemesher();
+
+    AsyncRemesher(const AsyncRemesher&) = delete;
+    AsyncRemesher& operator=(const AsyncRemesher&) = delete;
+
+    // 选项在每份快照开始处理时读取，运行中修改对下一份快照生效
+    void set_options(const Options& options);
+    Options get_options() const;
+
+    // 提交粒子快照 (拷贝)，不阻塞；上一份快照尚未开始处理时被替换
+    void submit(const std::vector<Simulation2D::Particle>& particles, int step);
+
+    // 最近完成的三角网格 / 四边形网格，尚未完成任何一份时为空指针
+    std::shared_ptr<const Mesh> get_triangle_mesh() const;
+    std::shared_ptr<const Mesh> get_quad_mesh() const;
+
+    // 两级都没有待处理或正在处理的快照
+    bool is_idle() const;
+    // 阻塞直到空闲，供无界面的驱动程序在结束前取得最后一份网格
+    void wait_idle();
+
+    // 被新快照覆盖而未处理的快照数 (两级合计)
+    size_t get_dropped() const;
+
+private:
+    void triangulate_loop();
+    void convert_loop();
+
+    const Boundary& boundary_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;  // 有新输入或需要退出
+    std::condition_variable idle_;  // 某一级处理完一份输入
+    bool stop_ = false;
+
+    // 第一级输入：粒子快照
+    std::vector<Simulation2D::Particle> pending_particles_;
+    int pending_step_ = 0;
+    bool has_particles_ = false;
+    bool triangulating_ = false;
+    // 第二级输入：第一级的输出
+    std::shared_ptr<const Mesh> pending_triangles_;
+    bool converting_ = false;
+    size_t dropped_ = 0;
+
+    std::shared_ptr<const Mesh> triangle_mesh_;
+    std::shared_ptr<const Mesh> quad_mesh_;
+
+    std::thread triangulate_thread_;
+    std::thread convert_thread_;
+};
@@ -1,26 +1,31 @@
 #include "BackgroundGrid.h"
 #include "Utils.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
 #include <algorithm>
 #include <vector>
 
 BackgroundGrid::BackgroundGrid(const Boundary& boundary, float grid_cell_size) {
+    SPHMESH_PROFILE_SCOPE("grid.build");
     cell_size_ = grid_cell_size;
     const auto& aabb = boundary.get_aabb();
     min_coords_ = { aabb.x, aabb.y };
     width_ = static_cast<int>((aabb.z - aabb.x) / cell_size_) + 3;
     height_ = static_cast<int>((aabb.w - aabb.y) / cell_size_) + 3;
     target_size_field_.resize(width_ * height_);
-    target_direction_field_.resize(width_ * height_, { 1.0f, 0.0f }); // ĬϷΪX
+    target_direction_field_.resize(width_ * height_, { 1.0f, 0.0f }); // 默认方向为X轴
+    sdf_field_.resize(width_ * height_, 0.0f);
+    sdf_gradient_field_.resize(width_ * height_, { 0.0f, 0.0f });
 
     compute_fields(boundary);
 }
 
-// ޸ģ h_t  D_t
+// 核心修改：计算 h_t 和 D_t
 void BackgroundGrid::compute_fields(const Boundary& boundary) {
     const auto& boundary_vertices = boundary.get_vertices();
     if (boundary_vertices.size() < 2) return;
 
-    // --- 1. ߽Ŀߴ h_t (֮ǰͬ) ---
+    // --- 1. 计算边界目标尺寸 h_t (与之前相同) ---
     std::vector<float> boundary_target_sizes(boundary_vertices.size());
     float h_min = cell_size_ * 0.5f;
     float h_max = cell_size_ * 2.0f;
@@ -37,42 +42,53 @@ void BackgroundGrid::compute_fields(const Boundary& boundary) {
         boundary_target_sizes[i] = glm::mix(h_min, h_max, t * t);
     }
 
-    // --- 2. SDFͳߴ糡 h_t (֮ǰ) ---
-    std::vector<float> sdf(width_ * height_, FLT_MAX);
-    for (int y = 0; y < height_; ++y) {
-        for (int x = 0; x < width_; ++x) {
-            glm::vec2 grid_pos = min_coords_ + glm::vec2(x * cell_size_, y * cell_size_);
-            float dist_to_boundary = glm::distance(grid_pos, closest_point_on_polygon(grid_pos, boundary_vertices));
-            sdf[y * width_ + x] = boundary.is_inside(grid_pos) ? dist_to_boundary : -dist_to_boundary;
+    // --- 2. 计算SDF和尺寸场 h_t (与之前类似) ---
+    // is_inside 按奇偶规则处理孔洞，孔洞内部的 SDF 为负；各行互不依赖，按行分给任务池
+    std::vector<float>& sdf = sdf_field_;
+    TaskScheduler::instance().parallel_for(0, height_, 4, [&](size_t lo, size_t hi) {
+        for (int y = static_cast<int>(lo); y < static_cast<int>(hi); ++y) {
+            for (int x = 0; x < width_; ++x) {
+                glm::vec2 grid_pos = min_coords_ + glm::vec2(x * cell_size_, y * cell_size_);
+                // 距离取到所有环 (外环与孔洞) 的最近距离，孔洞周围同样会加密
+                float dist_to_boundary = glm::distance(grid_pos, boundary.closest_point(grid_pos));
+                sdf[y * width_ + x] = boundary.is_inside(grid_pos) ? dist_to_boundary : -dist_to_boundary;
 
-            // --- ӾЧ޸ ---
-            float influence_radius = h_max * 5.0f;
-            float t = std::min(dist_to_boundary / influence_radius, 1.0f);
-            // ʹ t*t (η) ʹÿ߽ߴ仯Զ߽仯
-            // ġȸߡӾЧ
-            target_size_field_[y * width_ + x] = glm::mix(h_min, h_max, t * t);
+                // --- 核心视觉效果修改 ---
+                float influence_radius = h_max * 5.0f;
+                float t = std::min(dist_to_boundary / influence_radius, 1.0f);
+                // 使用 t*t (二次方) 会使得靠近边界的区域尺寸变化更慢，远离边界的区域变化更快
+                // 这会产生更清晰的“等高线”视觉效果
+                target_size_field_[y * width_ + x] = glm::mix(h_min, h_max, t * t);
+            }
         }
-    }
+    });
 
-    // --- 3. 㷽 D_t (SDFݶ) ---
-    for (int y = 1; y < height_ - 1; ++y) {
-        for (int x = 1; x < width_ - 1; ++x) {
-            // ʹĲּSDFݶ
-            float grad_x = (sdf[y * width_ + (x + 1)] - sdf[y * width_ + (x - 1)]) / (2.0f * cell_size_);
-            float grad_y = (sdf[(y + 1) * width_ + x] - sdf[(y - 1) * width_ + x]) / (2.0f * cell_size_);
-            glm::vec2 grad = { grad_x, grad_y };
-            if (glm::length(grad) > 1e-6f) {
-                // SDFݶȵĴֱ (ֵߵ߷)
-                glm::vec2 tangent = { -grad.y, grad.x };
-                target_direction_field_[y * width_ + x] = glm::normalize(tangent);
+    // --- 3. 计算方向 D_t (SDF的梯度) ---
+    // 梯度同时保存下来，边界处理时用于把逃逸粒子沿梯度投影回区域内
+    TaskScheduler::instance().parallel_for(0, height_, 4, [&](size_t lo, size_t hi) {
+        for (int y = static_cast<int>(lo); y < static_cast<int>(hi); ++y) {
+            for (int x = 0; x < width_; ++x) {
+                // 内部结点使用中心差分，网格边缘退化为单侧差分
+                int xl = std::max(x - 1, 0), xr = std::min(x + 1, width_ - 1);
+                int yl = std::max(y - 1, 0), yr = std::min(y + 1, height_ - 1);
+                float grad_x = (sdf[y * width_ + xr] - sdf[y * width_ + xl]) / ((xr - xl) * cell_size_);
+                float grad_y = (sdf[yr * width_ + x] - sdf[yl * width_ + x]) / ((yr - yl) * cell_size_);
+                glm::vec2 grad = { grad_x, grad_y };
+                sdf_gradient_field_[y * width_ + x] = grad;
+                if (x == 0 || y == 0 || x == width_ - 1 || y == height_ - 1) continue;
+                if (glm::length(grad) > 1e-6f) {
+                    // 方向是SDF梯度的垂直方向 (等值线的切线方向)
+                    glm::vec2 tangent = { -grad.y, grad.x };
+                    target_direction_field_[y * width_ + x] = glm::normalize(tangent);
+                }
             }
         }
-    }
+    });
 }
 
-// ˫ԲֵȡλõĿ
+// 双线性插值获取任意位置的目标数据
 float BackgroundGrid::get_target_size(const glm::vec2& pos) const {
-    // ... (һͬ) ...
+    // ... (代码与上一版相同) ...
     glm::vec2 local_pos = (pos - min_coords_) / cell_size_;
     int x0 = static_cast<int>(local_pos.x);
     int y0 = static_cast<int>(local_pos.y);
@@ -92,7 +108,7 @@ float BackgroundGrid::get_target_size(const glm::vec2& pos) const {
 }
 
 glm::vec2 BackgroundGrid::get_target_direction(const glm::vec2& pos) const {
-    // ... (˫Բֵ) ...
+    // ... (双线性插值) ...
     glm::vec2 local_pos = (pos - min_coords_) / cell_size_;
     int x0 = static_cast<int>(local_pos.x);
     int y0 = static_cast<int>(local_pos.y);
@@ -109,4 +125,45 @@ glm::vec2 BackgroundGrid::get_target_direction(const glm::vec2& pos) const {
     glm::vec2 d_y0 = glm::mix(d00, d10, tx);
     glm::vec2 d_y1 = glm::mix(d01, d11, tx);
     return glm::normalize(glm::mix(d_y0, d_y1, ty));
+}
+
+bool BackgroundGrid::covers(const glm::vec2& pos) const {
+    glm::vec2 local_pos = (pos - min_coords_) / cell_size_;
+    return local_pos.x >= 0.0f && local_pos.y >= 0.0f &&
+        local_pos.x <= static_cast<float>(width_ - 1) && local_pos.y <= static_cast<float>(height_ - 1);
+}
+
+// 双线性插值获取 SDF，内部为正、外部为负
+float BackgroundGrid::get_signed_distance(const glm::vec2& pos) const {
+    glm::vec2 local_pos = (pos - min_coords_) / cell_size_;
+    int x0 = static_cast<int>(local_pos.x);
+    int y0 = static_cast<int>(local_pos.y);
+    x0 = std::max(0, std::min(x0, width_ - 2));
+    y0 = std::max(0, std::min(y0, height_ - 2));
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
+    float tx = local_pos.x - x0;
+    float ty = local_pos.y - y0;
+    float s00 = sdf_field_[y0 * width_ + x0];
+    float s10 = sdf_field_[y0 * width_ + x1];
+    float s01 = sdf_field_[y1 * width_ + x0];
+    float s11 = sdf_field_[y1 * width_ + x1];
+    return glm::mix(glm::mix(s00, s10, tx), glm::mix(s01, s11, tx), ty);
+}
+
+glm::vec2 BackgroundGrid::get_sdf_gradient(const glm::vec2& pos) const {
+    glm::vec2 local_pos = (pos - min_coords_) / cell_size_;
+    int x0 = static_cast<int>(local_pos.x);
+    int y0 = static_cast<int>(local_pos.y);
+    x0 = std::max(0, std::min(x0, width_ - 2));
+    y0 = std::max(0, std::min(y0, height_ - 2));
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
+    float tx = local_pos.x - x0;
+    float ty = local_pos.y - y0;
+    glm::vec2 g00 = sdf_gradient_field_[y0 * width_ + x0];
+    glm::vec2 g10 = sdf_gradient_field_[y0 * width_ + x1];
+    glm::vec2 g01 = sdf_gradient_field_[y1 * width_ + x0];
+    glm::vec2 g11 = sdf_gradient_field_[y1 * width_ + x1];
+    return glm::mix(glm::mix(g00, g10, tx), glm::mix(g01, g11, tx), ty);
 }
\ No newline at end of file
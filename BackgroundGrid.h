@@ -8,15 +8,23 @@ public:
     BackgroundGrid(const Boundary& boundary, float grid_cell_size);
 
     float get_target_size(const glm::vec2& pos) const;
-    // ȡָλõĿ귽 D_t
+    // 新增：获取指定位置的目标方向 D_t
     glm::vec2 get_target_direction(const glm::vec2& pos) const;
-    // --- ӿ ---
+    // 新增：有符号距离场 (SDF，内部为正) 及其梯度的双线性插值
+    float get_signed_distance(const glm::vec2& pos) const;
+    glm::vec2 get_sdf_gradient(const glm::vec2& pos) const;
+    // 新增：pos 是否落在网格覆盖范围内 (范围外的插值结果不可信)
+    bool covers(const glm::vec2& pos) const;
+    // 新增：SDF 插值误差的上界，窄带内需要回退到精确的多边形计算
+    float get_sdf_band() const { return cell_size_ * 1.5f; }
+    // --- 新增公共接口 ---
     int get_width() const { return width_; }
     int get_height() const { return height_; }
     float get_cell_size() const { return cell_size_; }
     glm::vec2 get_min_coords() const { return min_coords_; }
     const std::vector<float>& get_target_size_field() const { return target_size_field_; }
-    // ---  ---
+    const std::vector<float>& get_sdf_field() const { return sdf_field_; }
+    // --- 结束 ---
 
 private:
     void compute_fields(const Boundary& boundary);
@@ -24,6 +32,8 @@ private:
     glm::vec2 min_coords_;
     float cell_size_;
     int width_, height_;
-    std::vector<float> target_size_field_;     // 洢 h_t
-    std::vector<glm::vec2> target_direction_field_; // 洢 D_t
+    std::vector<float> target_size_field_;     // 存储 h_t
+    std::vector<glm::vec2> target_direction_field_; // 新增：存储 D_t
+    std::vector<float> sdf_field_;                  // 新增：保留 SDF，供边界处理使用
+    std::vector<glm::vec2> sdf_gradient_field_;     // 新增：SDF 梯度 (指向内部)
 };
\ No newline at end of file
@@ -1,9 +1,28 @@
 #include "Boundary.h"
 #include <algorithm> // for std::min/max
+#include <utility>
 
-Boundary::Boundary(const std::vector<glm::vec2>& vertices) : vertices_(vertices) 
+Boundary::Boundary(std::vector<glm::vec2> vertices) : vertices_(std::move(vertices)) 
 {
     calculate_aabb();
+    build_index();
+}
+
+Boundary::Boundary(std::vector<glm::vec2> outer, std::vector<std::vector<glm::vec2>> holes)
+    : vertices_(std::move(outer)), holes_(std::move(holes))
+{
+    calculate_aabb();
+    build_index();
+}
+
+void Boundary::build_index()
+{
+    std::vector<const std::vector<glm::vec2>*> rings;
+    rings.reserve(get_num_rings());
+    for (size_t i = 0; i < get_num_rings(); ++i) {
+        rings.push_back(&get_ring(i));
+    }
+    edge_index_.build(rings);
 }
 
 const std::vector<glm::vec2>& Boundary::get_vertices() const 
@@ -36,29 +55,14 @@ void Boundary::calculate_aabb()
     aabb_ = glm::vec4(min_coords.x, min_coords.y, max_coords.x, max_coords.y);
 }
 
-// ʹ Ray-Casting (Ͷ) 㷨жϵǷڶڲ
+// 使用 Ray-Casting (射线投射) 算法判断点是否在多边形内部
+// 外环与孔洞的边都放在 EdgeIndex 中，只需检查点所在水平条带内的边
 bool Boundary::is_inside(const glm::vec2& point) const 
 {
-    if (vertices_.empty()) 
-    {
-        return false;
-    }
-    int num_vertices = vertices_.size();
-    bool inside = false;
-
-    // εÿһ
-    for (int i = 0, j = num_vertices - 1; i < num_vertices; j = i++) 
-    {
-        const auto& p1 = vertices_[i];
-        const auto& p2 = vertices_[j];
+    return edge_index_.is_inside(point);
+}
 
-        // ǷڱߵY᷶Χ
-        if (((p1.y > point.y) != (p2.y > point.y)) &&
-            // Ƿ(ӵ)
-            (point.x < (p2.x - p1.x) * (point.y - p1.y) / (p2.y - p1.y) + p1.x)) 
-        {
-            inside = !inside; // ҵһ㣬״̬ת
-        }
-    }
-    return inside;
-}
\ No newline at end of file
+glm::vec2 Boundary::closest_point(const glm::vec2& point) const
+{
+    return edge_index_.closest_point(point);
+}
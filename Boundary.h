@@ -2,25 +2,42 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include <string>
+#include "EdgeIndex.h"
 
 class Boundary 
 {
 public:
-    // 캯һ߽״Ķб
-    Boundary(const std::vector<glm::vec2>& vertices);
+    // 构造函数：接收一个定义边界形状的顶点列表
+    // 按值接收，调用方传入右值 (如导入器的结果) 时不会产生额外拷贝
+    Boundary(std::vector<glm::vec2> vertices);
+    // 新增：外环 + 任意数量的孔洞环 (岛屿等)
+    Boundary(std::vector<glm::vec2> outer, std::vector<std::vector<glm::vec2>> holes);
 
-    // жһǷڱ߽ڲ (㷨)
+    // 判断一个点是否在边界内部 (射线算法，按奇偶规则计入孔洞)
     bool is_inside(const glm::vec2& point) const;
 
-    // ȡ߽ж㣬Ⱦ
+    // 新增：所有环 (外环与孔洞) 上离 point 最近的点
+    glm::vec2 closest_point(const glm::vec2& point) const;
+
+    // 获取边界外环的所有顶点，用于渲染
     const std::vector<glm::vec2>& get_vertices() const;
+    // 新增：孔洞环
+    const std::vector<std::vector<glm::vec2>>& get_holes() const { return holes_; }
+    // 新增：环的总数及按序号访问，0 为外环，之后依次为孔洞
+    size_t get_num_rings() const { return 1 + holes_.size(); }
+    const std::vector<glm::vec2>& get_ring(size_t i) const { return i == 0 ? vertices_ : holes_[i - 1]; }
+    // 新增：所有环共享的边空间索引
+    const EdgeIndex& get_edge_index() const { return edge_index_; }
 
-    // ȡ߽Χ (AABB)
+    // 获取边界的轴对齐包围盒 (AABB)，用于粒子生成
     const glm::vec4& get_aabb() const;
 
 private:
     std::vector<glm::vec2> vertices_;
+    std::vector<std::vector<glm::vec2>> holes_;
     glm::vec4 aabb_; // x_min, y_min, x_max, y_max
+    EdgeIndex edge_index_;
 
-    void calculate_aabb(); // ˽иڼΧ
-};
\ No newline at end of file
+    void calculate_aabb(); // 私有辅助函数，用于计算包围盒
+    void build_index();
+};
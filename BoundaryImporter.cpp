@@ -0,0 +1,457 @@
+#include "BoundaryImporter.h"
+#include "Utils.h"
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+// --- 分块词法分析器：在固定大小的缓冲区上直接切分记号 ---
+// 跨块的记号会把剩余部分挪到缓冲区开头后继续读取，因此不需要构造任何中间字符串
+class ChunkedLexer {
+public:
+    enum class Type { Number, Word, Symbol, Newline, End };
+    struct Token {
+        Type type = Type::End;
+        double number = 0.0;
+        char symbol = 0;
+        const char* text = nullptr; // Word 的内容，只在下一次 next() 之前有效
+        size_t length = 0;
+    };
+
+    ChunkedLexer(FILE* file, size_t chunk_size)
+        : file_(file), buffer_(std::max<size_t>(chunk_size, 64)) {}
+
+    Token next() {
+        for (;;) {
+            if (pos_ == end_ && !refill()) return {};
+            const char c = buffer_[pos_];
+            if (c == ' ' || c == '\t' || c == '\r') { ++pos_; continue; }
+            if (c == '\n') {
+                ++pos_;
+                Token t; t.type = Type::Newline;
+                return t;
+            }
+            if (c == '#') { // 注释直到行尾 (.poly 与 CSV)
+                for (;;) {
+                    while (pos_ < end_ && buffer_[pos_] != '\n') ++pos_;
+                    if (pos_ < end_ || !refill()) break;
+                }
+                continue;
+            }
+            if (is_token_char(c)) return scan_token();
+            ++pos_;
+            Token t; t.type = Type::Symbol; t.symbol = c;
+            return t;
+        }
+    }
+
+private:
+    static bool is_token_char(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-' || c == '+' || c == '_';
+    }
+
+    Token scan_token() {
+        size_t len = 0;
+        for (;;) {
+            while (pos_ + len < end_ && is_token_char(buffer_[pos_ + len])) ++len;
+            if (pos_ + len < end_ || !refill()) break; // refill 之后 pos_ 归零，len 仍然有效
+        }
+        const char* first = buffer_.data() + pos_;
+        const char* last = first + len;
+        pos_ += len;
+
+        Token t;
+        const char c = *first;
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+' || c == '.') {
+            const char* start = (c == '+') ? first + 1 : first;
+            auto res = std::from_chars(start, last, t.number);
+            if (res.ec == std::errc() && res.ptr == last) {
+                t.type = Type::Number;
+                return t;
+            }
+        }
+        t.type = Type::Word;
+        t.text = first;
+        t.length = len;
+        return t;
+    }
+
+    // 把未消费的尾部移到缓冲区开头，再从文件读入新的一块
+    bool refill() {
+        if (eof_) return false;
+        if (pos_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+        }
+        if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2); // 单个记号比整块还长
+        size_t n = std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+        end_ += n;
+        if (n == 0) eof_ = true;
+        return n > 0;
+    }
+
+    FILE* file_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0, end_ = 0;
+    bool eof_ = false;
+};
+
+bool word_equals(const ChunkedLexer::Token& t, const char* word) {
+    size_t n = std::strlen(word);
+    if (t.length != n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::toupper(static_cast<unsigned char>(t.text[i])) != word[i]) return false;
+    }
+    return true;
+}
+
+// --- 环收集器：逐点接收坐标，按窗口做 Douglas-Peucker 简化后写入环 ---
+// 窗口满时只输出窗口内除最后一点外的保留点，最后一点作为下一个窗口的起点，
+// 因此内存只与窗口大小和简化后的点数有关
+class RingCollector {
+public:
+    explicit RingCollector(const BoundaryImporter::Options& options)
+        : tolerance_(options.simplify_tolerance), window_size_(std::max<size_t>(options.simplify_window, 3)) {}
+
+    void add_point(const glm::vec2& p) {
+        ++raw_count_;
+        if (!open_) {
+            rings_.emplace_back();
+            open_ = true;
+            has_last_ = false;
+        }
+        if (has_last_ && last_ == p) return; // 去掉连续重复点
+        last_ = p;
+        has_last_ = true;
+        if (tolerance_ <= 0.0f) {
+            rings_.back().push_back(p);
+            return;
+        }
+        window_.push_back(p);
+        if (window_.size() >= window_size_) flush(false);
+    }
+
+    void end_ring() {
+        if (!open_) return;
+        if (tolerance_ > 0.0f) flush(true);
+        window_.clear();
+        open_ = false;
+        auto& ring = rings_.back();
+        // 显式闭合的环 (WKT) 首尾重复，去掉最后一点
+        if (ring.size() > 1 && ring.front() == ring.back()) ring.pop_back();
+        if (ring.size() < 3) rings_.pop_back();
+    }
+
+    std::vector<std::vector<glm::vec2>>& rings() { return rings_; }
+    size_t raw_count() const { return raw_count_; }
+
+private:
+    void flush(bool last) {
+        if (window_.empty()) return;
+        const size_t n = window_.size();
+        keep_.assign(n, 0);
+        keep_[0] = keep_[n - 1] = 1;
+        const float tol_sq = tolerance_ * tolerance_;
+        stack_.clear();
+        if (n > 2) stack_.push_back({ 0, n - 1 });
+        while (!stack_.empty()) {
+            auto [first, last_idx] = stack_.back();
+            stack_.pop_back();
+            float max_dist_sq = 0.0f;
+            size_t split = first;
+            for (size_t i = first + 1; i < last_idx; ++i) {
+                glm::vec2 q = closest_point_on_segment(window_[i], window_[first], window_[last_idx]);
+                float d = glm::dot(window_[i] - q, window_[i] - q);
+                if (d > max_dist_sq) { max_dist_sq = d; split = i; }
+            }
+            if (max_dist_sq > tol_sq) {
+                keep_[split] = 1;
+                if (split - first > 1) stack_.push_back({ first, split });
+                if (last_idx - split > 1) stack_.push_back({ split, last_idx });
+            }
+        }
+        auto& ring = rings_.back();
+        const size_t emit_count = last ? n : n - 1;
+        for (size_t i = 0; i < emit_count; ++i) {
+            if (keep_[i]) ring.push_back(window_[i]);
+        }
+        glm::vec2 anchor = window_.back();
+        window_.clear();
+        if (!last) window_.push_back(anchor);
+    }
+
+    float tolerance_;
+    size_t window_size_;
+    bool open_ = false;
+    bool has_last_ = false;
+    glm::vec2 last_ = glm::vec2(0.0f);
+    size_t raw_count_ = 0;
+    std::vector<glm::vec2> window_;
+    std::vector<unsigned char> keep_;
+    std::vector<std::pair<size_t, size_t>> stack_;
+    std::vector<std::vector<glm::vec2>> rings_;
+};
+
+float signed_area(const std::vector<glm::vec2>& ring) {
+    float area = 0.0f;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        area += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+    }
+    return 0.5f * area;
+}
+
+// first_is_outer 为 true 时第一个环为外环 (WKT/CSV 约定)，否则取面积最大的环
+bool assign_rings(RingCollector& collector, BoundaryImporter::Result& result, bool first_is_outer, const std::string& path) {
+    auto& rings = collector.rings();
+    if (rings.empty()) {
+        std::cerr << "Error: No polygon ring found in " << path << std::endl;
+        return false;
+    }
+    size_t outer = 0;
+    if (!first_is_outer) {
+        float best = -1.0f;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            float a = std::abs(signed_area(rings[i]));
+            if (a > best) { best = a; outer = i; }
+        }
+    }
+    result.outer = std::move(rings[outer]);
+    result.holes.clear();
+    result.holes.reserve(rings.size() - 1);
+    for (size_t i = 0; i < rings.size(); ++i) {
+        if (i != outer) result.holes.push_back(std::move(rings[i]));
+    }
+    result.raw_vertex_count = collector.raw_count();
+
+    size_t kept = result.outer.size();
+    for (const auto& h : result.holes) kept += h.size();
+    std::cout << "Imported boundary " << path << ": " << result.raw_vertex_count << " vertices ("
+        << kept << " after simplification), " << result.holes.size() << " holes." << std::endl;
+    return true;
+}
+
+struct FileCloser {
+    void operator()(FILE* f) const { if (f) std::fclose(f); }
+};
+
+FILE* open_file(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) std::cerr << "Error: Cannot open boundary file " << path << std::endl;
+    return f;
+}
+
+// 读取下一条非空记录 (一行) 中的数字，返回数字个数；文件结束返回 -1
+int next_record(ChunkedLexer& lexer, double* values, int max_values) {
+    for (;;) {
+        int count = 0;
+        bool any = false;
+        for (;;) {
+            auto t = lexer.next();
+            if (t.type == ChunkedLexer::Type::End) return any ? count : -1;
+            if (t.type == ChunkedLexer::Type::Newline) break;
+            any = true;
+            if (t.type == ChunkedLexer::Type::Number && count < max_values) values[count++] = t.number;
+        }
+        if (any) return count;
+    }
+}
+
+} // namespace
+
+bool BoundaryImporter::load(const std::string& path, Result& result) {
+    return load(path, result, Options());
+}
+
+bool BoundaryImporter::load(const std::string& path, Result& result, const Options& options) {
+    std::string ext;
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos) {
+        ext = path.substr(dot + 1);
+        for (auto& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (ext == "poly") return load_poly(path, result, options);
+    if (ext == "wkt") return load_wkt(path, result, options);
+    return load_csv(path, result, options);
+}
+
+// Triangle 的 .poly 格式：顶点段、线段段、孔洞段 (孔洞点忽略，孔洞由奇偶规则决定)
+// 线段首尾相接成环，面积最大的环作为外环
+bool BoundaryImporter::load_poly(const std::string& path, Result& result, const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedLexer lexer(file.get(), options.chunk_size);
+
+    double v[8];
+    if (next_record(lexer, v, 8) < 1) {
+        std::cerr << "Error: Missing vertex header in " << path << std::endl;
+        return false;
+    }
+    const long long num_vertices = static_cast<long long>(v[0]);
+    if (num_vertices <= 0) {
+        std::cerr << "Error: .poly files with a separate .node file are not supported: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec2> points;
+    points.reserve(static_cast<size_t>(num_vertices));
+    long long index_base = 0;
+    for (long long i = 0; i < num_vertices; ++i) {
+        if (next_record(lexer, v, 8) < 3) {
+            std::cerr << "Error: Truncated vertex list in " << path << std::endl;
+            return false;
+        }
+        if (i == 0) index_base = static_cast<long long>(v[0]);
+        points.emplace_back(static_cast<float>(v[1]), static_cast<float>(v[2]));
+    }
+
+    long long num_segments = 0;
+    if (next_record(lexer, v, 8) >= 1) num_segments = static_cast<long long>(v[0]);
+
+    RingCollector collector(options);
+    if (num_segments <= 0) {
+        // 没有线段时按顶点顺序组成单个环
+        for (const auto& p : points) collector.add_point(p);
+        collector.end_ring();
+        return assign_rings(collector, result, true, path);
+    }
+
+    // 每个顶点最多两个相邻顶点，邻接关系存放在扁平数组中
+    const unsigned int none = UINT_MAX;
+    std::vector<unsigned int> adj(points.size() * 2, none);
+    for (long long s = 0; s < num_segments; ++s) {
+        if (next_record(lexer, v, 8) < 3) {
+            std::cerr << "Error: Truncated segment list in " << path << std::endl;
+            return false;
+        }
+        long long a = static_cast<long long>(v[1]) - index_base;
+        long long b = static_cast<long long>(v[2]) - index_base;
+        if (a < 0 || b < 0 || a >= num_vertices || b >= num_vertices || a == b) continue;
+        for (auto [from, to] : { std::pair<long long, long long>{ a, b }, { b, a } }) {
+            unsigned int* slot = &adj[from * 2];
+            if (slot[0] == none) slot[0] = static_cast<unsigned int>(to);
+            else if (slot[1] == none) slot[1] = static_cast<unsigned int>(to);
+            else {
+                std::cerr << "Error: Vertex " << from + index_base << " has more than two segments in " << path << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::vector<unsigned char> visited(points.size(), 0);
+    for (unsigned int start = 0; start < points.size(); ++start) {
+        if (visited[start] || adj[start * 2] == none) continue;
+        if (adj[start * 2 + 1] == none) {
+            std::cerr << "Warning: Open polyline at vertex " << start + index_base << " ignored in " << path << std::endl;
+            visited[start] = 1;
+            continue;
+        }
+        unsigned int prev = none, cur = start;
+        while (cur != none && !visited[cur]) {
+            visited[cur] = 1;
+            collector.add_point(points[cur]);
+            unsigned int next = (adj[cur * 2] != prev) ? adj[cur * 2] : adj[cur * 2 + 1];
+            prev = cur;
+            cur = next;
+        }
+        collector.end_ring();
+    }
+    return assign_rings(collector, result, false, path);
+}
+
+// 每行一个点 "x,y" (也接受空格或分号分隔)；空行或非数字行 (如表头、"hole") 表示开始新的环
+bool BoundaryImporter::load_csv(const std::string& path, Result& result, const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedLexer lexer(file.get(), options.chunk_size);
+    RingCollector collector(options);
+
+    double v[2];
+    int count = 0;
+    bool has_word = false;
+    for (;;) {
+        auto t = lexer.next();
+        if (t.type == ChunkedLexer::Type::Number) {
+            if (count < 2) v[count] = t.number;
+            ++count;
+        }
+        else if (t.type == ChunkedLexer::Type::Word) {
+            has_word = true;
+        }
+        else if (t.type == ChunkedLexer::Type::Newline || t.type == ChunkedLexer::Type::End) {
+            if (count >= 2 && !has_word) collector.add_point({ static_cast<float>(v[0]), static_cast<float>(v[1]) });
+            else if (t.type == ChunkedLexer::Type::Newline) collector.end_ring();
+            count = 0;
+            has_word = false;
+            if (t.type == ChunkedLexer::Type::End) break;
+        }
+    }
+    collector.end_ring();
+    return assign_rings(collector, result, true, path);
+}
+
+// POLYGON ((外环), (孔洞), ...)；MULTIPOLYGON 只读取第一个多边形
+bool BoundaryImporter::load_wkt(const std::string& path, Result& result, const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedLexer lexer(file.get(), options.chunk_size);
+    RingCollector collector(options);
+
+    int ring_depth = 0; // 环所在的括号层数：POLYGON 为 2，MULTIPOLYGON 为 3
+    int depth = 0;
+    double coords[2];
+    int count = 0;
+    auto emit_point = [&]() {
+        if (count >= 2) collector.add_point({ static_cast<float>(coords[0]), static_cast<float>(coords[1]) });
+        count = 0;
+    };
+
+    for (bool done = false; !done;) {
+        auto t = lexer.next();
+        switch (t.type) {
+        case ChunkedLexer::Type::End:
+            done = true;
+            break;
+        case ChunkedLexer::Type::Word:
+            if (depth == 0 && word_equals(t, "POLYGON")) ring_depth = 2;
+            else if (depth == 0 && word_equals(t, "MULTIPOLYGON")) ring_depth = 3;
+            else if (word_equals(t, "EMPTY")) done = true;
+            break;
+        case ChunkedLexer::Type::Number:
+            if (depth == ring_depth && count < 2) coords[count] = t.number;
+            if (depth == ring_depth) ++count;
+            break;
+        case ChunkedLexer::Type::Symbol:
+            if (t.symbol == '(') {
+                if (ring_depth == 0) {
+                    std::cerr << "Error: Only POLYGON and MULTIPOLYGON WKT geometries are supported: " << path << std::endl;
+                    return false;
+                }
+                ++depth;
+            }
+            else if (t.symbol == ',' && depth == ring_depth) {
+                emit_point();
+            }
+            else if (t.symbol == ')') {
+                if (depth == ring_depth) {
+                    emit_point();
+                    collector.end_ring();
+                }
+                --depth;
+                if (ring_depth == 3 && depth == 1) done = true; // 第一个多边形结束
+                if (depth <= 0) done = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    collector.end_ring();
+    return assign_rings(collector, result, true, path);
+}
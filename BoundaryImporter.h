@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// 流式边界导入器：按块读取 .poly / CSV / WKT 折线文件，
+// 直接解析缓冲区中的数字，不构造中间字符串；
+// 可选地在读取过程中对折线做 Douglas-Peucker 简化
+class BoundaryImporter {
+public:
+    struct Options {
+        // 简化容差 (与坐标同单位)，0 表示不简化，通常取 tolerance_for_min_size(h_min)
+        float simplify_tolerance = 0.0f;
+        // 每次从文件读取的字节数
+        size_t chunk_size = 1 << 20;
+        // 流式简化的窗口大小 (点数)，窗口满时先对窗口内的点做简化并输出
+        size_t simplify_window = 4096;
+    };
+
+    // 导入结果：外环与孔洞环，可直接 std::move 给 Boundary 的构造函数
+    struct Result {
+        std::vector<glm::vec2> outer;
+        std::vector<std::vector<glm::vec2>> holes;
+        size_t raw_vertex_count = 0; // 简化前读取到的顶点数
+    };
+
+    // 按扩展名选择格式：.poly、.wkt，其余 (.csv/.txt/.xy) 按 CSV 读取
+    static bool load(const std::string& path, Result& result, const Options& options);
+    static bool load(const std::string& path, Result& result);
+
+    static bool load_poly(const std::string& path, Result& result, const Options& options);
+    static bool load_csv(const std::string& path, Result& result, const Options& options);
+    static bool load_wkt(const std::string& path, Result& result, const Options& options);
+
+    // 简化容差与最小目标尺寸挂钩：远小于 h_min 的几何细节在网格中本来就无法分辨
+    static float tolerance_for_min_size(float h_min, float factor = 0.25f) { return h_min * factor; }
+};
@@ -1,62 +1,359 @@
 #include "CGALMeshGenerator.h"
+#include "Profiler.h"
 #include <iostream>
-#include <map>
 #include <vector>
+#include <numeric>
+#include <limits>
+#include <CGAL/spatial_sort.h>
+#include <CGAL/Spatial_sort_traits_adapter_2.h>
+#include <CGAL/property_map.h>
+
+void CGALMeshGenerator::mark_domains(CDT& cdt) {
+    for (auto f = cdt.all_faces_begin(); f != cdt.all_faces_end(); ++f) {
+        f->info().nesting_level = -1;
+    }
+
+    // 每一层用 BFS 填充，遇到约束边时把对面的面留到下一层
+    std::vector<CDT::Face_handle> queue;
+    std::vector<CDT::Face_handle> next_layer;
+    cdt.infinite_face()->info().nesting_level = 0;
+    queue.push_back(cdt.infinite_face());
+    for (int level = 0; !queue.empty(); ++level) {
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            CDT::Face_handle fh = queue[head];
+            for (int i = 0; i < 3; ++i) {
+                CDT::Face_handle n = fh->neighbor(i);
+                if (n->info().nesting_level != -1) continue;
+                if (cdt.is_constrained(CDT::Edge(fh, i))) {
+                    next_layer.push_back(n);
+                }
+                else {
+                    n->info().nesting_level = level;
+                    queue.push_back(n);
+                }
+            }
+        }
+        queue.clear();
+        for (CDT::Face_handle n : next_layer) {
+            if (n->info().nesting_level == -1) {
+                n->info().nesting_level = level + 1;
+                queue.push_back(n);
+            }
+        }
+        next_layer.clear();
+    }
+}
+
+namespace {
+constexpr unsigned int unassigned = std::numeric_limits<unsigned int>::max();
+}
+
+// 从持久的 CDT 中导出区域内的三角形：用稠密数组把点序号压缩为输出顶点序号，
+// 未被任何区域内三角形使用的点不会输出
+void CGALMeshGenerator::extract_mesh() {
+    vertices_.clear();
+    triangles_.clear();
+    slot_faces_.clear();
+    vertex_uses_.clear();
+    emptied_vertices_.clear();
+    remap_.assign(num_points_, unassigned);
+    vertices_.reserve(cdt_.number_of_vertices());
+    triangles_.reserve(cdt_.number_of_faces());
+    slot_faces_.reserve(cdt_.number_of_faces());
+
+    for (auto face_it = cdt_.finite_faces_begin(); face_it != cdt_.finite_faces_end(); ++face_it) {
+        CDT::Face_handle f = face_it;
+        f->info().slot = FaceInfo2::no_slot;
+        assign_face(f);
+    }
+}
+
+// 把一个区域内的面追加到导出数组的末尾 (调用前该面不占有位置)
+void CGALMeshGenerator::assign_face(CDT::Face_handle f) {
+    if (cdt_.is_infinite(f) || !f->info().in_domain()) return;
+
+    unsigned int v_indices[3];
+    for (int i = 0; i < 3; ++i) {
+        CDT::Vertex_handle vh = f->vertex(i);
+        unsigned int& out_index = remap_[vh->info()];
+
+        // 如果是新顶点，添加到我们的顶点列表，并记录其索引
+        if (out_index == unassigned) {
+            out_index = static_cast<unsigned int>(vertices_.size());
+            vertices_.emplace_back(vh->point().x(), vh->point().y());
+            vertex_uses_.push_back(0);
+        }
+        ++vertex_uses_[out_index];
+        v_indices[i] = out_index;
+    }
+    f->info().slot = static_cast<unsigned int>(triangles_.size());
+    triangles_.push_back({ v_indices[0], v_indices[1], v_indices[2] });
+    slot_faces_.push_back(f);
+}
+
+// 从导出数组中移除一个面：用最后一个三角形填补空位。必须在 CGAL 删除或改写该面之前调用
+void CGALMeshGenerator::release_face(CDT::Face_handle f) {
+    const unsigned int slot = f->info().slot;
+    if (slot == FaceInfo2::no_slot) return;
+    f->info().slot = FaceInfo2::no_slot;
+
+    const Triangle& t = triangles_[slot];
+    for (unsigned int v : { t.v0, t.v1, t.v2 }) {
+        if (--vertex_uses_[v] == 0) emptied_vertices_.push_back(v);
+    }
+    if (slot + 1 != triangles_.size()) {
+        triangles_[slot] = triangles_.back();
+        slot_faces_[slot] = slot_faces_.back();
+        slot_faces_[slot]->info().slot = slot;
+    }
+    triangles_.pop_back();
+    slot_faces_.pop_back();
+}
+
 
 void CGALMeshGenerator::generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary) {
+    SPHMESH_PROFILE_SCOPE("mesh.triangulate");
     vertices_.clear();
     triangles_.clear();
+    slot_faces_.clear();
+    cdt_.clear();
+    particle_handles_.clear();
+    particle_positions_.clear();
+    mesh_boundary_ = nullptr;
+    num_points_ = 0;
 
     const auto& boundary_vertices = boundary.get_vertices();
     if (particles.empty() || boundary_vertices.empty()) return;
 
-    CDT cdt;
-
-    // ---  1: ֻʹڲӽʷ ---
-    std::vector<Point> interior_points;
-    for (const auto& p : particles) {
-        // ֻЩƶӣΪǵλþŻ
-        if (!p.is_boundary) {
-            interior_points.emplace_back(p.position.x, p.position.y);
-        }
+    // --- 步骤 1: 收集内部粒子与所有边界环的顶点 ---
+    // points 的前 particles.size() 项与粒子一一对应 (边界粒子占位但不插入)，边界顶点在后；
+    // ring_starts 记录每个环在 points 中的起点
+    std::vector<Point> points;
+    points.reserve(particles.size() + boundary.get_edge_index().get_num_edges());
+    std::vector<std::size_t> order;
+    order.reserve(points.capacity());
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        const auto& p = particles[i];
+        points.emplace_back(p.position.x, p.position.y);
+        // 我们只关心那些可以移动的粒子，因为它们的位置经过了优化
+        if (!p.is_boundary) order.push_back(i);
     }
 
-    if (interior_points.empty()) {
+    if (order.empty()) {
         std::cerr << "Warning: No interior particles to generate mesh from." << std::endl;
         return;
     }
 
-    cdt.insert(interior_points.begin(), interior_points.end());
+    std::vector<std::size_t> ring_starts;
+    for (size_t r = 0; r < boundary.get_num_rings(); ++r) {
+        ring_starts.push_back(points.size());
+        for (const auto& v : boundary.get_ring(r)) {
+            order.push_back(points.size());
+            points.emplace_back(v.x, v.y);
+        }
+    }
+    ring_starts.push_back(points.size());
+    num_points_ = points.size();
 
+    // 按 Hilbert 曲线对点排序后逐点插入，并以上一个顶点所在的面作为定位提示，
+    // 使点定位的行走距离保持为常数；顶点的 info 记录它在 points 中的序号
+    using Search_traits = CGAL::Spatial_sort_traits_adapter_2<K, CGAL::Pointer_property_map<Point>::type>;
+    CGAL::spatial_sort(order.begin(), order.end(), Search_traits(CGAL::make_property_map(points)));
 
-    // ---  2 & 3: ɸѡȡڲ (жϷ) ---
-    // mapCGALڲӳ䵽Լ
-    std::map<CDT::Vertex_handle, unsigned int> vertex_map;
+    std::vector<CDT::Vertex_handle> handles(points.size());
+    CDT::Face_handle hint;
+    for (std::size_t idx : order) {
+        const std::size_t before = cdt_.number_of_vertices();
+        CDT::Vertex_handle vh = cdt_.insert(points[idx], hint);
+        if (cdt_.number_of_vertices() != before) {
+            vh->info() = static_cast<unsigned int>(idx); // 重复点保留第一次插入的序号
+        }
+        handles[idx] = vh;
+        hint = vh->face();
+    }
 
-    for (auto face_it = cdt.finite_faces_begin(); face_it != cdt.finite_faces_end(); ++face_it) {
-        // a) ε
-        Point p0 = face_it->vertex(0)->point();
-        Point p1 = face_it->vertex(1)->point();
-        Point p2 = face_it->vertex(2)->point();
-        glm::vec2 centroid((p0.x() + p1.x() + p2.x()) / 3.0f, (p0.y() + p1.y() + p2.y()) / 3.0f);
+    // --- 步骤 2: 插入边界约束边 (外环与孔洞) ---
+    for (size_t r = 0; r + 1 < ring_starts.size(); ++r) {
+        const std::size_t first = ring_starts[r], count = ring_starts[r + 1] - first;
+        for (std::size_t i = 0; i < count; ++i) {
+            CDT::Vertex_handle va = handles[first + i];
+            CDT::Vertex_handle vb = handles[first + (i + 1) % count];
+            if (va != vb) cdt_.insert_constraint(va, vb);
+        }
+    }
 
-        // b) ʹñ߽жǷ
-        if (boundary.is_inside(centroid)) {
-            unsigned int v_indices[3];
-            for (int i = 0; i < 3; ++i) {
-                CDT::Vertex_handle vh = face_it->vertex(i);
+    // --- 步骤 3: 洪泛标记区域，奇数层的面即为区域内的面，无需逐面做点在多边形内判断 ---
+    mark_domains(cdt_);
 
-                // c) ¶㣬ӵǵĶб¼
-                if (vertex_map.find(vh) == vertex_map.end()) {
-                    vertex_map[vh] = (unsigned int)vertices_.size();
-                    vertices_.emplace_back(vh->point().x(), vh->point().y());
-                }
-                v_indices[i] = vertex_map[vh];
+    // 记录每个粒子拥有的顶点，供 update_mesh 增量移动；
+    // 与其他点重合而被合并的粒子不拥有顶点，避免删除顶点时留下悬空的句柄
+    particle_handles_.assign(particles.size(), CDT::Vertex_handle());
+    particle_positions_.resize(particles.size());
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        particle_positions_[i] = particles[i].position;
+        if (!particles[i].is_boundary && handles[i]->info() == i) particle_handles_[i] = handles[i];
+    }
+    mesh_boundary_ = &boundary;
+
+    extract_mesh();
+
+    std::cout << "CGAL generated (Constrained): " << vertices_.size() << " vertices, " << triangles_.size() << " triangles." << std::endl;
+}
+
+// 顶点移到 p 后，它的星形中每个面是否仍保持逆时针方向 (即不会发生翻折)
+bool CGALMeshGenerator::is_star_valid(CDT::Vertex_handle vh, const Point& p) const {
+    CDT::Face_circulator fc = cdt_.incident_faces(vh), done(fc);
+    do {
+        CDT::Face_handle f = fc;
+        if (cdt_.is_infinite(f)) return false;
+        const int i = f->index(vh);
+        const Point& a = f->vertex(cdt_.ccw(i))->point();
+        const Point& b = f->vertex(cdt_.cw(i))->point();
+        if (CGAL::orientation(p, a, b) != CGAL::LEFT_TURN) return false;
+    } while (++fc != done);
+    return true;
+}
+
+// 顶点在星形内移动后，只有其星形中的辐边与对边可能不满足 Delaunay 条件；
+// 从这些边开始做 Lawson 翻转，翻转后把新四边形的边继续入栈，约束边不会被翻转；
+// 翻转不跨越约束边，两个面的区域标记不变，只需重写它们导出的三角形
+void CGALMeshGenerator::restore_delaunay(CDT::Vertex_handle vh) {
+    std::vector<CDT::Edge> stack;
+    CDT::Face_circulator fc = cdt_.incident_faces(vh), done(fc);
+    do {
+        CDT::Face_handle f = fc;
+        const int i = f->index(vh);
+        stack.emplace_back(f, i);
+        stack.emplace_back(f, cdt_.cw(i));
+    } while (++fc != done);
+
+    while (!stack.empty()) {
+        CDT::Face_handle f = stack.back().first;
+        const int i = stack.back().second;
+        stack.pop_back();
+        if (!cdt_.is_flipable(f, i)) continue;
+        CDT::Face_handle n = f->neighbor(i);
+        release_face(f);
+        release_face(n);
+        cdt_.flip(f, i);
+        assign_face(f);
+        assign_face(n);
+        for (int k = 0; k < 3; ++k) {
+            stack.emplace_back(f, k);
+            stack.emplace_back(n, k);
+        }
+    }
+}
+
+void CGALMeshGenerator::update_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary) {
+    SPHMESH_PROFILE_SCOPE("mesh.update");
+    // 边界或粒子集合变化时无法增量更新，退回完整重建
+    if (mesh_boundary_ != &boundary || particles.size() != particle_handles_.size() || cdt_.number_of_vertices() == 0) {
+        generate_mesh(particles, boundary);
+        return;
+    }
+
+    std::size_t moved = 0, reinserted = 0;
+    bool remark = false; // 新顶点落在约束边上时两侧的层数不同，最后整体重新标记
+    emptied_vertices_.clear();
+    std::vector<CDT::Vertex_handle> link;
+    CDT::Face_handle hint;
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        const auto& particle = particles[i];
+        if (particle.is_boundary) continue;
+
+        // 位移小于局部尺寸的 move_tolerance_ 倍时不动网格；这里逐粒子比较位移是线性的轻量扫描，
+        // 对 CDT 和导出数组的修改只涉及真正移动的粒子周围的面
+        const glm::vec2 delta = particle.position - particle_positions_[i];
+        const float tolerance = move_tolerance_ * particle.smoothing_h;
+        if (glm::dot(delta, delta) <= tolerance * tolerance) continue;
+        particle_positions_[i] = particle.position;
+        ++moved;
+
+        const Point p(particle.position.x, particle.position.y);
+        CDT::Vertex_handle vh = particle_handles_[i];
+        if (vh != CDT::Vertex_handle()) {
+            // 落在约束边上的顶点既不能移动也不能删除，只能整体重建
+            if (cdt_.are_there_incident_constraints(vh)) {
+                generate_mesh(particles, boundary);
+                return;
+            }
+            // 小位移：原地移动顶点，再用局部翻转恢复 Delaunay 性质，面的区域标记保持不变
+            if (is_star_valid(vh, p)) {
+                vh->set_point(p);
+                if (remap_[i] != unassigned) vertices_[remap_[i]] = particle.position;
+                restore_delaunay(vh);
+                hint = vh->face();
+                continue;
             }
-            // d) ϸ
-            triangles_.push_back({ v_indices[0], v_indices[1], v_indices[2] });
+            // 大位移 (越过了相邻顶点或约束边)：删除后重新插入。星形中没有约束边，
+            // 删除后填补空洞的新面都与原星形同层，它们的角点都是原星形的相邻顶点
+            const int level = vh->face()->info().nesting_level;
+            link.clear();
+            CDT::Vertex_circulator vc = cdt_.incident_vertices(vh), vdone(vc);
+            do {
+                CDT::Vertex_handle u = vc;
+                if (!cdt_.is_infinite(u)) link.push_back(u);
+            } while (++vc != vdone);
+            CDT::Face_circulator fc = cdt_.incident_faces(vh), fdone(fc);
+            do {
+                CDT::Face_handle f = fc;
+                release_face(f);
+            } while (++fc != fdone);
+
+            cdt_.remove(vh);
+            particle_handles_[i] = CDT::Vertex_handle();
+            for (CDT::Vertex_handle u : link) {
+                CDT::Face_circulator gc = cdt_.incident_faces(u), gdone(gc);
+                do {
+                    CDT::Face_handle g = gc;
+                    if (g->info().nesting_level != -1) continue;
+                    g->info().nesting_level = level;
+                    assign_face(g);
+                } while (++gc != gdone);
+            }
+            // 以一个相邻顶点所在的面作为定位提示
+            hint = link.empty() ? CDT::Face_handle() : link.front()->face();
         }
+
+        CDT::Locate_type lt;
+        int li;
+        CDT::Face_handle loc = cdt_.locate(p, lt, li, hint);
+        // 与已有顶点重合时不拥有顶点，下次移动时再尝试插入
+        if (lt != CDT::VERTEX) {
+            const bool on_constraint = lt == CDT::EDGE && cdt_.is_constrained(CDT::Edge(loc, li));
+            const int level = loc->info().nesting_level;
+            vh = cdt_.insert(p, lt, loc, li);
+            vh->info() = static_cast<unsigned int>(i);
+            particle_handles_[i] = vh;
+
+            // 插入及随后的翻转所改动的面都以新顶点为角点，且不跨越约束边，都与定位到的面同层
+            CDT::Face_circulator fc = cdt_.incident_faces(vh), done(fc);
+            do {
+                CDT::Face_handle f = fc;
+                release_face(f);
+                if (on_constraint) continue;
+                f->info().nesting_level = level;
+                assign_face(f);
+            } while (++fc != done);
+            remark = remark || on_constraint;
+            if (remap_[i] != unassigned) vertices_[remap_[i]] = particle.position;
+            hint = vh->face();
+        }
+        else {
+            hint = loc;
+        }
+        ++reinserted;
     }
 
-    std::cout << "CGAL generated (Clip Method): " << vertices_.size() << " vertices, " << triangles_.size() << " triangles." << std::endl;
-}
\ No newline at end of file
+    // 有输出顶点不再被任何三角形引用时 (粒子移出区域或与其他点重合) 需要压缩顶点数组，
+    // 这种少见的情况退回完整导出
+    bool compact = remark;
+    for (unsigned int v : emptied_vertices_) {
+        if (vertex_uses_[v] == 0) compact = true;
+    }
+    if (remark) mark_domains(cdt_);
+    if (compact) extract_mesh();
+    last_moved_ = moved;
+    last_reinserted_ = reinserted;
+}
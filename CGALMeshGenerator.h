@@ -1,61 +1,103 @@
 #pragma once
 #include <vector>
+#include <limits>
 #include <glm/glm.hpp>
 #include "Simulation2D.h"
 #include "Boundary.h"
+#include "Mesh2D.h"
 
-// --- ؼ޸ȷCGAL ---
+// --- 关键修复：定义正确的CGAL类型 ---
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Triangulation_face_base_with_info_2.h>
-#include <CGAL/Constrained_triangulation_face_base_2.h> // <-- ͷļ
+#include <CGAL/Constrained_triangulation_face_base_2.h> // <-- 必须包含这个头文件
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
 
-// /
+// 区域内/外标记：nesting_level 为从无穷远面出发穿过的约束边数，奇数层在区域内；
+// CGAL 新建的面为 -1 (尚未标记)。slot 为该面在导出的三角形数组中的位置
 struct FaceInfo2 {
+    static constexpr unsigned int no_slot = std::numeric_limits<unsigned int>::max();
     bool in_domain() const { return nesting_level % 2 == 1; }
-    int nesting_level = 0;
+    int nesting_level = -1;
+    unsigned int slot = no_slot;
 };
 
-// CGAL ں
+// CGAL 内核
 using K = CGAL::Exact_predicates_inexact_constructions_kernel;
 
-// һϵࣺԼߵϢҲԶϢ
+// 创建一个复合的面基类：它既有约束边的信息，也有我们自定义的信息
 using Cfb = CGAL::Constrained_triangulation_face_base_2<K>;
 using Fbb = CGAL::Triangulation_face_base_with_info_2<FaceInfo2, K, Cfb>;
 
-// ݽṹ
-using Vb = CGAL::Triangulation_vertex_base_2<K>;
+// 顶点和数据结构：顶点直接携带其在输入点数组中的序号，不再需要 handle -> 序号 的 map
+using Vb = CGAL::Triangulation_vertex_base_with_info_2<unsigned int, K>;
 using Tds = CGAL::Triangulation_data_structure_2<Vb, Fbb>;
 
-// յԼʷ
+// 最终的约束德劳内三角剖分类型
 using CDT = CGAL::Constrained_Delaunay_triangulation_2<K, Tds>;
 using Point = CDT::Point;
-// ---  ---
+// --- 结束 ---
 
 
 class CGALMeshGenerator {
 public:
-    struct Triangle {
-        unsigned int v0, v1, v2;
-    };
-    // Quad ṹ嶨Ƶ Qmorph.h иʣΪ Viewer ܷʣʱ
-    struct Quad {
-        unsigned int v0, v1, v2, v3;
-    };
+    // 新增：单元类型统一定义在 Mesh2D.h 中，各生成器共用
+    using Triangle = MeshTriangle;
+    using Quad = MeshQuad;
 
     CGALMeshGenerator() = default;
     ~CGALMeshGenerator() = default;
 
-    // ǩȷ
+    // 函数签名现在是正确的
+    // 注意：CGAL 的 Constrained_Delaunay_triangulation_2 不支持并发插入，这里始终串行建网；
+    // 需要多线程三角化时使用 DelaunayMeshGenerator (cdd 条带并行)
     void generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary);
 
+    // 新增：增量重剖分。保留上一次的 CDT，只移动位置发生变化的粒子对应的顶点：
+    // 星形内的小位移原地移动后局部翻转，大位移删除后重新插入；
+    // 新面的区域标记取自所在区域，导出数组只改动变化的面；
+    // 边界或粒子数量变化时退回 generate_mesh
+    void update_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary);
+
+    // 位移小于 tolerance * smoothing_h 的粒子在 update_mesh 中不移动
+    void set_move_tolerance(float tolerance) { move_tolerance_ = tolerance; }
+    size_t get_last_moved() const { return last_moved_; }
+    size_t get_last_reinserted() const { return last_reinserted_; }
+
     const std::vector<glm::vec2>& get_vertices() const { return vertices_; }
     const std::vector<Triangle>& get_triangles() const { return triangles_; }
     const std::vector<Quad>& get_quads() const { return quads_; }
 
 private:
+    // 从无穷远面开始洪泛，穿过约束边时层数加一，线性时间标记所有面的 nesting_level
+    static void mark_domains(CDT& cdt);
+
+    // 完整导出所有区域内的面；update_mesh 中用 assign_face / release_face 只修补变化的面
+    void extract_mesh();
+    void assign_face(CDT::Face_handle f);
+    void release_face(CDT::Face_handle f);
+    bool is_star_valid(CDT::Vertex_handle vh, const Point& p) const;
+    void restore_delaunay(CDT::Vertex_handle vh);
+
+    // 持久的三角剖分，以及每个粒子拥有的顶点 (与其他点重合的粒子为空句柄)
+    CDT cdt_;
+    std::vector<CDT::Vertex_handle> particle_handles_;
+    std::vector<glm::vec2> particle_positions_; // 顶点当前所在的位置
+    const Boundary* mesh_boundary_ = nullptr;
+    size_t num_points_ = 0;
+    float move_tolerance_ = 0.01f;
+    size_t last_moved_ = 0;
+    size_t last_reinserted_ = 0;
+
     std::vector<glm::vec2> vertices_;
     std::vector<Triangle> triangles_;
-    std::vector<Quad> quads_; // 
+    std::vector<Quad> quads_; // 新增
+
+    // triangles_[k] 由面 slot_faces_[k] 导出，该面的 info().slot == k；
+    // remap_ 把点序号映射为输出顶点序号，vertex_uses_ 为每个输出顶点被引用的三角形数
+    std::vector<CDT::Face_handle> slot_faces_;
+    std::vector<unsigned int> remap_;
+    std::vector<unsigned int> vertex_uses_;
+    std::vector<unsigned int> emptied_vertices_; // 本次更新中引用数降为 0 的输出顶点
 
 };
\ No newline at end of file
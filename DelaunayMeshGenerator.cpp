@@ -1,15 +1,63 @@
 #include "DelaunayMeshGenerator.h"
-#include "Cdd.h"
+#include "cdd.h"
+#include "TaskScheduler.h"
 #include <iostream>
-#include <map>
+#include <unordered_map>
+#include <cmath>
+#include <cstdint>
 
-// ڼƽȼ뱾
+// 辅助函数，用于计算两点距离的平方，比计算距离本身更快
 static float distance_sq(const CDT::V2d<float>& p1, const CDT::V2d<float>& p2) {
     float dx = p1.x - p2.x;
     float dy = p1.y - p2.y;
     return dx * dx + dy * dy;
 }
 
+namespace {
+// 去重用的空间哈希：格子边长等于去重阈值，近邻只可能落在 3x3 的格子里；
+// 每个格子保存链表头，next_ 串起同一格子中的顶点
+class DedupHash {
+public:
+    DedupHash(float cell_size, size_t expected) : inv_cell_(1.0f / cell_size) {
+        heads_.reserve(expected);
+        next_.reserve(expected);
+    }
+
+    // 若 v 与已接受的某个顶点距离平方小于 min_dist_sq 返回 true
+    bool has_near(const CDT::V2d<float>& v, const std::vector<CDT::V2d<float>>& verts, float min_dist_sq) const {
+        const int64_t cx = cell(v.x), cy = cell(v.y);
+        for (int64_t y = cy - 1; y <= cy + 1; ++y) {
+            for (int64_t x = cx - 1; x <= cx + 1; ++x) {
+                auto it = heads_.find(key(x, y));
+                if (it == heads_.end()) continue;
+                for (CDT::VertInd i = it->second; i != CDT::noNeighbor; i = next_[i]) {
+                    if (distance_sq(v, verts[i]) < min_dist_sq) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // 记录已接受的第 index 个顶点，index 必须按顺序递增
+    void add(const CDT::V2d<float>& v, CDT::VertInd index) {
+        if (next_.size() <= index) next_.resize(index + 1, CDT::noNeighbor);
+        auto result = heads_.emplace(key(cell(v.x), cell(v.y)), index);
+        if (!result.second) {
+            next_[index] = result.first->second;
+            result.first->second = index;
+        }
+    }
+
+private:
+    int64_t cell(float c) const { return static_cast<int64_t>(std::floor(c * inv_cell_)); }
+    static uint64_t key(int64_t x, int64_t y) { return (static_cast<uint64_t>(x) << 32) ^ (static_cast<uint64_t>(y) & 0xffffffffu); }
+
+    float inv_cell_;
+    std::unordered_map<uint64_t, CDT::VertInd> heads_;
+    std::vector<CDT::VertInd> next_;
+};
+}
+
 void DelaunayMeshGenerator::generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary, float min_particle_spacing) {
     vertices_.clear();
     triangles_.clear();
@@ -17,64 +65,82 @@ void DelaunayMeshGenerator::generate_mesh(const std::vector<Simulation2D::Partic
     const auto& boundary_vertices_in = boundary.get_vertices();
     if (particles.empty() || boundary_vertices_in.empty()) return;
 
-    // --- 1. ϴ׼ ---
+    // --- 1. 数据清洗与准备 ---
+    size_t total_ring_vertices = 0;
+    for (size_t r = 0; r < boundary.get_num_rings(); ++r) total_ring_vertices += boundary.get_ring(r).size();
+
     std::vector<CDT::V2d<float>> final_vertices;
-    // ʹ map ұ߽綥¶бе
-    std::map<int, CDT::VertInd> boundary_idx_map;
-    // ȥֵΪСӼһСı
-    float min_dist_sq = (min_particle_spacing * 0.1f) * (min_particle_spacing * 0.1f);
-
-    // a) ӱ߽綥㣬֤ظ
-    for (int i = 0; i < boundary_vertices_in.size(); ++i) {
-        CDT::V2d<float> current_v = { boundary_vertices_in[i].x, boundary_vertices_in[i].y };
-        // ӵһǷ̫
-        if (final_vertices.empty() || distance_sq(current_v, final_vertices.back()) > min_dist_sq) {
-            boundary_idx_map[i] = static_cast<CDT::VertInd>(final_vertices.size());
-            final_vertices.push_back(current_v);
-        }
-        else {
-            boundary_idx_map[i] = static_cast<CDT::VertInd>(final_vertices.size() - 1);
+    final_vertices.reserve(total_ring_vertices + particles.size());
+    // 稠密数组：所有环顺序拼接后的全局序号 -> 边界顶点在新顶点列表中的索引
+    std::vector<CDT::VertInd> boundary_idx_map(total_ring_vertices);
+    // 去重阈值：设置为最小粒子间距的一个很小的比例
+    const float dedup_dist = min_particle_spacing * 0.1f;
+    float min_dist_sq = dedup_dist * dedup_dist;
+    DedupHash dedup(dedup_dist > 0.0f ? dedup_dist : 1e-6f, total_ring_vertices + particles.size());
+
+    // a) 首先添加边界顶点 (外环与所有孔洞环)，并保证它们自身不重复
+    std::vector<int> ring_offsets;
+    int ring_offset = 0;
+    for (size_t r = 0; r < boundary.get_num_rings(); ++r) {
+        const auto& ring = boundary.get_ring(r);
+        ring_offsets.push_back(ring_offset);
+        const size_t ring_first = final_vertices.size();
+        for (size_t i = 0; i < ring.size(); ++i) {
+            CDT::V2d<float> current_v = { ring[i].x, ring[i].y };
+            // 检查与本环已添加的最后一个顶点是否太近
+            if (final_vertices.size() == ring_first || distance_sq(current_v, final_vertices.back()) > min_dist_sq) {
+                boundary_idx_map[ring_offset + i] = static_cast<CDT::VertInd>(final_vertices.size());
+                dedup.add(current_v, static_cast<CDT::VertInd>(final_vertices.size()));
+                final_vertices.push_back(current_v);
+            }
+            else {
+                boundary_idx_map[ring_offset + i] = static_cast<CDT::VertInd>(final_vertices.size() - 1);
+            }
         }
+        ring_offset += static_cast<int>(ring.size());
     }
 
-    // b) ڲӣͬʱӶľ룬ʵȥ
+    // b) 添加内部粒子，只与空间哈希中相邻格子里的已添加顶点比较距离，实现线性时间去重
     for (const auto& p : particles) {
-        if (p.is_boundary) continue; // ߽Ѿͨ boundary_vertices 
+        if (p.is_boundary) continue; // 边界粒子已经通过 boundary_vertices 添加
 
         CDT::V2d<float> particle_v = { p.position.x, p.position.y };
-        bool is_duplicate = false;
-        for (const auto& v_final : final_vertices) {
-            if (distance_sq(particle_v, v_final) < min_dist_sq) {
-                is_duplicate = true;
-                break;
-            }
-        }
-        if (!is_duplicate) {
+        if (!dedup.has_near(particle_v, final_vertices, min_dist_sq)) {
+            dedup.add(particle_v, static_cast<CDT::VertInd>(final_vertices.size()));
             final_vertices.push_back(particle_v);
         }
     }
 
-    // --- 2.  CDT 󲢲ϴĶ ---
+    // --- 2. 创建 CDT 对象并插入清洗后的顶点 ---
     CDT::Triangulation<float> cdt;
-    cdt.insertVertices(final_vertices);
+    const unsigned num_strips = num_threads_ ? num_threads_ : TaskScheduler::instance().get_num_threads();
+    if (num_strips > 1) {
+        cdt.insertVerticesParallel(final_vertices, num_strips);
+    }
+    else {
+        cdt.insertVertices(final_vertices);
+    }
 
-    // --- 3. ׼뾫ȷı߽Լ ---
+    // --- 3. 准备并插入精确的边界约束边 ---
     std::vector<CDT::Edge<float>> cdt_edges;
-    cdt_edges.reserve(boundary_vertices_in.size());
-    for (size_t i = 0; i < boundary_vertices_in.size(); ++i) {
-        CDT::VertInd idx1 = boundary_idx_map[i];
-        CDT::VertInd idx2 = boundary_idx_map[(i + 1) % boundary_vertices_in.size()];
-        // ȥصµӱ
-        if (idx1 != idx2) {
-            cdt_edges.emplace_back(CDT::Edge<float>{idx1, idx2});
+    cdt_edges.reserve(ring_offset);
+    for (size_t r = 0; r < boundary.get_num_rings(); ++r) {
+        const int n = static_cast<int>(boundary.get_ring(r).size());
+        for (int i = 0; i < n; ++i) {
+            CDT::VertInd idx1 = boundary_idx_map[ring_offsets[r] + i];
+            CDT::VertInd idx2 = boundary_idx_map[ring_offsets[r] + (i + 1) % n];
+            // 避免因去重导致的自连接边
+            if (idx1 != idx2) {
+                cdt_edges.emplace_back(CDT::Edge<float>{idx1, idx2});
+            }
         }
     }
     cdt.insertEdges(cdt_edges);
 
-    // --- 4. Ƴ ---
+    // --- 4. 移除区域外的三角形与孔洞内的三角形 (按约束边嵌套深度洪泛) ---
     cdt.eraseOuterTrianglesAndHoles();
 
-    // --- 5. ȡ ---
+    // --- 5. 提取结果 ---
     vertices_.clear();
     const auto& result_vertices = cdt.vertices;
     vertices_.reserve(result_vertices.size());
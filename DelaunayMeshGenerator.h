@@ -3,23 +3,27 @@
 #include <glm/glm.hpp>
 #include "Simulation2D.h"
 #include "Boundary.h"
+#include "Mesh2D.h"
 class Simulation2D;
 
 class DelaunayMeshGenerator {
 public:
-    struct Triangle {
-        unsigned int v0, v1, v2;
-    };
+    using Triangle = MeshTriangle; // 新增：与其他生成器共用的三角形类型
 
     DelaunayMeshGenerator() = default;
 
-    // ĺӺͱ߽磬CDT
+    // 核心函数：接收粒子和边界，生成CDT网格
     void generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary, float min_particle_spacing);
 
+    // 新增：并行模式，按 x 方向分条带在共享任务池上并发三角化后拼接；
+    // 参数为条带数，1 为串行，0 (默认) 表示取任务池的线程数；点数过少时自动退回串行
+    void set_num_threads(unsigned num_threads) { num_threads_ = num_threads; }
+
     const std::vector<glm::vec2>& get_vertices() const { return vertices_; }
     const std::vector<Triangle>& get_triangles() const { return triangles_; }
 
 private:
     std::vector<glm::vec2> vertices_;
     std::vector<Triangle> triangles_;
+    unsigned num_threads_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "EdgeAdjacency.h"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+constexpr int kRadixBits = 11;                 // 2048 个桶，直方图可以放进 L1
+constexpr std::uint32_t kRadixSize = 1u << kRadixBits;
+constexpr size_t kSmallSortSize = 2048;        // 小规模时 std::sort 更快
+
+int bit_width(std::uint32_t v) {
+    int bits = 0;
+    while (v) {
+        ++bits;
+        v >>= 1;
+    }
+    return bits;
+}
+
+// 由每条半边的两个端点生成键并配对；get_ends(h, a, b) 给出半边 h 的起点与终点
+template <typename GetEnds>
+size_t pair_half_edges(size_t num_half, std::uint32_t max_vertex, GetEnds get_ends, std::vector<std::uint32_t>& twin) {
+    const std::uint32_t invalid = Mesh2D::invalid_index;
+    twin.assign(num_half, invalid);
+    if (num_half == 0) return 0;
+
+    // --- 1. 打包：较小的端点放在高位，只占用顶点编号实际需要的位数 ---
+    const int vbits = std::max(1, bit_width(max_vertex));
+    std::vector<std::uint64_t> keys(num_half);
+    std::vector<std::uint32_t> ids(num_half);
+    for (size_t h = 0; h < num_half; ++h) {
+        std::uint32_t a, b;
+        get_ends(h, a, b);
+        if (a > b) std::swap(a, b);
+        keys[h] = (static_cast<std::uint64_t>(a) << vbits) | b;
+        ids[h] = static_cast<std::uint32_t>(h);
+    }
+
+    // --- 2. 排序后相同的边相邻 ---
+    radix_sort_pairs(keys, ids, 2 * vbits);
+
+    // --- 3. 线性扫描：只配对恰好两条、且方向相反的半边 ---
+    size_t paired = 0;
+    for (size_t i = 0; i < num_half;) {
+        size_t j = i + 1;
+        while (j < num_half && keys[j] == keys[i]) ++j;
+        if (j - i == 2) {
+            const std::uint32_t h0 = ids[i], h1 = ids[i + 1];
+            std::uint32_t a0, b0, a1, b1;
+            get_ends(h0, a0, b0);
+            get_ends(h1, a1, b1);
+            if (a0 == b1 && b0 == a1) {
+                twin[h0] = h1;
+                twin[h1] = h0;
+                ++paired;
+            }
+        }
+        i = j;
+    }
+    return paired;
+}
+
+} // namespace
+
+void radix_sort_pairs(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, int key_bits) {
+    const size_t n = keys.size();
+    if (n < kSmallSortSize) {
+        std::vector<std::uint32_t> order(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+        std::vector<std::uint64_t> sorted_keys(n);
+        std::vector<std::uint32_t> sorted_values(n);
+        for (size_t i = 0; i < n; ++i) {
+            sorted_keys[i] = keys[order[i]];
+            sorted_values[i] = values[order[i]];
+        }
+        keys.swap(sorted_keys);
+        values.swap(sorted_values);
+        return;
+    }
+
+    std::vector<std::uint64_t> key_buf(n);
+    std::vector<std::uint32_t> value_buf(n);
+    std::vector<size_t> count(kRadixSize);
+    key_bits = std::max(1, std::min(key_bits, 64));
+    for (int shift = 0; shift < key_bits; shift += kRadixBits) {
+        std::fill(count.begin(), count.end(), 0);
+        for (size_t i = 0; i < n; ++i) count[(keys[i] >> shift) & (kRadixSize - 1)]++;
+        // 所有键在这一位段上相同时跳过这一趟
+        if (count[(keys[0] >> shift) & (kRadixSize - 1)] == n) continue;
+
+        size_t sum = 0;
+        for (auto& c : count) {
+            size_t tmp = c;
+            c = sum;
+            sum += tmp;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t dst = count[(keys[i] >> shift) & (kRadixSize - 1)]++;
+            key_buf[dst] = keys[i];
+            value_buf[dst] = values[i];
+        }
+        keys.swap(key_buf);
+        values.swap(value_buf);
+    }
+}
+
+size_t build_edge_adjacency(const std::vector<std::uint32_t>& origins, const std::vector<std::uint32_t>& next,
+                            std::vector<std::uint32_t>& twin) {
+    std::uint32_t max_vertex = 0;
+    for (auto v : origins) max_vertex = std::max(max_vertex, v);
+    return pair_half_edges(origins.size(), max_vertex,
+        [&](size_t h, std::uint32_t& a, std::uint32_t& b) {
+            a = origins[h];
+            b = origins[next[h]];
+        }, twin);
+}
+
+size_t build_edge_adjacency(const std::vector<MeshTriangle>& triangles, std::vector<std::uint32_t>& twin) {
+    std::uint32_t max_vertex = 0;
+    for (const auto& t : triangles) max_vertex = std::max({ max_vertex, t.v0, t.v1, t.v2 });
+    return pair_half_edges(triangles.size() * 3, max_vertex,
+        [&](size_t h, std::uint32_t& a, std::uint32_t& b) {
+            const auto& t = triangles[h / 3];
+            const unsigned int v[3] = { t.v0, t.v1, t.v2 };
+            const size_t j = h % 3;
+            a = v[j];
+            b = v[j == 2 ? 0 : j + 1];
+        }, twin);
+}
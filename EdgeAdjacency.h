@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Mesh2D.h"
+
+// 边邻接构建：把每条半边的无向边打包成 64 位键，基数排序后线性扫描配对，
+// 代价 O(n)，不需要 std::map 的红黑树节点和每条边一次的堆分配。
+// 输出 twin[h] 为与半边 h 共享同一条边的反向半边，边界边与非流形边为 Mesh2D::invalid_index
+
+// 通用的半边布局：半边 h 从 origins[h] 指向 origins[next[h]] (与 Mesh2D 的 face_verts_/next_ 一致)
+// 返回配对成功的内部边数
+size_t build_edge_adjacency(const std::vector<std::uint32_t>& origins, const std::vector<std::uint32_t>& next,
+                            std::vector<std::uint32_t>& twin);
+
+// 纯三角形列表：半边 3 * t + j 从第 t 个三角形的第 j 个顶点指向第 j + 1 个顶点
+size_t build_edge_adjacency(const std::vector<MeshTriangle>& triangles, std::vector<std::uint32_t>& twin);
+
+// 对 (键, 值) 按键做稳定的 LSD 基数排序，只处理键中实际用到的位 (key_bits)；
+// 规模较小时退化为 std::sort
+void radix_sort_pairs(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, int key_bits = 64);
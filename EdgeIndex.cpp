@@ -0,0 +1,148 @@
+#include "EdgeIndex.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+int EdgeIndex::cell_x(float x) const {
+    int c = static_cast<int>(std::floor((x - min_coords_.x) / cell_size_));
+    return std::max(0, std::min(c, width_ - 1));
+}
+
+int EdgeIndex::cell_y(float y) const {
+    int c = static_cast<int>(std::floor((y - min_coords_.y) / cell_size_));
+    return std::max(0, std::min(c, height_ - 1));
+}
+
+void EdgeIndex::build(const std::vector<const std::vector<glm::vec2>*>& rings) {
+    seg_a_.clear();
+    seg_b_.clear();
+    cell_start_.clear();
+    cell_edges_.clear();
+    row_start_.clear();
+    row_edges_.clear();
+    width_ = height_ = 0;
+
+    // --- 1. 展开为扁平的边数组 ---
+    size_t total = 0;
+    for (const auto* ring : rings) total += ring->size();
+    seg_a_.reserve(total);
+    seg_b_.reserve(total);
+    float total_length = 0.0f;
+    for (const auto* ring : rings) {
+        const auto& r = *ring;
+        if (r.size() < 2) continue;
+        for (size_t i = 0, j = r.size() - 1; i < r.size(); j = i++) {
+            seg_a_.push_back(r[j]);
+            seg_b_.push_back(r[i]);
+            total_length += glm::distance(r[j], r[i]);
+        }
+    }
+    if (seg_a_.empty()) return;
+
+    // --- 2. 确定网格：格子数与边数同阶，且格子不小于平均边长，避免一条边覆盖太多格子 ---
+    min_coords_ = max_coords_ = seg_a_[0];
+    for (const auto& p : seg_a_) {
+        min_coords_.x = std::min(min_coords_.x, p.x);
+        min_coords_.y = std::min(min_coords_.y, p.y);
+        max_coords_.x = std::max(max_coords_.x, p.x);
+        max_coords_.y = std::max(max_coords_.y, p.y);
+    }
+    glm::vec2 size = max_coords_ - min_coords_;
+    float area = std::max(size.x, 1e-6f) * std::max(size.y, 1e-6f);
+    float mean_length = total_length / seg_a_.size();
+    cell_size_ = std::max(std::sqrt(area / seg_a_.size()), mean_length);
+    cell_size_ = std::max(cell_size_, std::max(size.x, size.y) / 4096.0f);
+    if (cell_size_ <= 0.0f) cell_size_ = 1.0f;
+    width_ = static_cast<int>(size.x / cell_size_) + 1;
+    height_ = static_cast<int>(size.y / cell_size_) + 1;
+
+    // --- 3. 两遍计数构建 CSR：格子 -> 边，行 -> 边 ---
+    const unsigned int num_edges = static_cast<unsigned int>(seg_a_.size());
+    cell_start_.assign(static_cast<size_t>(width_) * height_ + 1, 0);
+    row_start_.assign(height_ + 1, 0);
+    for (unsigned int e = 0; e < num_edges; ++e) {
+        int x0 = cell_x(std::min(seg_a_[e].x, seg_b_[e].x)), x1 = cell_x(std::max(seg_a_[e].x, seg_b_[e].x));
+        int y0 = cell_y(std::min(seg_a_[e].y, seg_b_[e].y)), y1 = cell_y(std::max(seg_a_[e].y, seg_b_[e].y));
+        for (int y = y0; y <= y1; ++y) {
+            row_start_[y + 1]++;
+            for (int x = x0; x <= x1; ++x) cell_start_[static_cast<size_t>(y) * width_ + x + 1]++;
+        }
+    }
+    for (size_t c = 1; c < cell_start_.size(); ++c) cell_start_[c] += cell_start_[c - 1];
+    for (size_t r = 1; r < row_start_.size(); ++r) row_start_[r] += row_start_[r - 1];
+    cell_edges_.resize(cell_start_.back());
+    row_edges_.resize(row_start_.back());
+
+    std::vector<unsigned int> cell_fill(cell_start_.begin(), cell_start_.end() - 1);
+    std::vector<unsigned int> row_fill(row_start_.begin(), row_start_.end() - 1);
+    for (unsigned int e = 0; e < num_edges; ++e) {
+        int x0 = cell_x(std::min(seg_a_[e].x, seg_b_[e].x)), x1 = cell_x(std::max(seg_a_[e].x, seg_b_[e].x));
+        int y0 = cell_y(std::min(seg_a_[e].y, seg_b_[e].y)), y1 = cell_y(std::max(seg_a_[e].y, seg_b_[e].y));
+        for (int y = y0; y <= y1; ++y) {
+            row_edges_[row_fill[y]++] = e;
+            for (int x = x0; x <= x1; ++x) cell_edges_[cell_fill[static_cast<size_t>(y) * width_ + x]++] = e;
+        }
+    }
+}
+
+// 与原来的 Ray-Casting 相同，但只遍历点所在行中的边；
+// 孔洞的边同样参与计数，因此孔洞内部的点自然被判为外部
+bool EdgeIndex::is_inside(const glm::vec2& point) const {
+    if (seg_a_.empty()) return false;
+    if (point.x < min_coords_.x || point.x > max_coords_.x || point.y < min_coords_.y || point.y > max_coords_.y) {
+        return false;
+    }
+    const int row = cell_y(point.y);
+    bool inside = false;
+    for (unsigned int k = row_start_[row]; k < row_start_[row + 1]; ++k) {
+        const auto& p1 = seg_b_[row_edges_[k]];
+        const auto& p2 = seg_a_[row_edges_[k]];
+        if (((p1.y > point.y) != (p2.y > point.y)) &&
+            (point.x < (p2.x - p1.x) * (point.y - p1.y) / (p2.y - p1.y) + p1.x)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// 以点所在格子为中心逐圈向外搜索；
+// 第 r 圈之外的格子到点的距离至少为 r * cell_size，据此提前终止
+glm::vec2 EdgeIndex::closest_point(const glm::vec2& point, float* dist_sq) const {
+    if (seg_a_.empty()) {
+        if (dist_sq) *dist_sq = FLT_MAX;
+        return point;
+    }
+    const int cx = cell_x(point.x);
+    const int cy = cell_y(point.y);
+    const int max_ring = std::max(width_, height_);
+
+    glm::vec2 best = seg_a_[0];
+    float best_dist_sq = FLT_MAX;
+    for (int r = 0; r <= max_ring; ++r) {
+        int y_lo = std::max(cy - r, 0), y_hi = std::min(cy + r, height_ - 1);
+        int x_lo = std::max(cx - r, 0), x_hi = std::min(cx + r, width_ - 1);
+        for (int y = y_lo; y <= y_hi; ++y) {
+            // 只访问第 r 圈上的格子
+            bool full_row = (y == cy - r || y == cy + r);
+            int step = full_row ? 1 : std::max(1, 2 * r);
+            for (int x = full_row ? x_lo : cx - r; x <= x_hi; x += step) {
+                if (x < x_lo) continue;
+                size_t c = static_cast<size_t>(y) * width_ + x;
+                for (unsigned int k = cell_start_[c]; k < cell_start_[c + 1]; ++k) {
+                    unsigned int e = cell_edges_[k];
+                    glm::vec2 q = closest_point_on_segment(point, seg_a_[e], seg_b_[e]);
+                    float d = glm::dot(point - q, point - q);
+                    if (d < best_dist_sq) {
+                        best_dist_sq = d;
+                        best = q;
+                    }
+                }
+            }
+        }
+        float reach = r * cell_size_;
+        if (best_dist_sq <= reach * reach) break;
+    }
+    if (dist_sq) *dist_sq = best_dist_sq;
+    return best;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+// 边界边的空间索引：把所有环 (外环 + 孔洞) 的边放进均匀网格，
+// 用于快速的点在多边形内判断 (奇偶规则) 和最近点查询，
+// 使 10 万条以上边的多环边界也能保持亚线性的查询代价
+class EdgeIndex {
+public:
+    EdgeIndex() = default;
+
+    // 由若干闭合环构建索引，每个环的最后一个点自动与第一个点相连
+    void build(const std::vector<const std::vector<glm::vec2>*>& rings);
+
+    // 奇偶规则判断点是否在区域内：只检查点所在的水平条带中的边
+    bool is_inside(const glm::vec2& point) const;
+
+    // 返回所有边上离 point 最近的点，可选输出平方距离
+    glm::vec2 closest_point(const glm::vec2& point, float* dist_sq = nullptr) const;
+
+    size_t get_num_edges() const { return seg_a_.size(); }
+    bool empty() const { return seg_a_.empty(); }
+
+private:
+    int cell_x(float x) const;
+    int cell_y(float y) const;
+
+    std::vector<glm::vec2> seg_a_, seg_b_; // 扁平的边数组
+
+    glm::vec2 min_coords_ = glm::vec2(0.0f);
+    glm::vec2 max_coords_ = glm::vec2(0.0f);
+    float cell_size_ = 1.0f;
+    int width_ = 0, height_ = 0;
+
+    // CSR 结构：cell_start_[c] .. cell_start_[c+1] 为第 c 个格子中的边
+    std::vector<unsigned int> cell_start_;
+    std::vector<unsigned int> cell_edges_;
+    // CSR 结构：每一行 (水平条带) 中与之相交的边，每条边在每行只出现一次
+    std::vector<unsigned int> row_start_;
+    std::vector<unsigned int> row_edges_;
+};
@@ -0,0 +1,73 @@
+#include "Mesh2D.h"
+#include "EdgeAdjacency.h"
+
+void Mesh2D::clear() {
+    x_.clear();
+    y_.clear();
+    face_start_.clear();
+    face_verts_.clear();
+    next_.clear();
+    twin_.clear();
+    half_face_.clear();
+    vert_half_.clear();
+}
+
+void Mesh2D::build(const std::vector<glm::vec2>& vertices, const std::vector<MeshTriangle>& triangles) {
+    static const std::vector<MeshQuad> no_quads;
+    build(vertices, triangles, no_quads);
+}
+
+void Mesh2D::build(const std::vector<glm::vec2>& vertices, const std::vector<MeshTriangle>& triangles,
+                   const std::vector<MeshQuad>& quads) {
+    clear();
+
+    // --- 1. 顶点转为 SoA ---
+    x_.resize(vertices.size());
+    y_.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        x_[i] = vertices[i].x;
+        y_[i] = vertices[i].y;
+    }
+
+    // --- 2. 扁平的面数组：先三角形，后四边形 ---
+    const size_t num_faces = triangles.size() + quads.size();
+    face_start_.reserve(num_faces + 1);
+    face_verts_.reserve(triangles.size() * 3 + quads.size() * 4);
+    face_start_.push_back(0);
+    for (const auto& t : triangles) {
+        face_verts_.insert(face_verts_.end(), { t.v0, t.v1, t.v2 });
+        face_start_.push_back(static_cast<Index>(face_verts_.size()));
+    }
+    for (const auto& q : quads) {
+        face_verts_.insert(face_verts_.end(), { q.v0, q.v1, q.v2, q.v3 });
+        face_start_.push_back(static_cast<Index>(face_verts_.size()));
+    }
+
+    build_half_edges();
+}
+
+void Mesh2D::build_half_edges() {
+    const Index num_half = static_cast<Index>(face_verts_.size());
+    const Index num_faces = static_cast<Index>(get_num_faces());
+    next_.resize(num_half);
+    half_face_.resize(num_half);
+    vert_half_.assign(x_.size(), invalid_index);
+
+    // --- 3. next 与所属面：面内角点首尾相接 ---
+    for (Index f = 0; f < num_faces; ++f) {
+        const Index begin = face_start_[f], end = face_start_[f + 1];
+        for (Index h = begin; h < end; ++h) {
+            next_[h] = (h + 1 < end) ? h + 1 : begin;
+            half_face_[h] = f;
+        }
+    }
+
+    // --- 4. 配对 twin：64 位边键基数排序后线性扫描 ---
+    build_edge_adjacency(face_verts_, next_, twin_);
+
+    // --- 5. 顶点的出半边，边界顶点优先取边界半边 ---
+    for (Index h = 0; h < num_half; ++h) {
+        Index& vh = vert_half_[face_verts_[h]];
+        if (vh == invalid_index || twin_[h] == invalid_index) vh = h;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// 各生成器与 Qmorph 共用的单元类型，顶点按逆时针排列
+struct MeshTriangle {
+    unsigned int v0, v1, v2;
+    static constexpr int num_vertices = 3;
+    // 按序号访问角点，供对三角形和四边形通用的模板代码使用
+    unsigned int operator[](int k) const { return k == 0 ? v0 : (k == 1 ? v1 : v2); }
+};
+struct MeshQuad {
+    unsigned int v0, v1, v2, v3;
+    static constexpr int num_vertices = 4;
+    unsigned int operator[](int k) const { return k == 0 ? v0 : (k == 1 ? v1 : (k == 2 ? v2 : v3)); }
+};
+
+// 紧凑的基于索引的二维网格：
+// 顶点坐标按 SoA 存放，面 (三角形/四边形混合) 存放在扁平数组中，
+// 半边 h 就是 face_verts_ 中的第 h 个角点，从该角点指向面内下一个角点；
+// twin/next 为 32 位索引 (由 build_edge_adjacency 配对)，建立一次后供 Qmorph、光顺、质量评估与导出共享
+class Mesh2D {
+public:
+    using Index = std::uint32_t;
+    static constexpr Index invalid_index = 0xFFFFFFFFu;
+
+    Mesh2D() = default;
+
+    // 由顶点与三角形 (可选再加四边形) 建立网格与半边邻接，代价为一次排序加线性扫描
+    void build(const std::vector<glm::vec2>& vertices, const std::vector<MeshTriangle>& triangles);
+    void build(const std::vector<glm::vec2>& vertices, const std::vector<MeshTriangle>& triangles,
+               const std::vector<MeshQuad>& quads);
+    void clear();
+
+    size_t get_num_vertices() const { return x_.size(); }
+    size_t get_num_faces() const { return face_start_.empty() ? 0 : face_start_.size() - 1; }
+    size_t get_num_half_edges() const { return face_verts_.size(); }
+    bool empty() const { return face_verts_.empty(); }
+
+    // --- 顶点 ---
+    glm::vec2 position(Index v) const { return glm::vec2(x_[v], y_[v]); }
+    void set_position(Index v, const glm::vec2& p) { x_[v] = p.x; y_[v] = p.y; }
+    const std::vector<float>& get_x() const { return x_; }
+    const std::vector<float>& get_y() const { return y_; }
+    std::vector<glm::vec2> get_positions() const {
+        std::vector<glm::vec2> positions(x_.size());
+        for (size_t v = 0; v < x_.size(); ++v) positions[v] = glm::vec2(x_[v], y_[v]);
+        return positions;
+    }
+    // 从 v 出发的一条半边；边界顶点总是返回边界半边，便于沿一圈邻居完整遍历
+    Index vertex_half_edge(Index v) const { return vert_half_[v]; }
+    bool is_boundary_vertex(Index v) const {
+        return vert_half_[v] != invalid_index && twin_[vert_half_[v]] == invalid_index;
+    }
+
+    // --- 面 ---
+    Index face_begin(Index f) const { return face_start_[f]; }
+    Index face_size(Index f) const { return face_start_[f + 1] - face_start_[f]; }
+    Index face_vertex(Index f, Index k) const { return face_verts_[face_start_[f] + k]; }
+    const std::vector<Index>& get_face_start() const { return face_start_; }
+    const std::vector<Index>& get_face_verts() const { return face_verts_; }
+
+    // --- 半边 ---
+    Index origin(Index h) const { return face_verts_[h]; }
+    Index target(Index h) const { return face_verts_[next_[h]]; }
+    Index next(Index h) const { return next_[h]; }
+    Index twin(Index h) const { return twin_[h]; }
+    Index face(Index h) const { return half_face_[h]; }
+    Index prev(Index h) const {
+        Index p = h;
+        while (next_[p] != h) p = next_[p];
+        return p;
+    }
+    bool is_boundary_edge(Index h) const { return twin_[h] == invalid_index; }
+
+private:
+    void build_half_edges();
+
+    std::vector<float> x_, y_;          // 顶点坐标 (SoA)
+    std::vector<Index> face_start_;     // CSR：第 f 个面的角点为 face_verts_[face_start_[f] .. face_start_[f+1])
+    std::vector<Index> face_verts_;
+    std::vector<Index> next_;           // 面内的下一条半边
+    std::vector<Index> twin_;           // 相邻面中的反向半边，边界为 invalid_index
+    std::vector<Index> half_face_;      // 半边所属的面
+    std::vector<Index> vert_half_;      // 每个顶点的一条出半边
+};
@@ -0,0 +1,279 @@
+#include "MeshExporter.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+// VTU 与原始 SoA 格式把单元数组按字节整块写出，要求成员之间没有填充
+static_assert(sizeof(MeshTriangle) == 3 * sizeof(std::uint32_t) && sizeof(MeshQuad) == 4 * sizeof(std::uint32_t),
+              "element structs must be tightly packed uint32 corners");
+
+namespace {
+
+// --- 分块写出器：小块数据先拷进固定大小的缓冲区，缓冲区满了才调用一次 fwrite；
+// 大于缓冲区的连续数组先清空缓冲区再直接写出，不经过拷贝 ---
+class ChunkedWriter {
+public:
+    ChunkedWriter(FILE* file, size_t chunk_size)
+        : file_(file), buffer_(std::max<size_t>(chunk_size, 4096)) {}
+
+    void write(const void* data, size_t bytes) {
+        if (bytes >= buffer_.size()) {
+            flush();
+            if (ok_ && std::fwrite(data, 1, bytes, file_) != bytes) ok_ = false;
+            return;
+        }
+        if (used_ + bytes > buffer_.size()) flush();
+        std::memcpy(buffer_.data() + used_, data, bytes);
+        used_ += bytes;
+    }
+    void text(const char* s) { write(s, std::strlen(s)); }
+    template <typename T>
+    void put(const T& value) { write(&value, sizeof(T)); }
+
+    // 在缓冲区中预留 bytes 字节供调用者直接编码 (bytes 不超过缓冲区大小)
+    char* reserve(size_t bytes) {
+        if (used_ + bytes > buffer_.size()) flush();
+        char* p = buffer_.data() + used_;
+        used_ += bytes;
+        return p;
+    }
+    // 每次编码的元素个数，使一批数据正好放进缓冲区
+    size_t batch(size_t element_bytes) const { return std::max<size_t>(1, buffer_.size() / element_bytes); }
+
+    void flush() {
+        if (used_ > 0 && ok_ && std::fwrite(buffer_.data(), 1, used_, file_) != used_) ok_ = false;
+        used_ = 0;
+    }
+    bool ok() const { return ok_; }
+
+private:
+    FILE* file_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    bool ok_ = true;
+};
+
+struct FileCloser {
+    void operator()(FILE* f) const { if (f) std::fclose(f); }
+};
+
+FILE* open_file(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) std::cerr << "Error: Cannot open mesh file " << path << " for writing." << std::endl;
+    return f;
+}
+
+bool finish(ChunkedWriter& writer, std::unique_ptr<FILE, FileCloser>& file, const std::string& path,
+            size_t num_vertices, size_t num_elements) {
+    writer.flush();
+    const bool ok = writer.ok() && std::fclose(file.release()) == 0;
+    if (!ok) {
+        std::cerr << "Error: Failed to write mesh file " << path << std::endl;
+        return false;
+    }
+    std::cout << "Exported mesh " << path << ": " << num_vertices << " vertices, " << num_elements << " elements." << std::endl;
+    return true;
+}
+
+// 逐批把 count 个元素编码进缓冲区；encode(i, p) 把第 i 个元素写到 p 处 (element_bytes 字节)
+template <typename Encode>
+void write_encoded(ChunkedWriter& writer, size_t count, size_t element_bytes, Encode encode) {
+    const size_t batch = writer.batch(element_bytes);
+    for (size_t start = 0; start < count; start += batch) {
+        const size_t n = std::min(batch, count - start);
+        char* p = writer.reserve(n * element_bytes);
+        for (size_t i = 0; i < n; ++i, p += element_bytes) encode(start + i, p);
+    }
+}
+
+// Gmsh 4.1 的一个单元块：单元编号从 first_tag 开始，节点编号从 1 开始
+template <typename Element>
+void write_msh_block(ChunkedWriter& writer, const std::vector<Element>& elements, int element_type, std::uint64_t first_tag) {
+    constexpr int n = Element::num_vertices;
+    writer.put<std::int32_t>(2);            // entityDim
+    writer.put<std::int32_t>(1);            // entityTag
+    writer.put<std::int32_t>(element_type);
+    writer.put<std::uint64_t>(elements.size());
+    write_encoded(writer, elements.size(), (n + 1) * sizeof(std::uint64_t), [&](size_t i, char* p) {
+        std::uint64_t record[n + 1];
+        record[0] = first_tag + i;
+        for (int k = 0; k < n; ++k) record[k + 1] = static_cast<std::uint64_t>(elements[i][k]) + 1;
+        std::memcpy(p, record, sizeof(record));
+    });
+}
+
+} // namespace
+
+bool MeshExporter::save(const std::string& path, const std::vector<glm::vec2>& vertices,
+                        const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads) {
+    return save(path, vertices, triangles, quads, Options());
+}
+
+bool MeshExporter::save(const std::string& path, const std::vector<glm::vec2>& vertices,
+                        const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                        const Options& options) {
+    SPHMESH_PROFILE_SCOPE("mesh.export");
+    std::string ext;
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos) {
+        ext = path.substr(dot + 1);
+        for (auto& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (ext == "msh") return save_msh(path, vertices, triangles, quads, options);
+    if (ext == "vtu") return save_vtu(path, vertices, triangles, quads, options);
+    return save_raw(path, vertices, triangles, quads, options);
+}
+
+// Gmsh MSH 4.1 二进制：一个曲面实体，节点坐标为 double，单元按三角形 (类型 2)、四边形 (类型 3) 分块
+bool MeshExporter::save_msh(const std::string& path, const std::vector<glm::vec2>& vertices,
+                            const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                            const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedWriter writer(file.get(), options.chunk_size);
+    const std::uint64_t num_vertices = vertices.size();
+    const std::uint64_t num_elements = triangles.size() + quads.size();
+
+    writer.text("$MeshFormat\n4.1 1 8\n");
+    writer.put<std::int32_t>(1); // 字节序标记
+    writer.text("\n$EndMeshFormat\n");
+
+    // 实体：只有一个编号为 1 的曲面，包围盒取全部顶点
+    glm::vec2 lo(0.0f), hi(0.0f);
+    if (!vertices.empty()) {
+        lo = hi = vertices[0];
+        for (const auto& v : vertices) {
+            lo = glm::min(lo, v);
+            hi = glm::max(hi, v);
+        }
+    }
+    writer.text("$Entities\n");
+    const std::uint64_t entity_counts[4] = { 0, 0, 1, 0 };
+    writer.write(entity_counts, sizeof(entity_counts));
+    writer.put<std::int32_t>(1);
+    const double box[6] = { lo.x, lo.y, 0.0, hi.x, hi.y, 0.0 };
+    writer.write(box, sizeof(box));
+    writer.put<std::uint64_t>(0); // 物理组
+    writer.put<std::uint64_t>(0); // 边界曲线
+    writer.text("\n$EndEntities\n");
+
+    writer.text("$Nodes\n");
+    const std::uint64_t node_header[4] = { 1, num_vertices, num_vertices ? 1u : 0u, num_vertices };
+    writer.write(node_header, sizeof(node_header));
+    writer.put<std::int32_t>(2);
+    writer.put<std::int32_t>(1);
+    writer.put<std::int32_t>(0); // 不带参数坐标
+    writer.put<std::uint64_t>(num_vertices);
+    write_encoded(writer, vertices.size(), sizeof(std::uint64_t), [](size_t i, char* p) {
+        const std::uint64_t tag = i + 1;
+        std::memcpy(p, &tag, sizeof(tag));
+    });
+    write_encoded(writer, vertices.size(), 3 * sizeof(double), [&](size_t i, char* p) {
+        const double xyz[3] = { vertices[i].x, vertices[i].y, 0.0 };
+        std::memcpy(p, xyz, sizeof(xyz));
+    });
+    writer.text("\n$EndNodes\n");
+
+    writer.text("$Elements\n");
+    const std::uint64_t num_blocks = (triangles.empty() ? 0 : 1) + (quads.empty() ? 0 : 1);
+    const std::uint64_t element_header[4] = { num_blocks, num_elements, num_elements ? 1u : 0u, num_elements };
+    writer.write(element_header, sizeof(element_header));
+    if (!triangles.empty()) write_msh_block(writer, triangles, 2, 1);
+    if (!quads.empty()) write_msh_block(writer, quads, 3, triangles.size() + 1);
+    writer.text("\n$EndElements\n");
+
+    return finish(writer, file, path, vertices.size(), num_elements);
+}
+
+// VTK XML 非结构网格：所有数组以 raw 二进制追加在文件末尾，每个数组前有 UInt64 字节数
+bool MeshExporter::save_vtu(const std::string& path, const std::vector<glm::vec2>& vertices,
+                            const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                            const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedWriter writer(file.get(), options.chunk_size);
+    const size_t num_cells = triangles.size() + quads.size();
+
+    // 各数组的字节数与在追加数据中的偏移
+    const std::uint64_t points_bytes = vertices.size() * 3 * sizeof(float);
+    const std::uint64_t connectivity_bytes = (triangles.size() * 3 + quads.size() * 4) * sizeof(std::uint32_t);
+    const std::uint64_t offsets_bytes = num_cells * sizeof(std::uint32_t);
+    const std::uint64_t types_bytes = num_cells * sizeof(std::uint8_t);
+    const std::uint64_t points_offset = 0;
+    const std::uint64_t connectivity_offset = points_offset + sizeof(std::uint64_t) + points_bytes;
+    const std::uint64_t offsets_offset = connectivity_offset + sizeof(std::uint64_t) + connectivity_bytes;
+    const std::uint64_t types_offset = offsets_offset + sizeof(std::uint64_t) + offsets_bytes;
+
+    char header[1024];
+    std::snprintf(header, sizeof(header),
+        "<?xml version=\"1.0\"?>\n"
+        "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+        "  <UnstructuredGrid>\n"
+        "    <Piece NumberOfPoints=\"%llu\" NumberOfCells=\"%llu\">\n"
+        "      <Points>\n"
+        "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\"/>\n"
+        "      </Points>\n"
+        "      <Cells>\n"
+        "        <DataArray type=\"UInt32\" Name=\"connectivity\" format=\"appended\" offset=\"%llu\"/>\n"
+        "        <DataArray type=\"UInt32\" Name=\"offsets\" format=\"appended\" offset=\"%llu\"/>\n"
+        "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"%llu\"/>\n"
+        "      </Cells>\n"
+        "    </Piece>\n"
+        "  </UnstructuredGrid>\n"
+        "  <AppendedData encoding=\"raw\">\n"
+        "   _",
+        static_cast<unsigned long long>(vertices.size()), static_cast<unsigned long long>(num_cells),
+        static_cast<unsigned long long>(points_offset), static_cast<unsigned long long>(connectivity_offset),
+        static_cast<unsigned long long>(offsets_offset), static_cast<unsigned long long>(types_offset));
+    writer.text(header);
+
+    writer.put(points_bytes);
+    write_encoded(writer, vertices.size(), 3 * sizeof(float), [&](size_t i, char* p) {
+        const float xyz[3] = { vertices[i].x, vertices[i].y, 0.0f };
+        std::memcpy(p, xyz, sizeof(xyz));
+    });
+
+    // 单元顶点数组本身就是连续的 uint32，直接写出
+    writer.put(connectivity_bytes);
+    writer.write(triangles.data(), triangles.size() * sizeof(MeshTriangle));
+    writer.write(quads.data(), quads.size() * sizeof(MeshQuad));
+
+    writer.put(offsets_bytes);
+    write_encoded(writer, num_cells, sizeof(std::uint32_t), [&](size_t i, char* p) {
+        const std::uint32_t end = static_cast<std::uint32_t>(i < triangles.size()
+            ? 3 * (i + 1) : 3 * triangles.size() + 4 * (i + 1 - triangles.size()));
+        std::memcpy(p, &end, sizeof(end));
+    });
+
+    writer.put(types_bytes);
+    write_encoded(writer, num_cells, sizeof(std::uint8_t), [&](size_t i, char* p) {
+        *p = static_cast<char>(i < triangles.size() ? 5 : 9); // VTK_TRIANGLE / VTK_QUAD
+    });
+    writer.text("\n  </AppendedData>\n</VTKFile>\n");
+
+    return finish(writer, file, path, vertices.size(), num_cells);
+}
+
+bool MeshExporter::save_raw(const std::string& path, const std::vector<glm::vec2>& vertices,
+                            const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                            const Options& options) {
+    std::unique_ptr<FILE, FileCloser> file(open_file(path));
+    if (!file) return false;
+    ChunkedWriter writer(file.get(), options.chunk_size);
+
+    writer.write("SPHMESH1", 8);
+    const std::uint64_t counts[3] = { vertices.size(), triangles.size(), quads.size() };
+    writer.write(counts, sizeof(counts));
+    // 顶点按 AoS 存放，分两遍拆成 x、y 两个数组
+    write_encoded(writer, vertices.size(), sizeof(float), [&](size_t i, char* p) { std::memcpy(p, &vertices[i].x, sizeof(float)); });
+    write_encoded(writer, vertices.size(), sizeof(float), [&](size_t i, char* p) { std::memcpy(p, &vertices[i].y, sizeof(float)); });
+    writer.write(triangles.data(), triangles.size() * sizeof(MeshTriangle));
+    writer.write(quads.data(), quads.size() * sizeof(MeshQuad));
+
+    return finish(writer, file, path, vertices.size(), triangles.size() + quads.size());
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "Mesh2D.h"
+
+// 二进制网格导出器：直接从顶点、三角形、四边形数组写出，
+// 数据经固定大小的缓冲区成块写入 (大块的连续数组绕过缓冲区直接写出)，不做逐单元的文本格式化。
+// 支持 Gmsh .msh 4.1 二进制、VTK XML 非结构网格 (.vtu，raw 追加数据) 与 SoA 原始格式
+class MeshExporter {
+public:
+    struct Options {
+        // 写缓冲区大小 (字节)
+        size_t chunk_size = 1 << 22;
+    };
+
+    // 按扩展名选择格式：.msh、.vtu，其余按 SoA 原始格式写出
+    static bool save(const std::string& path, const std::vector<glm::vec2>& vertices,
+                     const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads);
+    static bool save(const std::string& path, const std::vector<glm::vec2>& vertices,
+                     const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                     const Options& options);
+
+    static bool save_msh(const std::string& path, const std::vector<glm::vec2>& vertices,
+                         const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                         const Options& options);
+    static bool save_vtu(const std::string& path, const std::vector<glm::vec2>& vertices,
+                         const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                         const Options& options);
+    // SoA 原始格式 (小端)：8 字节标识 "SPHMESH1"，uint64 顶点数、三角形数、四边形数，
+    // 随后为 float x[N]、float y[N]、uint32 三角形顶点 [3T]、uint32 四边形顶点 [4Q]
+    static bool save_raw(const std::string& path, const std::vector<glm::vec2>& vertices,
+                         const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads,
+                         const Options& options);
+};
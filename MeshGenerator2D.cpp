@@ -1,26 +1,88 @@
 #include "MeshGenerator2D.h"
 #include "Simulation2D.h"
 #include "Boundary.h"
-#include <unordered_map>
-#include <unordered_set>
+#include "EdgeAdjacency.h"
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
 #include <vector>
 
-struct ivec2_hash {
-    std::size_t operator()(const glm::ivec2& v) const {
-        return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
+namespace {
+
+constexpr unsigned int kEmpty = 0xFFFFFFFFu;
+// 稠密网格的单元数上限 (相对粒子数)，粒子过于稀疏时拒绝生成，避免分配巨大的数组
+constexpr size_t kMaxCellsPerParticle = 64;
+
+// 边中点的均匀网格 (CSR)，用于给孤立顶点找最近的边界边
+class MidpointGrid {
+public:
+    MidpointGrid(const std::vector<glm::vec2>& points, float cell_size) : points_(points), cell_(cell_size) {
+        lo_ = hi_ = points.front();
+        for (const auto& p : points) {
+            lo_ = glm::min(lo_, p);
+            hi_ = glm::max(hi_, p);
+        }
+        width_ = static_cast<int>((hi_.x - lo_.x) / cell_) + 1;
+        height_ = static_cast<int>((hi_.y - lo_.y) / cell_) + 1;
+        start_.assign(static_cast<size_t>(width_) * height_ + 1, 0);
+        for (const auto& p : points) start_[cell_index(cell_of(p)) + 1]++;
+        for (size_t c = 0; c + 1 < start_.size(); ++c) start_[c + 1] += start_[c];
+        items_.resize(points.size());
+        std::vector<unsigned int> fill(start_.begin(), start_.end() - 1);
+        for (unsigned int i = 0; i < points.size(); ++i) items_[fill[cell_index(cell_of(points[i]))]++] = i;
     }
-};
-struct pair_hash {
-    template <class T1, class T2>
-    std::size_t operator () (const std::pair<T1, T2>& p) const {
-        auto h1 = std::hash<T1>{}(p.first);
-        auto h2 = std::hash<T2>{}(p.second);
-        return h1 ^ (h2 << 1);
+
+    // 按 Chebyshev 距离逐圈向外搜索，圈外的点都不可能更近时停止
+    unsigned int nearest(const glm::vec2& p) const {
+        const glm::ivec2 c = cell_of(p);
+        unsigned int best = kEmpty;
+        float best_dist_sq = FLT_MAX;
+        const int max_ring = std::max(width_, height_);
+        for (int r = 0; r <= max_ring; ++r) {
+            for (int y = c.y - r; y <= c.y + r; ++y) {
+                if (y < 0 || y >= height_) continue;
+                const bool edge_row = (y == c.y - r || y == c.y + r);
+                for (int x = c.x - r; x <= c.x + r; x += (edge_row ? 1 : 2 * r)) {
+                    if (x >= 0 && x < width_) {
+                        const size_t cell = cell_index(glm::ivec2(x, y));
+                        for (unsigned int k = start_[cell]; k < start_[cell + 1]; ++k) {
+                            const glm::vec2 d = points_[items_[k]] - p;
+                            const float dist_sq = glm::dot(d, d);
+                            if (dist_sq < best_dist_sq || (dist_sq == best_dist_sq && items_[k] < best)) {
+                                best_dist_sq = dist_sq;
+                                best = items_[k];
+                            }
+                        }
+                    }
+                    if (r == 0) break;
+                }
+            }
+            const float reach = r * cell_;
+            if (best != kEmpty && best_dist_sq <= reach * reach) break;
+        }
+        return best;
+    }
+
+private:
+    glm::ivec2 cell_of(const glm::vec2& p) const {
+        const int x = static_cast<int>((p.x - lo_.x) / cell_);
+        const int y = static_cast<int>((p.y - lo_.y) / cell_);
+        return glm::ivec2(std::min(std::max(x, 0), width_ - 1), std::min(std::max(y, 0), height_ - 1));
     }
+    size_t cell_index(const glm::ivec2& c) const { return static_cast<size_t>(c.y) * width_ + c.x; }
+
+    const std::vector<glm::vec2>& points_;
+    float cell_;
+    glm::vec2 lo_, hi_;
+    int width_ = 0, height_ = 0;
+    std::vector<unsigned int> start_, items_;
 };
 
+} // namespace
+
 void MeshGenerator2D::generate(const Simulation2D& sim, const Boundary& boundary, float grid_size) {
     vertices_.clear();
     quads_.clear();
@@ -28,68 +90,92 @@ void MeshGenerator2D::generate(const Simulation2D& sim, const Boundary& boundary
 
     const auto& particles = sim.get_particle_positions();
     if (particles.empty()) return;
+    if (grid_size <= 0.0f) {
+        std::cerr << "Error: MeshGenerator2D needs a positive grid size." << std::endl;
+        return;
+    }
     vertices_ = particles;
 
-    std::unordered_map<glm::ivec2, unsigned int, ivec2_hash> grid_to_vertex_id_map;
+    // 1. 粒子所在的网格单元，范围由粒子包围盒确定
+    std::vector<glm::ivec2> cells(vertices_.size());
+    glm::ivec2 lo(INT32_MAX), hi(INT32_MIN);
+    for (size_t i = 0; i < vertices_.size(); ++i) {
+        cells[i] = { (int)round(vertices_[i].x / grid_size), (int)round(vertices_[i].y / grid_size) };
+        lo = glm::min(lo, cells[i]);
+        hi = glm::max(hi, cells[i]);
+    }
+    const size_t width = static_cast<size_t>(hi.x - lo.x) + 1;
+    const size_t height = static_cast<size_t>(hi.y - lo.y) + 1;
+    if (width * height > kMaxCellsPerParticle * vertices_.size() + (1u << 20)) {
+        std::cerr << "Error: Grid of " << width << " x " << height << " cells is too sparse for "
+                  << vertices_.size() << " particles, increase grid_size." << std::endl;
+        vertices_.clear();
+        return;
+    }
+
+    // 2. 稠密数组：每个单元存放落入其中的顶点 (多个粒子落入同一单元时保留编号最大的)
+    std::vector<unsigned int> cell_vertex(width * height, kEmpty);
     for (unsigned int i = 0; i < vertices_.size(); ++i) {
-        glm::ivec2 grid_index = { (int)round(vertices_[i].x / grid_size), (int)round(vertices_[i].y / grid_size) };
-        grid_to_vertex_id_map[grid_index] = i;
+        cell_vertex[static_cast<size_t>(cells[i].y - lo.y) * width + (cells[i].x - lo.x)] = i;
     }
 
-    std::unordered_map<std::pair<unsigned int, unsigned int>, int, pair_hash> edge_counts;
-    for (const auto& pair : grid_to_vertex_id_map) {
-        const auto& p0_idx = pair.first;
-        auto it_p1 = grid_to_vertex_id_map.find({ p0_idx.x + 1, p0_idx.y });
-        auto it_p2 = grid_to_vertex_id_map.find({ p0_idx.x + 1, p0_idx.y + 1 });
-        auto it_p3 = grid_to_vertex_id_map.find({ p0_idx.x, p0_idx.y + 1 });
-
-        if (it_p1 != grid_to_vertex_id_map.end() && it_p2 != grid_to_vertex_id_map.end() && it_p3 != grid_to_vertex_id_map.end()) {
-            unsigned int v0 = pair.second, v1 = it_p1->second, v2 = it_p2->second, v3 = it_p3->second;
-            quads_.push_back({ v0, v1, v2, v3 });
-            edge_counts[{std::min(v0, v1), std::max(v0, v1)}]++;
-            edge_counts[{std::min(v1, v2), std::max(v1, v2)}]++;
-            edge_counts[{std::min(v2, v3), std::max(v2, v3)}]++;
-            edge_counts[{std::min(v3, v0), std::max(v3, v0)}]++;
+    // 3. 相邻四个单元都有顶点时生成四边形 (逆时针)
+    for (size_t y = 0; y + 1 < height; ++y) {
+        const unsigned int* row = cell_vertex.data() + y * width;
+        const unsigned int* up = row + width;
+        for (size_t x = 0; x + 1 < width; ++x) {
+            if (row[x] == kEmpty || row[x + 1] == kEmpty || up[x + 1] == kEmpty || up[x] == kEmpty) continue;
+            quads_.push_back({ row[x], row[x + 1], up[x + 1], up[x] });
         }
     }
 
-    std::unordered_set<unsigned int> used_vertices;
+    // 4. 排序计数：只属于一个四边形的边是内部网格的边界边
+    int vbits = 1;
+    while ((static_cast<size_t>(1) << vbits) < vertices_.size()) ++vbits;
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> ids;
+    keys.reserve(quads_.size() * 4);
     for (const auto& q : quads_) {
-        used_vertices.insert({ q.v0, q.v1, q.v2, q.v3 });
-    }
-
-    std::vector<unsigned int> isolated_vertices;
-    for (unsigned int i = 0; i < particles.size(); ++i) {
-        if (used_vertices.find(i) == used_vertices.end()) {
-            isolated_vertices.push_back(i);
+        const unsigned int v[4] = { q.v0, q.v1, q.v2, q.v3 };
+        for (int k = 0; k < 4; ++k) {
+            const unsigned int a = std::min(v[k], v[(k + 1) & 3]), b = std::max(v[k], v[(k + 1) & 3]);
+            keys.push_back((static_cast<std::uint64_t>(a) << vbits) | b);
         }
     }
+    ids.resize(keys.size());
+    radix_sort_pairs(keys, ids, 2 * vbits);
 
     std::vector<std::pair<unsigned int, unsigned int>> inner_border_edges;
-    for (const auto& pair : edge_counts) {
-        if (pair.second == 1) {
-            inner_border_edges.push_back(pair.first);
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j] == keys[i]) ++j;
+        if (j - i == 1) {
+            inner_border_edges.push_back({ static_cast<unsigned int>(keys[i] >> vbits),
+                                           static_cast<unsigned int>(keys[i] & ((static_cast<std::uint64_t>(1) << vbits) - 1)) });
         }
+        i = j;
     }
 
     if (inner_border_edges.empty()) return;
 
-    for (unsigned int isolated_id : isolated_vertices) {
-        const auto& isolated_pos = vertices_[isolated_id];
-        float min_dist_sq = FLT_MAX;
-        std::pair<unsigned int, unsigned int> closest_edge = { 0,0 };
-
-        for (const auto& edge : inner_border_edges) {
-            glm::vec2 edge_midpoint = (vertices_[edge.first] + vertices_[edge.second]) * 0.5f;
-            float dist_sq = glm::dot(isolated_pos - edge_midpoint, isolated_pos - edge_midpoint);
-            if (dist_sq < min_dist_sq) {
-                min_dist_sq = dist_sq;
-                closest_edge = edge;
-            }
-        }
+    // 5. 孤立顶点：连接到中点最近的边界边，最近边由中点网格查询得到
+    std::vector<unsigned char> used(vertices_.size(), 0);
+    for (const auto& q : quads_) {
+        used[q.v0] = used[q.v1] = used[q.v2] = used[q.v3] = 1;
+    }
+    std::vector<glm::vec2> midpoints(inner_border_edges.size());
+    for (size_t e = 0; e < inner_border_edges.size(); ++e) {
+        midpoints[e] = (vertices_[inner_border_edges[e].first] + vertices_[inner_border_edges[e].second]) * 0.5f;
+    }
+    const MidpointGrid midpoint_grid(midpoints, grid_size);
 
-        if (closest_edge.first != 0 || closest_edge.second != 0) {
-            triangles_.push_back({ isolated_id, closest_edge.first, closest_edge.second });
-        }
+    for (unsigned int isolated_id = 0; isolated_id < vertices_.size(); ++isolated_id) {
+        if (used[isolated_id]) continue;
+        const auto& edge = inner_border_edges[midpoint_grid.nearest(vertices_[isolated_id])];
+        // 三角形统一为逆时针
+        const glm::vec2 a = vertices_[edge.first] - vertices_[isolated_id];
+        const glm::vec2 b = vertices_[edge.second] - vertices_[isolated_id];
+        if (a.x * b.y - a.y * b.x >= 0.0f) triangles_.push_back({ isolated_id, edge.first, edge.second });
+        else triangles_.push_back({ isolated_id, edge.second, edge.first });
     }
 }
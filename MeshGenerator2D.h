@@ -1,18 +1,15 @@
 #pragma once
 #include <vector>
 #include <glm/glm.hpp>
+#include "Mesh2D.h"
 
 class Simulation2D;
 class Boundary;
 
 class MeshGenerator2D {
 public:
-    struct Quad {
-        unsigned int v0, v1, v2, v3;
-    };
-    struct Triangle {
-        unsigned int v0, v1, v2;
-    };
+    using Quad = MeshQuad;         // 新增：与其他生成器共用的单元类型
+    using Triangle = MeshTriangle;
 
     MeshGenerator2D() = default;
 
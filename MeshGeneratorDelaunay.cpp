@@ -1,107 +1,187 @@
 #include "MeshGeneratorDelaunay.h"
 #include "Simulation2D.h"
-#include "triangle.h"
 #include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
 
-// *** ޏͣڰ^ļ֮ǰxбҪĺ ***
+// *** 核心修復：在包含頭文件之前，定義所有必要的宏 ***
+// (ANSI_DECLARATORS 使 triangle.h 給出帶參數的函式原型，否則 C++ 無法以四個參數調用 triangulate)
 #define TRILIBRARY
+#define ANSI_DECLARATORS
 #define REAL double
+#define VOID void
 extern "C" {
 #include "triangle.h"
 }
 
-void MeshGeneratorDelaunay::triangulate1(const Simulation2D& sim) {
+// 單個環的射線法判斷
+static bool point_in_ring(const glm::vec2& p, const std::vector<glm::vec2>& ring) {
+    bool inside = false;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        if (((ring[i].y > p.y) != (ring[j].y > p.y)) &&
+            (p.x < (ring[j].x - ring[i].x) * (p.y - ring[i].y) / (ring[j].y - ring[i].y) + ring[i].x)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// 孔洞點：在某條邊中點沿法向稍微偏移，取落在孔洞環內部的一側
+static bool find_hole_point(const std::vector<glm::vec2>& ring, glm::vec2& hole_point) {
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        glm::vec2 edge = ring[i] - ring[j];
+        float len = glm::length(edge);
+        if (len <= 0.0f) continue;
+        glm::vec2 normal(-edge.y / len, edge.x / len);
+        glm::vec2 mid = (ring[i] + ring[j]) * 0.5f;
+        for (float side : { 1.0f, -1.0f }) {
+            glm::vec2 candidate = mid + normal * (side * 1e-3f * len);
+            if (point_in_ring(candidate, ring)) {
+                hole_point = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+MeshGeneratorDelaunay::~MeshGeneratorDelaunay() {
+    free(out_points_);
+    free(out_triangles_);
+    free(out_neighbors_);
+}
+
+// 平面三角化的三角形數不超過 2n，一次按上限分配，之後只在點數增長時擴容
+void MeshGeneratorDelaunay::reserve_output(size_t num_points) {
+    if (num_points > out_point_capacity_) {
+        free(out_points_);
+        out_point_capacity_ = num_points + num_points / 4;
+        out_points_ = static_cast<double*>(malloc(out_point_capacity_ * 2 * sizeof(double)));
+    }
+    if (2 * num_points > out_triangle_capacity_) {
+        free(out_triangles_);
+        free(out_neighbors_);
+        out_triangle_capacity_ = 2 * out_point_capacity_;
+        out_triangles_ = static_cast<int*>(malloc(out_triangle_capacity_ * 3 * sizeof(int)));
+        out_neighbors_ = static_cast<int*>(malloc(out_triangle_capacity_ * 3 * sizeof(int)));
+    }
+}
+
+void MeshGeneratorDelaunay::run_triangle(const char* switches) {
     vertices_.clear();
     triangles_.clear();
+    neighbors_.clear();
 
-    const auto& particles = sim.get_particle_positions();
-    if (particles.empty()) return;
+    const size_t num_points = in_points_.size() / 2;
+    if (num_points < 3) return;
+    // 線段相交時 Triangle 會插入交點，為此預留與線段數相同的額外點
+    reserve_output(num_points + in_segments_.size() / 2);
 
-    vertices_ = particles;
+    struct triangulateio in = {}, out = {}, vorout = {};
+    in.numberofpoints = static_cast<int>(num_points);
+    in.pointlist = in_points_.data();
+    in.numberofsegments = static_cast<int>(in_segments_.size() / 2);
+    in.segmentlist = in_segments_.empty() ? nullptr : in_segments_.data();
+    in.numberofholes = static_cast<int>(in_holes_.size() / 2);
+    in.holelist = in_holes_.empty() ? nullptr : in_holes_.data();
 
-    // --- ʂ Triangle ݔ딵 ---
-    std::vector<REAL> points_for_triangle; // ʹ REAL  double
-    points_for_triangle.reserve(vertices_.size() * 2);
-    for (const auto& v : vertices_) {
-        points_for_triangle.push_back(v.x);
-        points_for_triangle.push_back(v.y);
-    }
+    out.pointlist = out_points_;
+    out.trianglelist = out_triangles_;
+    out.neighborlist = out_neighbors_;
+
+    ::triangulate(const_cast<char*>(switches), &in, &out, &vorout);
 
-    // --- ʼݔݔYw ---
-    struct triangulateio in, out, vorout;
-
-    // ʼṹ
-    in.numberofpoints = static_cast<int>(vertices_.size());
-    in.pointlist = points_for_triangle.data();
-    in.numberofpointattributes = 0;
-    in.pointattributelist = nullptr;
-    in.pointmarkerlist = nullptr;
-    in.numberofsegments = 0;
-    in.segmentlist = nullptr;
-    in.segmentmarkerlist = nullptr;
-    in.numberofholes = 0;
-    in.holelist = nullptr;
-    in.numberofregions = 0;
-    in.regionlist = nullptr;
-
-    // ʼṹ
-    out.pointlist = nullptr;
-    out.pointattributelist = nullptr;
-    out.pointmarkerlist = nullptr;
-    out.trianglelist = nullptr;
-    out.triangleattributelist = nullptr;
-    out.neighborlist = nullptr;
-    out.segmentlist = nullptr;
-    out.segmentmarkerlist = nullptr;
-    out.edgelist = nullptr;
-    out.edgemarkerlist = nullptr;
-
-    // ʼVoronoiṹ壨ʹʹã
-    vorout.pointlist = nullptr;
-    vorout.pointattributelist = nullptr;
-    vorout.pointmarkerlist = nullptr;
-    vorout.trianglelist = nullptr;
-    vorout.triangleattributelist = nullptr;
-    vorout.neighborlist = nullptr;
-    vorout.segmentlist = nullptr;
-    vorout.segmentmarkerlist = nullptr;
-    vorout.edgelist = nullptr;
-    vorout.edgemarkerlist = nullptr;
-    char* zq = NULL;
-    // --- ʹ4{ triangulate ---
-    ::triangulate(const_cast<char*>("zQ"), &in, &out, &vorout);
-
-    // --- ݔYȡ ---
+    // --- 提取結果：只輸出被三角形使用的頂點 ---
+    const unsigned int unassigned = std::numeric_limits<unsigned int>::max();
+    remap_.assign(out.numberofpoints, unassigned);
+    vertices_.reserve(out.numberofpoints);
     triangles_.reserve(out.numberoftriangles);
     for (int i = 0; i < out.numberoftriangles; ++i) {
-        triangles_.push_back({
-            static_cast<unsigned int>(out.trianglelist[i * 3 + 0]),
-            static_cast<unsigned int>(out.trianglelist[i * 3 + 1]),
-            static_cast<unsigned int>(out.trianglelist[i * 3 + 2])
-            });
+        unsigned int v[3];
+        for (int k = 0; k < 3; ++k) {
+            const int src = out.trianglelist[i * 3 + k];
+            if (remap_[src] == unassigned) {
+                remap_[src] = static_cast<unsigned int>(vertices_.size());
+                vertices_.emplace_back(static_cast<float>(out.pointlist[src * 2]), static_cast<float>(out.pointlist[src * 2 + 1]));
+            }
+            v[k] = remap_[src];
+        }
+        triangles_.push_back({ v[0], v[1], v[2] });
     }
+    if (out.neighborlist) {
+        neighbors_.assign(out.neighborlist, out.neighborlist + out.numberoftriangles * 3);
+    }
+
+    // 超出預分配容量時 Triangle 會自行分配 (理論上不會發生)，此時接管新的緩衝區
+    if (out.pointlist != out_points_) { free(out_points_); out_points_ = out.pointlist; out_point_capacity_ = out.numberofpoints; }
+    if (out.trianglelist != out_triangles_) { free(out_triangles_); out_triangles_ = out.trianglelist; out_triangle_capacity_ = out.numberoftriangles; }
+    if (out.neighborlist != out_neighbors_) { free(out_neighbors_); out_neighbors_ = out.neighborlist; }
 
-    // --- ጷŃȴ ---
-    free(out.pointlist);
+    // 其餘輸出 (屬性、標記等) 在所給開關下應為空，保險起見釋放
     free(out.pointattributelist);
     free(out.pointmarkerlist);
-    free(out.trianglelist);
     free(out.triangleattributelist);
-    free(out.neighborlist);
     free(out.segmentlist);
     free(out.segmentmarkerlist);
     free(out.edgelist);
     free(out.edgemarkerlist);
+}
+
+void MeshGeneratorDelaunay::generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary) {
+    in_points_.clear();
+    in_segments_.clear();
+    in_holes_.clear();
+    if (particles.empty() || boundary.get_vertices().empty()) {
+        vertices_.clear();
+        triangles_.clear();
+        neighbors_.clear();
+        return;
+    }
+
+    // --- 準備 PSLG：內部粒子，然後是各邊界環的頂點與線段 ---
+    in_points_.reserve(2 * (particles.size() + boundary.get_edge_index().get_num_edges()));
+    for (const auto& p : particles) {
+        if (p.is_boundary) continue;
+        in_points_.push_back(p.position.x);
+        in_points_.push_back(p.position.y);
+    }
+    for (size_t r = 0; r < boundary.get_num_rings(); ++r) {
+        const auto& ring = boundary.get_ring(r);
+        const int first = static_cast<int>(in_points_.size() / 2);
+        const int count = static_cast<int>(ring.size());
+        for (const auto& v : ring) {
+            in_points_.push_back(v.x);
+            in_points_.push_back(v.y);
+        }
+        for (int i = 0; i < count; ++i) {
+            in_segments_.push_back(first + i);
+            in_segments_.push_back(first + (i + 1) % count);
+        }
+        glm::vec2 hole_point;
+        if (r > 0 && find_hole_point(ring, hole_point)) {
+            in_holes_.push_back(hole_point.x);
+            in_holes_.push_back(hole_point.y);
+        }
+    }
 
-    // ጷVoronoiݔȴ
-    free(vorout.pointlist);
-    free(vorout.pointattributelist);
-    free(vorout.pointmarkerlist);
-    free(vorout.trianglelist);
-    free(vorout.triangleattributelist);
-    free(vorout.neighborlist);
-    free(vorout.segmentlist);
-    free(vorout.segmentmarkerlist);
-    free(vorout.edgelist);
-    free(vorout.edgemarkerlist);
-}
\ No newline at end of file
+    // p: PSLG (線段外的三角形自動被吃掉)，z: 從 0 編號，Q: 安靜，n: 輸出鄰居，
+    // P/B: 不輸出線段與邊界標記，Y: 不在邊界上插入 Steiner 點
+    run_triangle("pzQnPBY");
+
+    std::cout << "Triangle generated (Constrained): " << vertices_.size() << " vertices, " << triangles_.size() << " triangles." << std::endl;
+}
+
+void MeshGeneratorDelaunay::triangulate1(const Simulation2D& sim) {
+    in_points_.clear();
+    in_segments_.clear();
+    in_holes_.clear();
+
+    const auto& particles = sim.get_particle_positions();
+    in_points_.reserve(particles.size() * 2);
+    for (const auto& v : particles) {
+        in_points_.push_back(v.x);
+        in_points_.push_back(v.y);
+    }
+    run_triangle("zQnB");
+}
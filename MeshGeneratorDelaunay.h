@@ -1,25 +1,55 @@
 #pragma once
 #include <vector>
 #include <glm/glm.hpp>
+#include "Simulation2D.h"
+#include "Boundary.h"
+#include "Mesh2D.h"
 
-class Simulation2D; // ǰ
-
+// Triangle 庫後端：以邊界為 PSLG (線段 + 孔洞點) 做約束 Delaunay 三角化，
+// 與 CGALMeshGenerator / DelaunayMeshGenerator 提供相同的 generate_mesh 介面。
+// 輸入與輸出緩衝區在多次調用之間重用，不再每次重新分配與釋放。
+// 依賴 Shewchuk 的 Triangle 庫 (不隨本專案發佈)，只在 CMake 選項 SPHMESH_WITH_TRIANGLE 開啟時編譯
 class MeshGeneratorDelaunay {
 public:
-    // 춃һεc
-    struct Triangle {
-        unsigned int v0, v1, v2;
-    };
+    using Triangle = MeshTriangle; // 與其他生成器共用的三角形類型
 
     MeshGeneratorDelaunay() = default;
+    ~MeshGeneratorDelaunay();
+
+    MeshGeneratorDelaunay(const MeshGeneratorDelaunay&) = delete;
+    MeshGeneratorDelaunay& operator=(const MeshGeneratorDelaunay&) = delete;
 
-    // ĹܣcKеڃǻ
+    // 核心功能：內部粒子 + 所有邊界環頂點，邊界環作為約束線段，孔洞內放置孔洞點
+    void generate_mesh(const std::vector<Simulation2D::Particle>& particles, const Boundary& boundary);
+
+    // 舊介面：只對粒子點做無約束的 Delaunay 三角化 (凸包)
     void triangulate1(const Simulation2D& sim);
 
     const std::vector<glm::vec2>& get_vertices() const { return vertices_; }
     const std::vector<Triangle>& get_triangles() const { return triangles_; }
+    // 每個三角形 3 個鄰居，第 i 個位於頂點 i 的對邊，-1 表示邊界
+    const std::vector<int>& get_neighbors() const { return neighbors_; }
 
 private:
+    // 以 in_points_ / in_segments_ / in_holes_ 調用 Triangle，並把結果寫入 vertices_ 等
+    void run_triangle(const char* switches);
+    void reserve_output(size_t num_points);
+
     std::vector<glm::vec2> vertices_;
     std::vector<Triangle> triangles_;
-};
\ No newline at end of file
+    std::vector<int> neighbors_;
+
+    // 輸入緩衝區 (clear 後保留容量)
+    std::vector<double> in_points_;
+    std::vector<int> in_segments_;
+    std::vector<double> in_holes_;
+
+    // 輸出緩衝區：Triangle 只在指標為空時才分配，因此預先分配並在調用間保留
+    double* out_points_ = nullptr;
+    int* out_triangles_ = nullptr;
+    int* out_neighbors_ = nullptr;
+    size_t out_point_capacity_ = 0;
+    size_t out_triangle_capacity_ = 0;
+
+    std::vector<unsigned int> remap_;
+};
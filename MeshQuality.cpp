@@ -0,0 +1,311 @@
+#include "MeshQuality.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr float kDegrees = 180.0f / kPi;
+constexpr float kTiny = 1e-30f;           // 防止退化单元除零
+constexpr float kTwoOverSqrt3 = 1.15470054f;
+constexpr float kTwoSqrt3 = 3.46410162f;
+constexpr float kCos25 = 0.90630779f;     // cos(25°)
+constexpr float kCos165 = -0.96592583f;   // cos(165°)
+
+// Abramowitz & Stegun 4.4.45 的多项式近似，最大误差约 6.7e-5 弧度
+float fast_acos(float x) {
+    const float ax = std::fabs(x);
+    const float r = std::sqrt(1.0f - ax) * (1.5707288f + ax * (-0.2121144f + ax * (0.0742610f - 0.0187293f * ax)));
+    return x < 0.0f ? kPi - r : r;
+}
+
+float clamp_unit(float x) {
+    return std::min(1.0f, std::max(-1.0f, x));
+}
+
+void fill_histogram(MeshQuality::Histogram& histogram, const std::vector<float>& values,
+                    float min_value, float max_value, int bins) {
+    histogram.min_value = min_value;
+    histogram.max_value = max_value;
+    histogram.counts.assign(std::max(1, bins), 0);
+    const int last = static_cast<int>(histogram.counts.size()) - 1;
+    const float scale = static_cast<float>(histogram.counts.size()) / (max_value - min_value);
+    for (float v : values) {
+        const int bin = static_cast<int>((v - min_value) * scale);
+        histogram.counts[std::min(last, std::max(0, bin))]++;
+    }
+}
+
+void print_histogram(std::ostream& out, const char* name, const MeshQuality::Histogram& histogram) {
+    if (histogram.counts.empty()) return;
+    out << "  " << name << " histogram:" << std::endl;
+    const float width = (histogram.max_value - histogram.min_value) / histogram.counts.size();
+    for (size_t i = 0; i < histogram.counts.size(); ++i) {
+        out << "    [" << std::setw(7) << histogram.min_value + width * i << ", "
+            << std::setw(7) << histogram.min_value + width * (i + 1) << "): " << histogram.counts[i] << std::endl;
+    }
+}
+
+} // namespace
+
+float MeshQuality::quad_quality_fast(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4) {
+    const glm::vec2 p[4] = { p1, p2, p3, p4 };
+    float cos_min = 1.0f, cos_max = -1.0f;
+    for (int i = 0; i < 4; ++i) {
+        const glm::vec2 u = p[(i + 1) & 3] - p[i];
+        const glm::vec2 v = p[(i + 3) & 3] - p[i];
+        // 逆时针四边形的每个角点处 u 逆时针转到 v，叉积非正说明非凸或翻转
+        const float cross = u.x * v.y - u.y * v.x;
+        const float len2 = glm::dot(u, u) * glm::dot(v, v);
+        if (cross <= 0.0f || len2 <= 0.0f) return 0.0f;
+        const float c = glm::dot(u, v) / std::sqrt(len2);
+        cos_min = std::min(cos_min, c);
+        cos_max = std::max(cos_max, c);
+    }
+
+    // 最大角对应最小的余弦，最小角对应最大的余弦
+    if (cos_min < kCos165 || cos_max > kCos25) {
+        return 0.0f;
+    }
+    const float max_angle_deg = fast_acos(cos_min) * kDegrees;
+    return 1.0f - (max_angle_deg - 90.0f) / 75.0f;
+}
+
+float MeshQuality::element_scaled_jacobian(const glm::vec2* p, int n) {
+    float jacobian = 1.0f;
+    for (int k = 0; k < n; ++k) {
+        const glm::vec2 u = p[(k + 1) % n] - p[k];
+        const glm::vec2 v = p[(k + n - 1) % n] - p[k];
+        const float cross = u.x * v.y - u.y * v.x;
+        jacobian = std::min(jacobian, cross / std::sqrt(std::max(glm::dot(u, u) * glm::dot(v, v), kTiny)));
+    }
+    return n == 3 ? std::min(1.0f, jacobian * kTwoOverSqrt3) : jacobian;
+}
+
+void MeshQuality::evaluate(const Mesh2D& mesh) {
+    SPHMESH_PROFILE_SCOPE("mesh.quality");
+    using Index = Mesh2D::Index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    min_angle_.assign(num_faces, 0.0f);
+    max_angle_.assign(num_faces, 0.0f);
+    aspect_ratio_.assign(num_faces, 0.0f);
+    scaled_jacobian_.assign(num_faces, 0.0f);
+    skewness_.assign(num_faces, 0.0f);
+
+    // 1. 按单元类型分组，同一批内的计算完全相同
+    std::vector<Index> triangles, quads;
+    for (Index f = 0; f < num_faces; ++f) {
+        if (mesh.face_size(f) == 3) triangles.push_back(f);
+        else if (mesh.face_size(f) == 4) quads.push_back(f);
+    }
+
+    // 2. 两组各自按若干批一块分给任务池
+    const size_t grain = 4 * std::max<size_t>(1, options_.batch_size);
+    auto& scheduler = TaskScheduler::instance();
+    scheduler.parallel_for(0, triangles.size(), grain, [&](size_t lo, size_t hi) {
+        evaluate_triangles(mesh, triangles.data() + lo, hi - lo);
+    });
+    scheduler.parallel_for(0, quads.size(), grain, [&](size_t lo, size_t hi) {
+        evaluate_quads(mesh, quads.data() + lo, hi - lo);
+    });
+
+    report_.num_triangles = triangles.size();
+    report_.num_quads = quads.size();
+    build_report(mesh);
+}
+
+void MeshQuality::evaluate_triangles(const Mesh2D& mesh, const Mesh2D::Index* faces, size_t count) {
+    const size_t batch = std::max<size_t>(1, options_.batch_size);
+    std::vector<float> buffer(batch * 8);
+    float* ax = buffer.data();
+    float* ay = ax + batch;
+    float* bx = ay + batch;
+    float* by = bx + batch;
+    float* cx = by + batch;
+    float* cy = cx + batch;
+    float* cos_max = cy + batch; // 最小角的余弦
+    float* cos_min = cos_max + batch; // 最大角的余弦
+
+    for (size_t start = 0; start < count; start += batch) {
+        const size_t n = std::min(batch, count - start);
+        // 收集角点坐标
+        for (size_t i = 0; i < n; ++i) {
+            const auto begin = mesh.face_begin(faces[start + i]);
+            const glm::vec2 a = mesh.position(mesh.origin(begin));
+            const glm::vec2 b = mesh.position(mesh.origin(begin + 1));
+            const glm::vec2 c = mesh.position(mesh.origin(begin + 2));
+            ax[i] = a.x; ay[i] = a.y;
+            bx[i] = b.x; by[i] = b.y;
+            cx[i] = c.x; cy[i] = c.y;
+        }
+        // 无分支、不调用 libm 超越函数的计算循环 (sqrt 可向量化)，角度的 acos 留到下一个循环
+        for (size_t i = 0; i < n; ++i) {
+            const float e0x = bx[i] - ax[i], e0y = by[i] - ay[i];
+            const float e1x = cx[i] - bx[i], e1y = cy[i] - by[i];
+            const float e2x = ax[i] - cx[i], e2y = ay[i] - cy[i];
+            const float l0 = e0x * e0x + e0y * e0y;
+            const float l1 = e1x * e1x + e1y * e1y;
+            const float l2 = e2x * e2x + e2y * e2y;
+            const float area2 = e0x * e1y - e0y * e1x; // 两倍有向面积
+
+            const float p0 = std::max(l2 * l0, kTiny), p1 = std::max(l0 * l1, kTiny), p2 = std::max(l1 * l2, kTiny);
+            const float cos_a = -(e2x * e0x + e2y * e0y) / std::sqrt(p0);
+            const float cos_b = -(e0x * e1x + e0y * e1y) / std::sqrt(p1);
+            const float cos_c = -(e1x * e2x + e1y * e2y) / std::sqrt(p2);
+            cos_max[i] = clamp_unit(std::max(cos_a, std::max(cos_b, cos_c)));
+            cos_min[i] = clamp_unit(std::min(cos_a, std::min(cos_b, cos_c)));
+
+            const float perimeter = std::sqrt(l0) + std::sqrt(l1) + std::sqrt(l2);
+            const float longest = std::sqrt(std::max(l0, std::max(l1, l2)));
+            // 长宽比：最长边 * 周长 / (4√3 面积)，等边三角形为 1
+            const float aspect = area2 > 0.0f ? longest * perimeter / (kTwoSqrt3 * area2) : FLT_MAX;
+            // scaled Jacobian：最小角的正弦，归一化使等边三角形为 1
+            const float jacobian = area2 * kTwoOverSqrt3 / std::sqrt(std::max(p0, std::max(p1, p2)));
+
+            const Mesh2D::Index f = faces[start + i];
+            aspect_ratio_[f] = aspect;
+            scaled_jacobian_[f] = clamp_unit(jacobian);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const float min_angle = std::acos(cos_max[i]) * kDegrees;
+            const float max_angle = std::acos(cos_min[i]) * kDegrees;
+            const Mesh2D::Index f = faces[start + i];
+            min_angle_[f] = min_angle;
+            max_angle_[f] = max_angle;
+            skewness_[f] = std::max((max_angle - 60.0f) / 120.0f, (60.0f - min_angle) / 60.0f);
+        }
+    }
+}
+
+void MeshQuality::evaluate_quads(const Mesh2D& mesh, const Mesh2D::Index* faces, size_t count) {
+    const size_t batch = std::max<size_t>(1, options_.batch_size);
+    std::vector<float> buffer(batch * 16);
+    float* px[4];
+    float* py[4];
+    float* corner_cross[4]; // 角点 k 处两条边的叉积与点积，供第二个循环求角度
+    float* corner_dot[4];
+    for (int k = 0; k < 4; ++k) {
+        px[k] = buffer.data() + batch * (2 * k);
+        py[k] = buffer.data() + batch * (2 * k + 1);
+        corner_cross[k] = buffer.data() + batch * (8 + 2 * k);
+        corner_dot[k] = buffer.data() + batch * (9 + 2 * k);
+    }
+
+    for (size_t start = 0; start < count; start += batch) {
+        const size_t n = std::min(batch, count - start);
+        for (size_t i = 0; i < n; ++i) {
+            const auto begin = mesh.face_begin(faces[start + i]);
+            for (int k = 0; k < 4; ++k) {
+                const glm::vec2 p = mesh.position(mesh.origin(begin + k));
+                px[k][i] = p.x;
+                py[k][i] = p.y;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            float ex[4], ey[4], len[4];
+            for (int k = 0; k < 4; ++k) {
+                ex[k] = px[(k + 1) & 3][i] - px[k][i];
+                ey[k] = py[(k + 1) & 3][i] - py[k][i];
+                len[k] = ex[k] * ex[k] + ey[k] * ey[k];
+            }
+            float jacobian = 1.0f;
+            for (int k = 0; k < 4; ++k) {
+                // 角点 k 处从出边 e[k] 逆时针转到入边的反向 -e[k-1]
+                const int j = (k + 3) & 3;
+                const float cross = ex[j] * ey[k] - ey[j] * ex[k];
+                corner_cross[k][i] = cross;
+                corner_dot[k][i] = -(ex[k] * ex[j] + ey[k] * ey[j]);
+                jacobian = std::min(jacobian, cross / std::sqrt(std::max(len[k] * len[j], kTiny)));
+            }
+            const float shortest = std::min(std::min(len[0], len[1]), std::min(len[2], len[3]));
+            const float longest = std::max(std::max(len[0], len[1]), std::max(len[2], len[3]));
+
+            const Mesh2D::Index f = faces[start + i];
+            aspect_ratio_[f] = shortest > 0.0f ? std::sqrt(longest / shortest) : FLT_MAX;
+            scaled_jacobian_[f] = clamp_unit(jacobian);
+        }
+        // 角度需要 atan2，单独一个循环，不妨碍上面的循环向量化
+        for (size_t i = 0; i < n; ++i) {
+            float min_angle = 360.0f, max_angle = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                float angle = std::atan2(corner_cross[k][i], corner_dot[k][i]) * kDegrees;
+                angle = angle < 0.0f ? angle + 360.0f : angle; // 凹角
+                min_angle = std::min(min_angle, angle);
+                max_angle = std::max(max_angle, angle);
+            }
+            const Mesh2D::Index f = faces[start + i];
+            min_angle_[f] = min_angle;
+            max_angle_[f] = max_angle;
+            skewness_[f] = std::max((max_angle - 90.0f) / 90.0f, (90.0f - min_angle) / 90.0f);
+        }
+    }
+}
+
+void MeshQuality::build_report(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    const size_t num_faces = min_angle_.size();
+    Report& r = report_;
+    r.num_inverted = 0;
+    r.min_angle = num_faces ? 180.0f : 0.0f;
+    r.max_angle = 0.0f;
+    r.min_scaled_jacobian = num_faces ? 1.0f : 0.0f;
+    r.max_aspect_ratio = 0.0f;
+    r.max_skewness = 0.0f;
+    double sum_jacobian = 0.0, sum_aspect = 0.0, sum_skewness = 0.0;
+    size_t finite_aspect = 0;
+    for (size_t f = 0; f < num_faces; ++f) {
+        const int size = mesh.face_size(static_cast<Index>(f));
+        if (size != 3 && size != 4) continue;
+        r.min_angle = std::min(r.min_angle, min_angle_[f]);
+        r.max_angle = std::max(r.max_angle, max_angle_[f]);
+        r.min_scaled_jacobian = std::min(r.min_scaled_jacobian, scaled_jacobian_[f]);
+        r.max_aspect_ratio = std::max(r.max_aspect_ratio, aspect_ratio_[f]);
+        r.max_skewness = std::max(r.max_skewness, skewness_[f]);
+        if (scaled_jacobian_[f] <= 0.0f) r.num_inverted++;
+        sum_jacobian += scaled_jacobian_[f];
+        sum_skewness += skewness_[f];
+        if (aspect_ratio_[f] < FLT_MAX) {
+            sum_aspect += aspect_ratio_[f];
+            finite_aspect++;
+        }
+    }
+    const size_t counted = r.num_triangles + r.num_quads;
+    r.mean_scaled_jacobian = counted ? static_cast<float>(sum_jacobian / counted) : 0.0f;
+    r.mean_skewness = counted ? static_cast<float>(sum_skewness / counted) : 0.0f;
+    r.mean_aspect_ratio = finite_aspect ? static_cast<float>(sum_aspect / finite_aspect) : 0.0f;
+
+    fill_histogram(r.min_angle_histogram, min_angle_, 0.0f, 90.0f, options_.histogram_bins);
+    fill_histogram(r.scaled_jacobian_histogram, scaled_jacobian_, -1.0f, 1.0f, options_.histogram_bins);
+    fill_histogram(r.skewness_histogram, skewness_, 0.0f, 1.0f, options_.histogram_bins);
+
+    // 最差单元：按 scaled Jacobian 部分排序
+    std::vector<Index> order(num_faces);
+    std::iota(order.begin(), order.end(), 0u);
+    const size_t worst = std::min(options_.worst_count, order.size());
+    std::partial_sort(order.begin(), order.begin() + worst, order.end(),
+        [&](Index a, Index b) { return scaled_jacobian_[a] < scaled_jacobian_[b]; });
+    r.worst_faces.assign(order.begin(), order.begin() + worst);
+}
+
+void MeshQuality::print_report(std::ostream& out) const {
+    const Report& r = report_;
+    out << "Mesh quality: " << r.num_triangles << " triangles, " << r.num_quads << " quads, "
+        << r.num_inverted << " inverted or non-convex." << std::endl;
+    out << "  Angle: min " << r.min_angle << " deg, max " << r.max_angle << " deg" << std::endl;
+    out << "  Scaled Jacobian: min " << r.min_scaled_jacobian << ", mean " << r.mean_scaled_jacobian << std::endl;
+    out << "  Aspect ratio: max " << r.max_aspect_ratio << ", mean " << r.mean_aspect_ratio << std::endl;
+    out << "  Skewness: max " << r.max_skewness << ", mean " << r.mean_skewness << std::endl;
+    print_histogram(out, "Min angle", r.min_angle_histogram);
+    print_histogram(out, "Scaled Jacobian", r.scaled_jacobian_histogram);
+    print_histogram(out, "Skewness", r.skewness_histogram);
+    if (!r.worst_faces.empty()) {
+        out << "  Worst faces:";
+        for (auto f : r.worst_faces) out << " " << f << " (" << scaled_jacobian_[f] << ")";
+        out << std::endl;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <ostream>
+#include <glm/glm.hpp>
+#include "Mesh2D.h"
+
+// 网格质量评估：对 Mesh2D 中的三角形与四边形逐单元计算
+// 最小/最大内角、长宽比、scaled Jacobian 与等角偏斜度 (skewness)。
+// 单元按类型分组，按批把角点坐标收集到连续数组后用无分支的循环计算，便于编译器向量化；
+// 各批次在共享的任务池 (TaskScheduler) 上并行计算，结果以 SoA 数组保存，并汇总为直方图与最差单元列表
+class MeshQuality {
+public:
+    struct Options {
+        size_t batch_size = 256;      // 每批单元数
+        int histogram_bins = 10;
+        size_t worst_count = 10;      // 报告中列出的最差单元个数 (按 scaled Jacobian)
+    };
+
+    struct Histogram {
+        float min_value = 0.0f, max_value = 1.0f; // 超出范围的值计入首末两格
+        std::vector<size_t> counts;
+    };
+
+    struct Report {
+        size_t num_triangles = 0, num_quads = 0;
+        size_t num_inverted = 0;           // scaled Jacobian <= 0 的单元 (退化、翻转或非凸)
+        float min_angle = 0.0f, max_angle = 0.0f; // 全网格的最小/最大内角 (度)
+        float min_scaled_jacobian = 0.0f, mean_scaled_jacobian = 0.0f;
+        float max_aspect_ratio = 0.0f, mean_aspect_ratio = 0.0f;
+        float max_skewness = 0.0f, mean_skewness = 0.0f;
+        Histogram min_angle_histogram;       // [0, 90] 度
+        Histogram scaled_jacobian_histogram; // [-1, 1]
+        Histogram skewness_histogram;        // [0, 1]
+        std::vector<Mesh2D::Index> worst_faces; // 按 scaled Jacobian 从小到大
+    };
+
+    MeshQuality() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+
+    // 计算每个面的质量并生成报告；结果数组按面编号排列
+    void evaluate(const Mesh2D& mesh);
+
+    const Report& get_report() const { return report_; }
+    const std::vector<float>& get_min_angles() const { return min_angle_; }
+    const std::vector<float>& get_max_angles() const { return max_angle_; }
+    const std::vector<float>& get_aspect_ratios() const { return aspect_ratio_; }
+    const std::vector<float>& get_scaled_jacobians() const { return scaled_jacobian_; }
+    const std::vector<float>& get_skewness() const { return skewness_; }
+
+    void print_report(std::ostream& out) const;
+
+    // 不调用 acos 的四边形质量 (顶点逆时针)，供 Qmorph 的候选评估使用：
+    // 角度判断在余弦空间完成，通过判断后才用多项式近似把最大角换成角度。
+    // 非凸或翻转的四边形返回 0；其余与原来的角度质量一致：
+    // 最小角 < 25 度或最大角 > 165 度时为 0，否则为 1 - (最大角 - 90) / 75
+    static float quad_quality_fast(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4);
+
+    // 单个三角形或四边形 (n 个逆时针顶点) 的 scaled Jacobian：各角点处两条边夹角正弦的最小值，
+    // 三角形乘 2/√3 使等边三角形为 1；非凸或翻转时不大于 0。供光顺等局部优化逐点评估
+    static float element_scaled_jacobian(const glm::vec2* p, int n);
+
+private:
+    void evaluate_triangles(const Mesh2D& mesh, const Mesh2D::Index* faces, size_t count);
+    void evaluate_quads(const Mesh2D& mesh, const Mesh2D::Index* faces, size_t count);
+    void build_report(const Mesh2D& mesh);
+
+    Options options_;
+    Report report_;
+
+    // 按面编号的结果 (SoA)
+    std::vector<float> min_angle_, max_angle_;
+    std::vector<float> aspect_ratio_, scaled_jacobian_, skewness_;
+};
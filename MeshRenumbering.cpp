@@ -0,0 +1,266 @@
+#include "MeshRenumbering.h"
+#include "EdgeAdjacency.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+constexpr std::uint32_t kInvalid = Mesh2D::invalid_index;
+constexpr int kHilbertBits = 16;      // 每个坐标量化为 16 位，索引共 32 位
+constexpr int kPeripheralPasses = 8;  // 寻找伪外围点的最大 BFS 次数
+
+int bit_width(std::uint32_t v) {
+    int bits = 0;
+    while (v) {
+        ++bits;
+        v >>= 1;
+    }
+    return bits;
+}
+
+// (x, y) 在 2^16 x 2^16 网格上的 Hilbert 曲线序号
+std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y) {
+    const std::uint32_t n = 1u << kHilbertBits;
+    std::uint32_t d = 0;
+    for (std::uint32_t s = n >> 1; s > 0; s >>= 1) {
+        const std::uint32_t rx = (x & s) ? 1u : 0u;
+        const std::uint32_t ry = (y & s) ? 1u : 0u;
+        d += s * s * ((3u * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+template <typename Element, typename Visit>
+void for_each_element(const std::vector<Element>& elements, Visit visit) {
+    constexpr int n = Element::num_vertices;
+    unsigned int v[n];
+    for (const auto& e : elements) {
+        for (int k = 0; k < n; ++k) v[k] = e[k];
+        visit(v, n);
+    }
+}
+
+// 按最小顶点编号对单元做稳定排序
+template <typename Element>
+void sort_elements(std::vector<Element>& elements) {
+    std::vector<std::uint64_t> keys(elements.size());
+    std::vector<std::uint32_t> ids(elements.size());
+    std::uint32_t max_key = 0;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const Element& e = elements[i];
+        std::uint32_t m = e[0];
+        for (int k = 1; k < Element::num_vertices; ++k) m = std::min<std::uint32_t>(m, e[k]);
+        keys[i] = m;
+        ids[i] = static_cast<std::uint32_t>(i);
+        max_key = std::max(max_key, m);
+    }
+    radix_sort_pairs(keys, ids, std::max(1, bit_width(max_key)));
+    std::vector<Element> sorted(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) sorted[i] = elements[ids[i]];
+    elements.swap(sorted);
+}
+
+} // namespace
+
+bool MeshRenumbering::renumber(std::vector<glm::vec2>& vertices, std::vector<MeshTriangle>& triangles, std::vector<MeshQuad>& quads) {
+    SPHMESH_PROFILE_SCOPE("mesh.renumber");
+    report_ = Report();
+    if (triangles.empty() && quads.empty()) {
+        std::cerr << "Warning: Nothing to renumber, the mesh has no elements." << std::endl;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    const size_t num_verts = vertices.size();
+    compute_bandwidth(num_verts, triangles, quads, report_.bandwidth_before, report_.profile_before);
+
+    // 1. 顶点新顺序 (只含被单元引用的顶点)
+    build_adjacency(num_verts, triangles, quads);
+    std::vector<std::uint32_t> order;
+    if (options_.vertex_order == VertexOrder::Hilbert) order_hilbert(vertices, order);
+    else order_rcm(order);
+
+    new_index_.assign(num_verts, kInvalid);
+    for (size_t i = 0; i < order.size(); ++i) new_index_[order[i]] = static_cast<std::uint32_t>(i);
+    std::uint32_t next = static_cast<std::uint32_t>(order.size());
+    for (size_t v = 0; v < num_verts; ++v) {
+        if (new_index_[v] == kInvalid) new_index_[v] = next++;
+    }
+
+    // 2. 重排顶点并改写单元
+    std::vector<glm::vec2> permuted(num_verts);
+    for (size_t v = 0; v < num_verts; ++v) permuted[new_index_[v]] = vertices[v];
+    vertices.swap(permuted);
+    for (auto& t : triangles) {
+        t.v0 = new_index_[t.v0];
+        t.v1 = new_index_[t.v1];
+        t.v2 = new_index_[t.v2];
+    }
+    for (auto& q : quads) {
+        q.v0 = new_index_[q.v0];
+        q.v1 = new_index_[q.v1];
+        q.v2 = new_index_[q.v2];
+        q.v3 = new_index_[q.v3];
+    }
+
+    // 3. 单元按最小顶点编号排序
+    if (options_.sort_elements) {
+        sort_elements(triangles);
+        sort_elements(quads);
+    }
+
+    compute_bandwidth(num_verts, triangles, quads, report_.bandwidth_after, report_.profile_after);
+    report_.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Renumbering (" << (options_.vertex_order == VertexOrder::Hilbert ? "hilbert" : "rcm") << "): bandwidth "
+              << report_.bandwidth_before << " -> " << report_.bandwidth_after << ", profile "
+              << report_.profile_before << " -> " << report_.profile_after << ", " << report_.elapsed_ms << " ms." << std::endl;
+    return true;
+}
+
+void MeshRenumbering::compute_bandwidth(size_t num_vertices, const std::vector<MeshTriangle>& triangles,
+                                        const std::vector<MeshQuad>& quads, size_t& bandwidth, size_t& profile) {
+    // row_min[i]：与 i 同处一个单元的最小顶点编号 (含 i 自身)
+    std::vector<std::uint32_t> row_min(num_vertices, kInvalid);
+    bandwidth = 0;
+    auto visit = [&](const unsigned int* v, int n) {
+        std::uint32_t lo = v[0], hi = v[0];
+        for (int k = 1; k < n; ++k) {
+            lo = std::min<std::uint32_t>(lo, v[k]);
+            hi = std::max<std::uint32_t>(hi, v[k]);
+        }
+        bandwidth = std::max<size_t>(bandwidth, hi - lo);
+        for (int k = 0; k < n; ++k) row_min[v[k]] = std::min(row_min[v[k]], lo);
+    };
+    for_each_element(triangles, visit);
+    for_each_element(quads, visit);
+
+    profile = 0;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        if (row_min[i] != kInvalid) profile += i - row_min[i];
+    }
+}
+
+void MeshRenumbering::build_adjacency(size_t num_vertices, const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads) {
+    const int vbits = std::max(1, bit_width(static_cast<std::uint32_t>(num_vertices)));
+    std::vector<std::uint64_t> keys;
+    keys.reserve(triangles.size() * 6 + quads.size() * 12);
+    auto visit = [&](const unsigned int* v, int n) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                if (v[i] != v[j]) keys.push_back((static_cast<std::uint64_t>(v[i]) << vbits) | v[j]);
+            }
+        }
+    };
+    for_each_element(triangles, visit);
+    for_each_element(quads, visit);
+
+    // 排序后去重得到每个顶点的邻点 (CSR)
+    std::vector<std::uint32_t> payload(keys.size());
+    radix_sort_pairs(keys, payload, 2 * vbits);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    const std::uint64_t mask = (std::uint64_t(1) << vbits) - 1;
+    adj_start_.assign(num_vertices + 1, 0);
+    adj_.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        adj_start_[(keys[i] >> vbits) + 1]++;
+        adj_[i] = static_cast<std::uint32_t>(keys[i] & mask);
+    }
+    for (size_t v = 0; v < num_vertices; ++v) adj_start_[v + 1] += adj_start_[v];
+}
+
+void MeshRenumbering::order_hilbert(const std::vector<glm::vec2>& vertices, std::vector<std::uint32_t>& order) const {
+    const size_t num_verts = vertices.size();
+    glm::vec2 lo(0.0f), hi(0.0f);
+    bool first = true;
+    for (size_t v = 0; v < num_verts; ++v) {
+        if (adj_start_[v + 1] == adj_start_[v]) continue;
+        lo = first ? vertices[v] : glm::min(lo, vertices[v]);
+        hi = first ? vertices[v] : glm::max(hi, vertices[v]);
+        first = false;
+    }
+    // 两个方向使用相同的缩放，保持曲线的空间局部性
+    const float extent = std::max(hi.x - lo.x, hi.y - lo.y);
+    const float scale = extent > 0.0f ? static_cast<float>((1u << kHilbertBits) - 1) / extent : 0.0f;
+
+    std::vector<std::uint64_t> keys;
+    order.clear();
+    for (size_t v = 0; v < num_verts; ++v) {
+        if (adj_start_[v + 1] == adj_start_[v]) continue;
+        const std::uint32_t x = static_cast<std::uint32_t>((vertices[v].x - lo.x) * scale);
+        const std::uint32_t y = static_cast<std::uint32_t>((vertices[v].y - lo.y) * scale);
+        keys.push_back(hilbert_index(x, y));
+        order.push_back(static_cast<std::uint32_t>(v));
+    }
+    radix_sort_pairs(keys, order, 2 * kHilbertBits);
+}
+
+// 从 start 出发反复做 BFS，取最远一层中度数最小的顶点，直到离心率不再增加
+std::uint32_t MeshRenumbering::pseudo_peripheral(std::uint32_t start, std::vector<std::uint32_t>& level) const {
+    std::vector<std::uint32_t> queue;
+    std::uint32_t root = start, eccentricity = 0;
+    for (int pass = 0; pass < kPeripheralPasses; ++pass) {
+        queue.assign(1, root);
+        level[root] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const std::uint32_t u = queue[head];
+            for (std::uint32_t i = adj_start_[u]; i < adj_start_[u + 1]; ++i) {
+                const std::uint32_t w = adj_[i];
+                if (level[w] != kInvalid) continue;
+                level[w] = level[u] + 1;
+                queue.push_back(w);
+            }
+        }
+        const std::uint32_t depth = level[queue.back()];
+        std::uint32_t candidate = queue.back();
+        for (auto it = queue.rbegin(); it != queue.rend() && level[*it] == depth; ++it) {
+            if (adj_start_[*it + 1] - adj_start_[*it] < adj_start_[candidate + 1] - adj_start_[candidate]) candidate = *it;
+        }
+        for (auto u : queue) level[u] = kInvalid;
+        if (pass > 0 && depth <= eccentricity) break;
+        eccentricity = depth;
+        root = candidate;
+    }
+    return root;
+}
+
+void MeshRenumbering::order_rcm(std::vector<std::uint32_t>& order) const {
+    const size_t num_verts = adj_start_.size() - 1;
+    std::vector<std::uint32_t> level(num_verts, kInvalid);
+    std::vector<std::uint8_t> visited(num_verts, 0);
+    std::vector<std::uint32_t> neighbors;
+    order.clear();
+
+    auto degree = [&](std::uint32_t v) { return adj_start_[v + 1] - adj_start_[v]; };
+    for (std::uint32_t v = 0; v < num_verts; ++v) {
+        if (visited[v] || degree(v) == 0) continue;
+        // 每个连通分量从伪外围点开始做 Cuthill-McKee 遍历，邻点按度数从小到大入队
+        const std::uint32_t root = pseudo_peripheral(v, level);
+        size_t head = order.size();
+        order.push_back(root);
+        visited[root] = 1;
+        for (; head < order.size(); ++head) {
+            const std::uint32_t u = order[head];
+            neighbors.clear();
+            for (std::uint32_t i = adj_start_[u]; i < adj_start_[u + 1]; ++i) {
+                if (!visited[adj_[i]]) {
+                    visited[adj_[i]] = 1;
+                    neighbors.push_back(adj_[i]);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(), [&](std::uint32_t a, std::uint32_t b) {
+                return degree(a) != degree(b) ? degree(a) < degree(b) : a < b;
+            });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+}
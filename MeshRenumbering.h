@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "Mesh2D.h"
+
+// 输出网格的顶点与单元重新编号：
+// 顶点可按 Hilbert 曲线 (空间局部性，利于缓存) 或 RCM (Reverse Cuthill-McKee，减小矩阵带宽) 排序，
+// 单元再按其最小顶点编号排序，使遍历单元时访问的顶点也大致连续。
+// 邻接关系取单元内任意两个顶点 (与有限元矩阵的非零结构一致)，
+// 排序都用 radix_sort_pairs 完成，总代价 O(N log N) 以内
+class MeshRenumbering {
+public:
+    enum class VertexOrder {
+        Hilbert,
+        RCM
+    };
+
+    struct Options {
+        VertexOrder vertex_order = VertexOrder::RCM;
+        bool sort_elements = true;
+    };
+
+    struct Report {
+        size_t bandwidth_before = 0, bandwidth_after = 0; // 单元内顶点编号之差的最大值
+        size_t profile_before = 0, profile_after = 0;     // 每行第一个非零元到对角线的距离之和
+        double elapsed_ms = 0.0;
+    };
+
+    MeshRenumbering() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+    const Report& get_report() const { return report_; }
+    // new_index[旧编号] = 新编号
+    const std::vector<std::uint32_t>& get_permutation() const { return new_index_; }
+
+    // 原地重排顶点数组，并改写三角形、四边形中的顶点编号与单元顺序；
+    // 未被任何单元引用的顶点保持相对顺序放在最后
+    bool renumber(std::vector<glm::vec2>& vertices, std::vector<MeshTriangle>& triangles, std::vector<MeshQuad>& quads);
+
+    static void compute_bandwidth(size_t num_vertices, const std::vector<MeshTriangle>& triangles,
+                                  const std::vector<MeshQuad>& quads, size_t& bandwidth, size_t& profile);
+
+private:
+    void build_adjacency(size_t num_vertices, const std::vector<MeshTriangle>& triangles, const std::vector<MeshQuad>& quads);
+    void order_hilbert(const std::vector<glm::vec2>& vertices, std::vector<std::uint32_t>& order) const;
+    void order_rcm(std::vector<std::uint32_t>& order) const;
+    std::uint32_t pseudo_peripheral(std::uint32_t start, std::vector<std::uint32_t>& level) const;
+
+    Options options_;
+    Report report_;
+    std::vector<std::uint32_t> new_index_;
+    // 顶点邻接 (CSR)
+    std::vector<std::uint32_t> adj_start_, adj_;
+};
@@ -0,0 +1,267 @@
+#include "MeshSmoother.h"
+#include "MeshQuality.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+constexpr int kMaxFaceSize = 4;
+constexpr int kSearchSteps = 8; // 优化方式中模式搜索的步长减半次数
+
+} // namespace
+
+bool MeshSmoother::smooth(Mesh2D& mesh) {
+    SPHMESH_PROFILE_SCOPE("mesh.smooth");
+    stats_ = Stats();
+    if (mesh.empty()) {
+        std::cerr << "Warning: Nothing to smooth, the mesh is empty." << std::endl;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    build_topology(mesh);
+    color_vertices(mesh);
+    stats_.colors = color_start_.size() - 1;
+
+    float min_quality = 0.0f, mean_quality = 0.0f;
+    mesh_quality(mesh, min_quality, mean_quality);
+    stats_.initial_min_quality = min_quality;
+    stats_.initial_mean_quality = mean_quality;
+
+    int plateau = 0;
+    for (int iteration = 0; iteration < options_.max_iterations; ++iteration) {
+        std::atomic<size_t> moved(0);
+        // 同色顶点不共享任何面，同时移动它们不会互相读写
+        for (size_t c = 0; c + 1 < color_start_.size(); ++c) {
+            TaskScheduler::instance().parallel_for(color_start_[c], color_start_[c + 1], 256, [&](size_t lo, size_t hi) {
+                size_t local = 0;
+                for (size_t i = lo; i < hi; ++i) {
+                    const Index v = color_verts_[i];
+                    const bool ok = (options_.method == Method::Optimization) ? optimize_vertex(mesh, v) : relax_vertex(mesh, v);
+                    if (ok) ++local;
+                }
+                moved += local;
+            });
+        }
+        stats_.iterations = iteration + 1;
+        stats_.moved += moved;
+
+        // 平台期判断
+        const float previous_mean = mean_quality;
+        mesh_quality(mesh, min_quality, mean_quality);
+        if (moved == 0) break;
+        if (mean_quality - previous_mean < options_.plateau_tolerance) {
+            if (++plateau >= options_.plateau_iterations) break;
+        }
+        else {
+            plateau = 0;
+        }
+    }
+
+    stats_.final_min_quality = min_quality;
+    stats_.final_mean_quality = mean_quality;
+    stats_.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const char* method_name = options_.method == Method::AngleBased ? "angle-based"
+                            : (options_.method == Method::Optimization ? "optimization" : "laplacian");
+    std::cout << "Smoothing (" << method_name << "): " << stats_.iterations << " iterations, "
+              << stats_.colors << " colors, min scaled Jacobian " << stats_.initial_min_quality << " -> " << stats_.final_min_quality
+              << ", mean " << stats_.initial_mean_quality << " -> " << stats_.final_mean_quality
+              << ", " << stats_.elapsed_ms << " ms." << std::endl;
+    return true;
+}
+
+void MeshSmoother::build_topology(const Mesh2D& mesh) {
+    const Index num_verts = static_cast<Index>(mesh.get_num_vertices());
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    const Index num_half = static_cast<Index>(mesh.get_num_half_edges());
+
+    // 1. 边界顶点：任意一条边界半边的两个端点 (非流形顶点也能识别)
+    fixed_.assign(num_verts, 1);
+    for (Index h = 0; h < num_half; ++h) fixed_[mesh.origin(h)] = 0;
+    for (Index h = 0; h < num_half; ++h) {
+        if (mesh.is_boundary_edge(h)) {
+            fixed_[mesh.origin(h)] = 1;
+            fixed_[mesh.target(h)] = 1;
+        }
+    }
+
+    // 2. 顶点 -> 关联面
+    face_start_.assign(num_verts + 1, 0);
+    for (Index h = 0; h < num_half; ++h) face_start_[mesh.origin(h) + 1]++;
+    for (Index v = 0; v < num_verts; ++v) face_start_[v + 1] += face_start_[v];
+    vert_faces_.resize(num_half);
+    std::vector<Index> fill(face_start_.begin(), face_start_.end() - 1);
+    for (Index f = 0; f < num_faces; ++f) {
+        for (Index k = 0; k < mesh.face_size(f); ++k) vert_faces_[fill[mesh.face_vertex(f, k)]++] = f;
+    }
+
+    // 3. 内部顶点的边邻点：每条出半边的终点。内部顶点的出半边都有对边，
+    //    半边所在面中 N 的下一个顶点、对边所在面中 N 的上一个顶点即为 N 处两条单元边的另一端
+    ring_start_.assign(num_verts + 1, 0);
+    for (Index h = 0; h < num_half; ++h) {
+        if (!fixed_[mesh.origin(h)]) ring_start_[mesh.origin(h) + 1]++;
+    }
+    for (Index v = 0; v < num_verts; ++v) ring_start_[v + 1] += ring_start_[v];
+    ring_.resize(ring_start_[num_verts]);
+    wings_.resize(ring_start_[num_verts]);
+    fill.assign(ring_start_.begin(), ring_start_.end() - 1);
+    for (Index h = 0; h < num_half; ++h) {
+        if (fixed_[mesh.origin(h)]) continue;
+        const Index k = fill[mesh.origin(h)]++;
+        ring_[k] = mesh.target(h);
+        wings_[k] = { mesh.target(mesh.next(h)), mesh.origin(mesh.prev(mesh.twin(h))) };
+    }
+}
+
+void MeshSmoother::color_vertices(const Mesh2D& mesh) {
+    const Index num_verts = static_cast<Index>(mesh.get_num_vertices());
+    std::vector<int> color(num_verts, -1);
+    std::vector<Index> used_by; // used_by[c] == v 表示颜色 c 已被 v 的某个邻点占用
+    int num_colors = 0;
+
+    // 贪心着色：邻接关系为 "共享一个面"，只给可移动的顶点着色
+    for (Index v = 0; v < num_verts; ++v) {
+        if (fixed_[v]) continue;
+        for (Index i = face_start_[v]; i < face_start_[v + 1]; ++i) {
+            const Index f = vert_faces_[i];
+            for (Index k = 0; k < mesh.face_size(f); ++k) {
+                const int c = color[mesh.face_vertex(f, k)];
+                if (c >= 0) used_by[c] = v;
+            }
+        }
+        int c = 0;
+        while (c < num_colors && used_by[c] == v) ++c;
+        if (c == num_colors) {
+            used_by.push_back(Mesh2D::invalid_index);
+            ++num_colors;
+        }
+        color[v] = c;
+    }
+
+    color_start_.assign(num_colors + 1, 0);
+    for (Index v = 0; v < num_verts; ++v) {
+        if (color[v] >= 0) color_start_[color[v] + 1]++;
+    }
+    for (int c = 0; c < num_colors; ++c) color_start_[c + 1] += color_start_[c];
+    color_verts_.resize(color_start_[num_colors]);
+    std::vector<Index> fill(color_start_.begin(), color_start_.end() - 1);
+    for (Index v = 0; v < num_verts; ++v) {
+        if (color[v] >= 0) color_verts_[fill[color[v]]++] = v;
+    }
+}
+
+float MeshSmoother::local_quality(const Mesh2D& mesh, Index v, const glm::vec2& p) const {
+    float quality = 1.0f;
+    glm::vec2 corners[kMaxFaceSize];
+    for (Index i = face_start_[v]; i < face_start_[v + 1]; ++i) {
+        const Index f = vert_faces_[i];
+        const int n = static_cast<int>(std::min<Index>(mesh.face_size(f), kMaxFaceSize));
+        for (int k = 0; k < n; ++k) {
+            const Index u = mesh.face_vertex(f, k);
+            corners[k] = (u == v) ? p : mesh.position(u);
+        }
+        quality = std::min(quality, MeshQuality::element_scaled_jacobian(corners, n));
+    }
+    return quality;
+}
+
+glm::vec2 MeshSmoother::laplacian_target(const Mesh2D& mesh, Index v) const {
+    glm::vec2 sum(0.0f);
+    for (Index i = ring_start_[v]; i < ring_start_[v + 1]; ++i) sum += mesh.position(ring_[i]);
+    return sum / static_cast<float>(ring_start_[v + 1] - ring_start_[v]);
+}
+
+// 对每个边邻点 N，把 v 绕 N 旋转到边 v-N 两侧单元在 N 处的另外两条边的夹角平分线上，取所有结果的平均。
+// 四边形中这两条边连向对角顶点，而不是 v 的相邻边邻点
+glm::vec2 MeshSmoother::angle_based_target(const Mesh2D& mesh, Index v) const {
+    const glm::vec2 p = mesh.position(v);
+    const Index begin = ring_start_[v], end = ring_start_[v + 1];
+    glm::vec2 sum(0.0f);
+    for (Index i = begin; i < end; ++i) {
+        const glm::vec2 n = mesh.position(ring_[i]);
+        const glm::vec2 a = mesh.position(wings_[i].first) - n;
+        const glm::vec2 b = mesh.position(wings_[i].second) - n;
+        const glm::vec2 d = p - n;
+        const float la = glm::length(a), lb = glm::length(b), ld = glm::length(d);
+        if (la <= 0.0f || lb <= 0.0f || ld <= 0.0f) {
+            sum += p;
+            continue;
+        }
+        glm::vec2 bisector = a / la + b / lb;
+        const float lbis = glm::length(bisector);
+        // 两条邻边反向时平分线取其垂线，方向朝向 v 所在一侧
+        bisector = (lbis > 1e-6f) ? bisector / lbis : glm::vec2(-a.y, a.x) / la;
+        if (glm::dot(bisector, d) < 0.0f) bisector = -bisector;
+        sum += n + bisector * ld;
+    }
+    return sum / static_cast<float>(end - begin);
+}
+
+// Laplacian 与基于角度的方式：向目标点移动，质量下降时依次尝试一半、四分之一的步长
+bool MeshSmoother::relax_vertex(Mesh2D& mesh, Index v) const {
+    if (ring_start_[v + 1] == ring_start_[v]) return false;
+    const glm::vec2 p = mesh.position(v);
+    const glm::vec2 target = (options_.method == Method::AngleBased) ? angle_based_target(mesh, v) : laplacian_target(mesh, v);
+    const float current = local_quality(mesh, v, p);
+    glm::vec2 step = target - p;
+    for (int attempt = 0; attempt < 3; ++attempt, step *= 0.5f) {
+        const glm::vec2 q = p + step;
+        if (local_quality(mesh, v, q) >= current && q != p) {
+            mesh.set_position(v, q);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 优化方式：从当前位置出发做坐标方向的模式搜索，最大化关联单元的最小 scaled Jacobian
+bool MeshSmoother::optimize_vertex(Mesh2D& mesh, Index v) const {
+    if (ring_start_[v + 1] == ring_start_[v]) return false;
+    glm::vec2 p = mesh.position(v);
+    float best = local_quality(mesh, v, p);
+    const float initial = best;
+    if (initial >= options_.optimization_threshold) return false;
+
+    float step = 0.0f;
+    for (Index i = ring_start_[v]; i < ring_start_[v + 1]; ++i) step += glm::length(mesh.position(ring_[i]) - p);
+    step *= 0.25f / static_cast<float>(ring_start_[v + 1] - ring_start_[v]);
+
+    const glm::vec2 directions[4] = { glm::vec2(1.0f, 0.0f), glm::vec2(-1.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec2(0.0f, -1.0f) };
+    for (int s = 0; s < kSearchSteps; ++s) {
+        bool improved = false;
+        for (const auto& dir : directions) {
+            const glm::vec2 q = p + dir * step;
+            const float quality = local_quality(mesh, v, q);
+            if (quality > best) {
+                best = quality;
+                p = q;
+                improved = true;
+            }
+        }
+        if (!improved) step *= 0.5f;
+    }
+    if (best <= initial) return false;
+    mesh.set_position(v, p);
+    return true;
+}
+
+void MeshSmoother::mesh_quality(const Mesh2D& mesh, float& min_quality, float& mean_quality) const {
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    glm::vec2 corners[kMaxFaceSize];
+    double sum = 0.0;
+    min_quality = 1.0f;
+    for (Index f = 0; f < num_faces; ++f) {
+        const int n = static_cast<int>(std::min<Index>(mesh.face_size(f), kMaxFaceSize));
+        for (int k = 0; k < n; ++k) corners[k] = mesh.position(mesh.face_vertex(f, k));
+        const float quality = MeshQuality::element_scaled_jacobian(corners, n);
+        min_quality = std::min(min_quality, quality);
+        sum += quality;
+    }
+    mean_quality = num_faces ? static_cast<float>(sum / num_faces) : 0.0f;
+}
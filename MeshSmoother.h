@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <glm/glm.hpp>
+#include "Mesh2D.h"
+
+// Q-Morph 之后的网格光顺：只移动内部顶点，边界顶点保持不动。
+// 三种方式：受约束的 Laplacian (邻点平均)、基于角度 (Zhou-Shimada，使每条邻边平分相邻夹角)、
+// 基于优化 (局部模式搜索，最大化关联单元的最小 scaled Jacobian，也可用于解开翻转单元)。
+// 每次移动只有在关联单元的最小质量不下降时才接受。
+// 顶点按 "共享一个面" 的关系着色，同色顶点互不影响，可以在共享的任务池上同时更新；
+// 每轮结束后统计平均质量，提升进入平台期时提前停止
+class MeshSmoother {
+public:
+    using Index = Mesh2D::Index;
+
+    enum class Method {
+        Laplacian,
+        AngleBased,
+        Optimization
+    };
+
+    struct Options {
+        Method method = Method::Laplacian;
+        int max_iterations = 20;
+        float plateau_tolerance = 1e-3f; // 一轮的平均 scaled Jacobian 提升低于该值视为平台期
+        int plateau_iterations = 2;      // 连续多少轮处于平台期后停止
+        float optimization_threshold = 0.6f; // 基于优化的方式只处理关联单元最小质量低于该值的顶点
+    };
+
+    struct Stats {
+        int iterations = 0;
+        size_t colors = 0;
+        size_t moved = 0;                // 所有轮次中被接受的移动次数
+        float initial_min_quality = 0.0f, final_min_quality = 0.0f;   // 最小 scaled Jacobian
+        float initial_mean_quality = 0.0f, final_mean_quality = 0.0f; // 平均 scaled Jacobian
+        double elapsed_ms = 0.0;
+    };
+
+    MeshSmoother() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+    const Options& get_options() const { return options_; }
+    const Stats& get_stats() const { return stats_; }
+
+    // 原地修改 mesh 的顶点坐标，返回是否做了光顺 (空网格返回 false)
+    bool smooth(Mesh2D& mesh);
+
+private:
+    void build_topology(const Mesh2D& mesh);
+    void color_vertices(const Mesh2D& mesh);
+
+    // 顶点 v 移动到 p 后关联单元的最小 scaled Jacobian
+    float local_quality(const Mesh2D& mesh, Index v, const glm::vec2& p) const;
+    glm::vec2 laplacian_target(const Mesh2D& mesh, Index v) const;
+    glm::vec2 angle_based_target(const Mesh2D& mesh, Index v) const;
+    bool relax_vertex(Mesh2D& mesh, Index v) const;
+    bool optimize_vertex(Mesh2D& mesh, Index v) const;
+    void mesh_quality(const Mesh2D& mesh, float& min_quality, float& mean_quality) const;
+
+    Options options_;
+    Stats stats_;
+
+    std::vector<std::uint8_t> fixed_;   // 边界或孤立顶点
+    // CSR：顶点的关联面、边邻点
+    std::vector<Index> face_start_, vert_faces_;
+    std::vector<Index> ring_start_, ring_;
+    // 与 ring_ 一一对应：边 v-N 两侧的单元在 N 处的另一条边的端点 (三角形为相邻的边邻点，四边形为对角顶点)
+    std::vector<std::pair<Index, Index>> wings_;
+    // 同色顶点列表 (CSR)
+    std::vector<Index> color_start_, color_verts_;
+};
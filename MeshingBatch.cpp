@@ -0,0 +1,199 @@
+#include "MeshingBatch.h"
+#include "BoundaryImporter.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double ring_area(const std::vector<glm::vec2>& ring) {
+    double area = 0.0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        area += static_cast<double>(ring[j].x) * ring[i].y - static_cast<double>(ring[i].x) * ring[j].y;
+    }
+    return std::fabs(area) * 0.5;
+}
+
+void write_result_header(std::ostream& out) {
+    out << "input,output,ok,boundary_vertices,particles,steps,converged,triangles,quads,remaining_triangles,"
+           "load_ms,relax_ms,triangulate_ms,quad_ms,smooth_ms,renumber_ms,export_ms,total_ms\n";
+}
+
+void write_result(std::ostream& out, const MeshingBatch::Job& job) {
+    const MeshingPipeline::Stats& s = job.stats;
+    out << job.input << ',' << job.output << ',' << (job.ok ? 1 : 0) << ',' << s.boundary_vertices << ','
+        << s.particles << ',' << s.steps << ',' << (s.converged ? 1 : 0) << ',' << s.triangles << ','
+        << s.quads << ',' << s.remaining_triangles << ',' << s.load_ms << ',' << s.relax_ms << ','
+        << s.triangulate_ms << ',' << s.quad_ms << ',' << s.smooth_ms << ',' << s.renumber_ms << ','
+        << s.export_ms << ',' << s.total_ms << '\n';
+    out.flush();
+}
+
+} // namespace
+
+double MeshingBatch::estimate_particles(const std::vector<glm::vec2>& outer, const std::vector<std::vector<glm::vec2>>& holes) {
+    if (outer.size() < 3) return 0.0;
+    glm::vec2 lo = outer.front(), hi = outer.front();
+    for (const auto& p : outer) {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    const double cell = (hi.x - lo.x) / 80.0;
+    if (cell <= 0.0) return 0.0;
+    double area = ring_area(outer);
+    for (const auto& hole : holes) {
+        if (hole.size() >= 3) area -= ring_area(hole);
+    }
+    return std::max(0.0, area) / (cell * cell);
+}
+
+std::string MeshingBatch::default_output(const std::string& input) const {
+    const size_t slash = input.find_last_of("/\\");
+    const std::string dir = slash == std::string::npos ? std::string() : input.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? input : input.substr(slash + 1);
+    const size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) name.resize(dot);
+    if (options_.output_dir.empty()) return dir + name + options_.output_extension;
+    const char last = options_.output_dir.back();
+    const std::string sep = (last == '/' || last == '\\') ? "" : "/";
+    return options_.output_dir + sep + name + options_.output_extension;
+}
+
+void MeshingBatch::add_job(const std::string& input, const std::string& output) {
+    Job job;
+    job.input = input;
+    job.output = output.empty() ? default_output(input) : output;
+    jobs_.push_back(std::move(job));
+}
+
+bool MeshingBatch::load_manifest(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open manifest " << path << std::endl;
+        return false;
+    }
+    const size_t before = jobs_.size();
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos || line[begin] == '#') continue;
+        const size_t input_end = line.find_first_of(" \t\r", begin);
+        const std::string input = line.substr(begin, input_end - begin);
+        std::string output;
+        if (input_end != std::string::npos) {
+            const size_t output_begin = line.find_first_not_of(" \t\r", input_end);
+            if (output_begin != std::string::npos) {
+                output = line.substr(output_begin, line.find_first_of(" \t\r", output_begin) - output_begin);
+            }
+        }
+        add_job(input, output);
+    }
+    std::cout << "Manifest " << path << ": " << (jobs_.size() - before) << " jobs." << std::endl;
+    return true;
+}
+
+bool MeshingBatch::run() {
+    stats_ = Stats();
+    stats_.jobs = jobs_.size();
+    if (jobs_.empty()) {
+        std::cerr << "Warning: The batch has no jobs." << std::endl;
+        return true;
+    }
+    const auto start = Clock::now();
+    // 同时运行的作业数不超过任务池的线程数，避免超额订阅；多出的任务池线程参与作业内部的并行计算
+    auto& scheduler = TaskScheduler::instance();
+    unsigned int num_workers = options_.num_workers ? options_.num_workers : scheduler.get_num_threads();
+    num_workers = std::min(num_workers, scheduler.get_num_threads());
+    num_workers = static_cast<unsigned int>(std::min<size_t>(std::max(1u, num_workers), jobs_.size()));
+
+    // 1. 并行读取边界并估算代价：松弛的力计算是粒子两两配对，代价按粒子数的平方计
+    std::vector<BoundaryImporter::Result> boundaries(jobs_.size());
+    std::vector<double> load_ms(jobs_.size(), 0.0);
+    scheduler.parallel_for(0, jobs_.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            const auto load_start = Clock::now();
+            if (BoundaryImporter::load(jobs_[i].input, boundaries[i], options_.pipeline.import)) {
+                const double particles = estimate_particles(boundaries[i].outer, boundaries[i].holes);
+                jobs_[i].estimated_cost = particles * particles;
+            }
+            else {
+                boundaries[i] = BoundaryImporter::Result();
+            }
+            load_ms[i] = elapsed_ms(load_start);
+        }
+    });
+
+    // 2. 代价从大到小排序后分派，避免最大的作业最后才开始而拖长整批的耗时
+    std::vector<size_t> order(jobs_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return jobs_[a].estimated_cost > jobs_[b].estimated_cost;
+    });
+
+    std::ofstream results;
+    if (!options_.results_path.empty()) {
+        results.open(options_.results_path);
+        if (!results.is_open()) {
+            std::cerr << "Error: Cannot write results to " << options_.results_path << std::endl;
+            return false;
+        }
+        write_result_header(results);
+    }
+
+    // 3. num_workers 个作业通道，每个通道复用一个流水线对象，按 order 的顺序领取下一个作业
+    std::mutex result_mutex;
+    size_t finished = 0;
+    std::atomic<size_t> next(0);
+    auto run_job = [&](MeshingPipeline& pipeline, size_t k) {
+        Job& job = jobs_[order[k]];
+        BoundaryImporter::Result& boundary = boundaries[order[k]];
+        if (boundary.outer.empty()) {
+            job.ok = false;
+            job.stats = MeshingPipeline::Stats();
+        }
+        else {
+            pipeline.set_options(options_.pipeline);
+            job.ok = pipeline.run(std::move(boundary.outer), std::move(boundary.holes), job.output);
+            job.stats = pipeline.get_stats();
+        }
+        job.stats.load_ms = load_ms[order[k]];
+        job.stats.total_ms += job.stats.load_ms;
+
+        std::lock_guard<std::mutex> lock(result_mutex);
+        ++finished;
+        if (job.ok) ++stats_.succeeded;
+        else ++stats_.failed;
+        if (results.is_open()) write_result(results, job);
+        std::cout << "[" << finished << "/" << jobs_.size() << "] " << job.input << (job.ok ? " -> " + job.output : " failed")
+                  << " (" << job.stats.quads << " quads, " << job.stats.total_ms << " ms)" << std::endl;
+    };
+    // 作业通道运行在独立的线程上 (第一个通道用调用线程)，不放进任务池：
+    // 等待并行子任务的线程会从任务池的外部队列帮忙执行任务，若通道也在那里，
+    // 一个作业内部可能接手另一个通道并跑完剩下的作业，外层作业一直无法结束
+    auto lane = [&] {
+        MeshingPipeline pipeline;
+        for (size_t k = next++; k < order.size(); k = next++) run_job(pipeline, k);
+    };
+    std::vector<std::thread> lanes;
+    for (unsigned int k = 1; k < num_workers; ++k) lanes.emplace_back(lane);
+    lane();
+    for (auto& t : lanes) t.join();
+
+    stats_.elapsed_ms = elapsed_ms(start);
+    std::cout << "Batch complete: " << stats_.succeeded << " of " << stats_.jobs << " jobs succeeded on "
+              << num_workers << " workers, " << stats_.elapsed_ms << " ms." << std::endl;
+    return stats_.failed == 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+#include "MeshingPipeline.h"
+
+// 批处理：一个进程内并发地为清单中的多个边界生成网格。
+// 先并行读取所有边界并估算规模，再按估算代价从大到小分派到若干作业通道上 (最长作业优先)，作业内部的并行计算共享任务池，
+// 每个作业完成后立即导出网格并追加一行结果，不等待整批结束
+class MeshingBatch {
+public:
+    struct Options {
+        MeshingPipeline::Options pipeline;
+        unsigned int num_workers = 0;           // 同时运行的作业数，0 或超过任务池线程数时取任务池线程数
+        std::string output_dir;                 // 清单未给出输出路径时，网格写到该目录 (空则与输入同目录)
+        std::string output_extension = ".msh"; // 同上，决定导出格式
+        std::string results_path;               // 每个作业一行的 CSV 结果，空表示不写
+    };
+
+    struct Job {
+        std::string input, output;
+        double estimated_cost = 0.0; // 松弛的估算代价 (粒子数的平方)
+        bool ok = false;
+        MeshingPipeline::Stats stats;
+    };
+
+    struct Stats {
+        size_t jobs = 0, succeeded = 0, failed = 0;
+        double elapsed_ms = 0.0;
+    };
+
+    MeshingBatch() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+    const Options& get_options() const { return options_; }
+
+    // 清单每行一个作业："输入文件 [输出文件]"，空行与 # 开头的行被忽略
+    bool load_manifest(const std::string& path);
+    void add_job(const std::string& input, const std::string& output = std::string());
+
+    // 运行全部作业，全部成功时返回 true
+    bool run();
+
+    const std::vector<Job>& get_jobs() const { return jobs_; }
+    const Stats& get_stats() const { return stats_; }
+
+    // 估算粒子数：背景网格单元为包围盒宽度的 1/80，目标尺寸与单元同量级，粒子数约为面积 / 单元面积
+    static double estimate_particles(const std::vector<glm::vec2>& outer, const std::vector<std::vector<glm::vec2>>& holes);
+
+private:
+    std::string default_output(const std::string& input) const;
+
+    Options options_;
+    std::vector<Job> jobs_;
+    Stats stats_;
+};
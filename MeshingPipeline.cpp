@@ -0,0 +1,157 @@
+#include "MeshingPipeline.h"
+#include "Boundary.h"
+#include "Simulation2D.h"
+#include "CGALMeshGenerator.h"
+#include "MeshExporter.h"
+#include "MeshQuality.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+bool MeshingPipeline::run(const std::string& input, const std::string& output) {
+    stats_ = Stats();
+    auto start = Clock::now();
+    BoundaryImporter::Result imported;
+    if (!BoundaryImporter::load(input, imported, options_.import)) return false;
+    const double load_ms = elapsed_ms(start);
+    const bool ok = run(std::move(imported.outer), std::move(imported.holes), output);
+    stats_.load_ms = load_ms;
+    stats_.total_ms += load_ms;
+    return ok;
+}
+
+bool MeshingPipeline::run(std::vector<glm::vec2> outer, std::vector<std::vector<glm::vec2>> holes, const std::string& output) {
+    stats_ = Stats();
+    vertices_.clear();
+    triangles_.clear();
+    quads_.clear();
+    if (outer.size() < 3) {
+        std::cerr << "Error: The boundary needs at least 3 vertices." << std::endl;
+        return false;
+    }
+    stats_.boundary_vertices = outer.size();
+    for (const auto& hole : holes) stats_.boundary_vertices += hole.size();
+    auto total_start = Clock::now();
+
+    // 1. 粒子松弛至收敛
+    auto start = Clock::now();
+    Boundary boundary(std::move(outer), std::move(holes));
+    Simulation2D sim(boundary);
+    float peak_energy = 0.0f, last_energy = -1.0f;
+    for (int step = 1; step <= options_.max_steps; ++step) {
+        sim.step();
+        stats_.steps = step;
+        if (step % std::max(1, options_.check_interval) != 0) continue;
+        const float energy = sim.get_kinetic_energy();
+        peak_energy = std::max(peak_energy, energy);
+        if (step >= options_.min_steps) {
+            const bool settled = energy <= options_.energy_ratio * peak_energy;
+            const bool plateau = last_energy > 0.0f && std::fabs(energy - last_energy) <= options_.plateau_tolerance * last_energy;
+            if (settled || plateau) {
+                stats_.converged = true;
+                break;
+            }
+        }
+        last_energy = energy;
+    }
+    stats_.particles = sim.get_particles().size();
+    stats_.relax_ms = elapsed_ms(start);
+    if (!stats_.converged) {
+        std::cerr << "Warning: Relaxation stopped at " << stats_.steps << " steps without converging." << std::endl;
+    }
+
+    // 2. 三角剖分
+    start = Clock::now();
+    CGALMeshGenerator generator;
+    generator.generate_mesh(sim.get_particles(), boundary);
+    stats_.triangulate_ms = elapsed_ms(start);
+    stats_.triangles = generator.get_triangles().size();
+    if (generator.get_triangles().empty()) {
+        std::cerr << "Error: Triangulation produced no triangles." << std::endl;
+        return false;
+    }
+
+    // 3. 四边形转换
+    start = Clock::now();
+    if (options_.convert_quads) {
+        Qmorph qmorph;
+        qmorph.set_mode(options_.quad_mode);
+        qmorph.set_all_quad(options_.all_quad);
+        auto result = qmorph.run(generator);
+        vertices_ = result.vertices.empty() ? generator.get_vertices() : std::move(result.vertices);
+        triangles_ = std::move(result.remaining_triangles);
+        quads_ = std::move(result.quads);
+    }
+    else {
+        vertices_ = generator.get_vertices();
+        triangles_ = generator.get_triangles();
+    }
+    stats_.quad_ms = elapsed_ms(start);
+
+    // 4. 光顺
+    start = Clock::now();
+    if (options_.smooth) {
+        Mesh2D mesh;
+        mesh.build(vertices_, triangles_, quads_);
+        MeshSmoother smoother;
+        MeshSmoother::Options smooth_options;
+        smooth_options.method = options_.smooth_method;
+        smoother.set_options(smooth_options);
+        if (smoother.smooth(mesh)) vertices_ = mesh.get_positions();
+    }
+    stats_.smooth_ms = elapsed_ms(start);
+
+    // 5. 重新编号
+    start = Clock::now();
+    if (options_.renumber) {
+        MeshRenumbering renumbering;
+        MeshRenumbering::Options renumber_options;
+        renumber_options.vertex_order = options_.vertex_order;
+        renumbering.set_options(renumber_options);
+        renumbering.renumber(vertices_, triangles_, quads_);
+    }
+    stats_.renumber_ms = elapsed_ms(start);
+    stats_.quads = quads_.size();
+    stats_.remaining_triangles = triangles_.size();
+
+    if (options_.report_quality) {
+        Mesh2D mesh;
+        mesh.build(vertices_, triangles_, quads_);
+        MeshQuality quality;
+        quality.evaluate(mesh);
+        quality.print_report(std::cout);
+    }
+
+    // 6. 导出
+    start = Clock::now();
+    bool ok = true;
+    if (!output.empty()) ok = MeshExporter::save(output, vertices_, triangles_, quads_);
+    stats_.export_ms = elapsed_ms(start);
+    stats_.total_ms = elapsed_ms(total_start);
+    return ok;
+}
+
+void MeshingPipeline::print_stats(std::ostream& out) const {
+    const Stats& s = stats_;
+    out << "Stage times (ms):" << std::endl;
+    out << "  load        " << s.load_ms << std::endl;
+    out << "  relax       " << s.relax_ms << " (" << s.steps << " steps, " << s.particles << " particles"
+        << (s.converged ? ", converged" : ", not converged") << ")" << std::endl;
+    out << "  triangulate " << s.triangulate_ms << " (" << s.triangles << " triangles)" << std::endl;
+    out << "  quads       " << s.quad_ms << " (" << s.quads << " quads, " << s.remaining_triangles << " triangles)" << std::endl;
+    out << "  smooth      " << s.smooth_ms << std::endl;
+    out << "  renumber    " << s.renumber_ms << std::endl;
+    out << "  export      " << s.export_ms << std::endl;
+    out << "  total       " << s.total_ms << std::endl;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <ostream>
+#include <glm/glm.hpp>
+#include "BoundaryImporter.h"
+#include "Mesh2D.h"
+#include "MeshRenumbering.h"
+#include "MeshSmoother.h"
+#include "Qmorph.h"
+
+// 无界面的完整网格生成流程：读取边界 -> 粒子松弛至收敛 -> CGAL 三角剖分 -> Q-Morph 四边形转换
+// -> 光顺 -> 重新编号 -> 导出。不依赖 GLFW/GLAD/着色器，供命令行与批处理使用；
+// 每个阶段单独计时
+class MeshingPipeline {
+public:
+    struct Options {
+        BoundaryImporter::Options import;
+
+        // 松弛：每隔 check_interval 步检查一次动能，动能降到峰值的 energy_ratio 以下，
+        // 或相邻两次检查的相对变化小于 plateau_tolerance 时视为收敛
+        int min_steps = 200;
+        int max_steps = 5000;
+        int check_interval = 50;
+        float energy_ratio = 0.01f;
+        float plateau_tolerance = 1e-3f;
+
+        Qmorph::Mode quad_mode = Qmorph::Mode::Matching;
+        bool all_quad = true; // 见 Qmorph::set_all_quad
+        bool convert_quads = true;
+        bool smooth = true;
+        MeshSmoother::Method smooth_method = MeshSmoother::Method::Laplacian;
+        bool renumber = true;
+        MeshRenumbering::VertexOrder vertex_order = MeshRenumbering::VertexOrder::RCM;
+        bool report_quality = false;
+    };
+
+    // 各阶段耗时 (毫秒) 与规模统计
+    struct Stats {
+        double load_ms = 0.0, relax_ms = 0.0, triangulate_ms = 0.0, quad_ms = 0.0;
+        double smooth_ms = 0.0, renumber_ms = 0.0, export_ms = 0.0, total_ms = 0.0;
+        int steps = 0;
+        bool converged = false;
+        size_t boundary_vertices = 0, particles = 0;
+        size_t triangles = 0, quads = 0, remaining_triangles = 0;
+    };
+
+    MeshingPipeline() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+    const Options& get_options() const { return options_; }
+    const Stats& get_stats() const { return stats_; }
+
+    // 从文件读取边界并运行；output 为空时不导出 (格式由扩展名决定，见 MeshExporter)
+    bool run(const std::string& input, const std::string& output);
+    // 直接使用给定的外环与孔洞
+    bool run(std::vector<glm::vec2> outer, std::vector<std::vector<glm::vec2>> holes, const std::string& output);
+
+    // 最终网格
+    const std::vector<glm::vec2>& get_vertices() const { return vertices_; }
+    const std::vector<MeshTriangle>& get_triangles() const { return triangles_; }
+    const std::vector<MeshQuad>& get_quads() const { return quads_; }
+
+    void print_stats(std::ostream& out) const;
+
+private:
+    Options options_;
+    Stats stats_;
+    std::vector<glm::vec2> vertices_;
+    std::vector<MeshTriangle> triangles_;
+    std::vector<MeshQuad> quads_;
+};
@@ -0,0 +1,87 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::add_time(const char* name, double ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Phase& phase = phases_[name];
+    phase.min_ms = phase.calls ? std::min(phase.min_ms, ms) : ms;
+    phase.max_ms = std::max(phase.max_ms, ms);
+    phase.total_ms += ms;
+    ++phase.calls;
+}
+
+void Profiler::add_count(const char* name, uint64_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[name] += count;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_.clear();
+    counters_.clear();
+}
+
+std::map<std::string, Profiler::Phase> Profiler::get_phases() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+}
+
+std::map<std::string, uint64_t> Profiler::get_counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+void Profiler::print(std::ostream& out) const {
+    const auto phases = get_phases();
+    const auto counters = get_counters();
+    out << "Profile (ms):" << std::endl;
+    for (const auto& entry : phases) {
+        const Phase& p = entry.second;
+        out << "  " << std::left << std::setw(28) << entry.first << std::right
+            << " calls " << p.calls << ", total " << p.total_ms << ", mean " << p.total_ms / p.calls
+            << ", min " << p.min_ms << ", max " << p.max_ms << std::endl;
+    }
+    for (const auto& entry : counters) {
+        out << "  " << std::left << std::setw(28) << entry.first << std::right << " " << entry.second << std::endl;
+    }
+}
+
+void Profiler::write_json(std::ostream& out) const {
+    const auto phases = get_phases();
+    const auto counters = get_counters();
+    out << "{\n  \"phases\": {";
+    bool first = true;
+    for (const auto& entry : phases) {
+        const Phase& p = entry.second;
+        out << (first ? "\n" : ",\n") << "    \"" << entry.first << "\": {\"calls\": " << p.calls
+            << ", \"total_ms\": " << p.total_ms << ", \"mean_ms\": " << p.total_ms / p.calls
+            << ", \"min_ms\": " << p.min_ms << ", \"max_ms\": " << p.max_ms << "}";
+        first = false;
+    }
+    out << (first ? "},\n" : "\n  },\n") << "  \"counters\": {";
+    first = true;
+    for (const auto& entry : counters) {
+        out << (first ? "\n" : ",\n") << "    \"" << entry.first << "\": " << entry.second;
+        first = false;
+    }
+    out << (first ? "}\n" : "\n  }\n") << "}\n";
+}
+
+bool Profiler::save_json(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write profile to " << path << std::endl;
+        return false;
+    }
+    write_json(file);
+    std::cout << "Saved profile to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// 热点路径的分阶段计时与计数。只有定义了 SPHMESH_PROFILE 时下面的宏才会展开，
+// 默认编译时宏为空，不产生任何代码 (CMake: -DSPHMESH_PROFILE=ON)。
+// 计时按阶段名汇总调用次数、总耗时与最短/最长耗时；计数器按名字累加。可以从多个线程同时写入
+class Profiler {
+public:
+    struct Phase {
+        uint64_t calls = 0;
+        double total_ms = 0.0;
+        double min_ms = 0.0;
+        double max_ms = 0.0;
+    };
+
+    static Profiler& instance();
+
+    void add_time(const char* name, double ms);
+    void add_count(const char* name, uint64_t count);
+    void reset();
+
+    std::map<std::string, Phase> get_phases() const;
+    std::map<std::string, uint64_t> get_counters() const;
+
+    void print(std::ostream& out) const;
+    void write_json(std::ostream& out) const;
+    bool save_json(const std::string& path) const;
+
+    // 编译时是否启用了分阶段计时
+    static constexpr bool enabled() {
+#ifdef SPHMESH_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    Profiler() = default;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Phase> phases_;
+    std::map<std::string, uint64_t> counters_;
+};
+
+// 作用域计时：析构时把耗时记入 name 对应的阶段
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name_(name), start_(std::chrono::steady_clock::now()) {}
+    ~ProfileScope() {
+        Profiler::instance().add_time(name_, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define SPHMESH_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SPHMESH_PROFILE_CONCAT(a, b) SPHMESH_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SPHMESH_PROFILE
+// 计时当前作用域
+#define SPHMESH_PROFILE_SCOPE(name) ProfileScope SPHMESH_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+// 计数器累加 count
+#define SPHMESH_PROFILE_COUNT(name, count) Profiler::instance().add_count(name, static_cast<uint64_t>(count))
+// 只在启用时编译的语句，用于热循环中的局部计数
+#define SPHMESH_PROFILE_ONLY(...) __VA_ARGS__
+#else
+#define SPHMESH_PROFILE_SCOPE(name) ((void)0)
+#define SPHMESH_PROFILE_COUNT(name, count) ((void)0)
+#define SPHMESH_PROFILE_ONLY(...)
+#endif
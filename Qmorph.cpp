@@ -1,103 +1,635 @@
 #include "Qmorph.h"
 #include "CGALMeshGenerator.h" 
+#include "MeshQuality.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
+#include "EdgeAdjacency.h"
 #include <iostream>
-#include <map>
 #include <vector>
+#include <algorithm>
 #include <numeric>
+#include <chrono>
 
-// Q-Morph 㷨ʵ
+// Q-Morph 核心算法的实现
 Qmorph::Result Qmorph::run(const CGALMeshGenerator& delaunay_mesh) {
-    const auto& triangles = delaunay_mesh.get_triangles();
-    const auto& vertices = delaunay_mesh.get_vertices();
+    // 1. 构建邻接关系：一次排序配对得到半边 twin，替代 map<pair, vector>
+    mesh_.build(delaunay_mesh.get_vertices(), delaunay_mesh.get_triangles());
+    return run(mesh_);
+}
+
+Qmorph::Result Qmorph::run(const Mesh2D& mesh) {
+    SPHMESH_PROFILE_SCOPE("mesh.qmorph");
+    using Index = Mesh2D::Index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
 
-    if (triangles.empty()) {
+    if (num_faces == 0) {
         std::cout << "No triangles to convert." << std::endl;
         return {};
     }
 
+    auto start = std::chrono::steady_clock::now();
     Result result;
-    std::vector<bool> triangle_merged(triangles.size(), false);
+    size_t augmented = 0;
+
+    if (mode_ == Mode::AdvancingFront) {
+        run_advancing_front(mesh, result);
+    }
+    else {
+        // 2. 计算每条内部边合并后的质量 (3. 质量检查也在这里完成)
+        compute_edge_quality(mesh);
+
+        // 3. 选择三角形对
+        if (mode_ == Mode::Matching) augmented = match_pairs(mesh);
+        else match_greedy(mesh);
+
+        // 4. 输出四边形与未被合并的三角形
+        emit_pairs(mesh, result);
+    }
+
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t num_tris = 2 * result.quads.size() + result.remaining_triangles.size();
+    result.quad_fraction = num_tris ? static_cast<float>(2 * result.quads.size()) / num_tris : 0.0f;
+
+    const char* mode_name = mode_ == Mode::Matching ? "matching" : (mode_ == Mode::AdvancingFront ? "advancing front" : "greedy");
+    std::cout << "Q-Morph Conversion complete (" << mode_name << "): "
+              << result.quads.size() << " quads, " << result.remaining_triangles.size() << " triangles remaining, "
+              << result.quad_fraction * 100.0f << "% merged";
+    if (augmented > 0) std::cout << " (" << augmented << " augmenting paths)";
+    if (mode_ == Mode::AdvancingFront) std::cout << ", " << result.irregular_vertices << " irregular vertices";
+    std::cout << ", " << result.elapsed_ms << " ms." << std::endl;
+    return result;
+}
+
+size_t Qmorph::match_pairs(const Mesh2D& mesh) {
+    match_locally_dominant(mesh);
+    return (mesh.get_num_faces() <= blossom_max_faces_) ? augment_blossom(mesh) : augment_short_paths(mesh);
+}
+
+// 三角形 f1 = (a, b, c)，f2 = (b, a, d)，合并后按逆时针为 (a, d, b, c)
+void Qmorph::emit_pairs(const Mesh2D& mesh, Result& result) {
+    using Index = Mesh2D::Index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    for (Index f = 0; f < num_faces; ++f) {
+        if (mesh.face_size(f) != 3) continue;
+        const Index h = mate_[f];
+        if (h == Mesh2D::invalid_index) {
+            result.remaining_triangles.push_back({ mesh.face_vertex(f, 0), mesh.face_vertex(f, 1), mesh.face_vertex(f, 2) });
+            continue;
+        }
+        const Index t = mesh.twin(h);
+        if (mesh.face(t) < f) continue;
+        result.quads.push_back({ mesh.origin(h), mesh.origin(mesh.next(mesh.next(t))),
+                                 mesh.target(h), mesh.origin(mesh.next(mesh.next(h))) });
+    }
+}
+
+void Qmorph::run_advancing_front(const Mesh2D& mesh, Result& result) {
+    using Index = Mesh2D::Index;
+
+    // 1. 推进波前：换边只改连接关系，三角形仍使用原来的顶点编号
+    std::vector<MeshTriangle> triangles;
+    std::vector<Index> partner;
+    front_.run(mesh, &MeshQuality::quad_quality_fast, triangles, partner);
+
+    // 2. 以波前得到的配对为初始匹配，沿增广路把孤立的三角形也配上对
+    std::vector<glm::vec2> vertices(mesh.get_num_vertices());
+    for (Index v = 0; v < vertices.size(); ++v) vertices[v] = mesh.position(v);
+    front_mesh_.build(vertices, triangles);
+    compute_edge_quality(front_mesh_);
+    mate_.assign(triangles.size(), Mesh2D::invalid_index);
+    for (Index f = 0; f < triangles.size(); ++f) {
+        if (partner[f] == Mesh2D::invalid_index) continue;
+        for (Index h = front_mesh_.face_begin(f); h < front_mesh_.face_begin(f) + 3; ++h) {
+            if (front_mesh_.twin(h) != Mesh2D::invalid_index && front_mesh_.face(front_mesh_.twin(h)) == partner[f]) mate_[f] = h;
+        }
+    }
+    const size_t augmented = (triangles.size() <= blossom_max_faces_) ? augment_blossom(front_mesh_) : augment_short_paths(front_mesh_);
+    emit_pairs(front_mesh_, result);
 
-    // 1. ڽӹϵ
-    std::map<std::pair<unsigned int, unsigned int>, std::vector<size_t>> edge_to_triangle_map;
-    for (size_t i = 0; i < triangles.size(); ++i) {
-        auto& t = triangles[i];
-        unsigned int v[3] = { t.v0, t.v1, t.v2 };
-        for (int j = 0; j < 3; ++j) {
-            unsigned int v1 = v[j];
-            unsigned int v2 = v[(j + 1) % 3];
-            if (v1 > v2) std::swap(v1, v2);
-            edge_to_triangle_map[{v1, v2}].push_back(i);
+    const auto& stats = front_.get_stats();
+    std::cout << "Advancing front: " << stats.front_quads << " front quads, " << stats.paired_quads << " paired, "
+              << stats.swaps << " swaps (" << stats.retried << " retried, " << stats.rejected << " rejected edges), "
+              << augmented << " augmenting paths." << std::endl;
+
+    // 3. 仍有三角形时沿四边形路径局部收尾
+    Mesh2D final_mesh;
+    final_mesh.build(vertices, result.remaining_triangles, result.quads);
+    if (all_quad_ && !result.remaining_triangles.empty()) {
+        // 收尾得到的四边形会挡住后面的路径，重建邻接后再走几轮，直到没有进展
+        size_t closed = 0;
+        for (int round = 0; round < 4 && !result.remaining_triangles.empty(); ++round) {
+            const size_t removed = close_front(final_mesh, result);
+            final_mesh.build(result.vertices, result.remaining_triangles, result.quads);
+            closed += removed;
+            if (removed == 0) break;
         }
+        std::cout << "Front closure: " << closed << " triangles closed, " << result.remaining_triangles.size() << " left, "
+                  << result.vertices.size() - vertices.size() << " vertices added." << std::endl;
+    }
+
+    // 4. 统计非正则的内部顶点 (度数不为 4)
+    std::vector<Index> valence(final_mesh.get_num_vertices(), 0);
+    for (Index v : final_mesh.get_face_verts()) valence[v]++;
+    for (Index v = 0; v < valence.size(); ++v) {
+        if (valence[v] > 0 && !final_mesh.is_boundary_vertex(v) && valence[v] != 4) result.irregular_vertices++;
     }
+}
+
+namespace {
+constexpr float kMinCloseJacobian = 0.1f;  // 收尾时新四边形的最低 scaled Jacobian
+constexpr size_t kMaxCloseVisits = 256;     // 每次路径搜索最多访问的面数，保证收尾只改动局部
+constexpr size_t kMaxClosePolygon = 10;     // 一段合并后多边形的最多顶点数
+constexpr int kMaxCloseTries = 16;          // 每次搜索最多尝试剖分的候选路径数
+}
+
+// 局部收尾：从每个剩余三角形出发，只经过四边形做广度优先搜索，找到最近的另一个剩余三角形
+// (找不到时改找一条边界边，三角形总数为奇数时必然有一个要这样处理)，只重新剖分路径上的单元：
+// 路径从头开始分成若干段，相邻两段的公共边 (以及所找到的边界边) 取中点，
+// 每段合并成偶数条边的多边形后用对角线分成四边形；分不开时把下一个单元并入这一段再试。
+// 路径以外的单元保持不变。返回收尾消去的三角形数
+size_t Qmorph::close_front(const Mesh2D& mesh, Result& result) {
+    using Index = Mesh2D::Index;
+    constexpr Index invalid = Mesh2D::invalid_index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    const Index num_tris = static_cast<Index>(result.remaining_triangles.size());
+
+    auto& vertices = result.vertices;
+    vertices.resize(mesh.get_num_vertices());
+    for (Index v = 0; v < vertices.size(); ++v) vertices[v] = mesh.position(v);
+
+    std::vector<std::uint8_t> used(num_faces, 0);
+    std::vector<Index> stamp(num_faces, invalid), entry(num_faces, invalid);
+    std::vector<Index> queue, path, poly, merged;
+    std::vector<std::pair<Index, Index>> splits; // (半边, 中点)
+    std::vector<MeshQuad> closed, pieces;
+    std::vector<float> best;
+    std::vector<std::pair<int, int>> choice;
+
+    auto quad_jacobian = [&](Index a, Index b, Index c, Index d) {
+        const glm::vec2 p[4] = { vertices[a], vertices[b], vertices[c], vertices[d] };
+        return MeshQuality::element_scaled_jacobian(p, 4);
+    };
+
+    // 逆时针的偶数边多边形用对角线分成四边形，追加到 pieces：区间动态规划，
+    // best[i][j] 为链 i..j 加上弦 (j, i) 围成的子多边形能达到的最差单元 scaled Jacobian 的最大值。
+    // 中点处为平角，以它为中间角点的四边形 scaled Jacobian 为 0，不会被选中
+    auto quadrangulate = [&]() {
+        const int n = static_cast<int>(poly.size());
+        if (n < 4 || n % 2 != 0 || n > static_cast<int>(kMaxClosePolygon)) return false;
+        best.assign(n * n, -1.0f);
+        choice.assign(n * n, { -1, -1 });
+        auto sub = [&](int i, int j) { return j == i + 1 ? 1.0f : best[i * n + j]; };
+        for (int len = 3; len < n; len += 2) {
+            for (int i = 0; i + len < n; ++i) {
+                const int j = i + len;
+                for (int a = i + 1; a < j; a += 2) {
+                    for (int b = a + 1; b < j; b += 2) {
+                        float q = std::min({ sub(i, a), sub(a, b), sub(b, j) });
+                        if (q <= best[i * n + j]) continue;
+                        q = std::min(q, quad_jacobian(poly[i], poly[a], poly[b], poly[j]));
+                        if (q > best[i * n + j]) {
+                            best[i * n + j] = q;
+                            choice[i * n + j] = { a, b };
+                        }
+                    }
+                }
+            }
+        }
+        if (best[n - 1] < kMinCloseJacobian) return false;
 
-    // 2. ڲߣԺϲ
-    for (auto const& [edge, tri_indices] : edge_to_triangle_map) {
-        if (tri_indices.size() == 2) {
-            size_t tri1_idx = tri_indices[0];
-            size_t tri2_idx = tri_indices[1];
+        std::vector<std::pair<int, int>> stack{ { 0, n - 1 } };
+        while (!stack.empty()) {
+            const auto [i, j] = stack.back();
+            stack.pop_back();
+            if (j == i + 1) continue;
+            const auto [a, b] = choice[i * n + j];
+            pieces.push_back({ poly[i], poly[a], poly[b], poly[j] });
+            stack.push_back({ i, a });
+            stack.push_back({ a, b });
+            stack.push_back({ b, j });
+        }
+        return true;
+    };
 
-            if (triangle_merged[tri1_idx] || triangle_merged[tri2_idx]) {
-                continue;
+    // 沿 path[first..last] 合并后的边界逆时针走一圈得到多边形，取中点的边插入中点
+    auto build_polygon = [&](size_t first, size_t last) {
+        auto is_merged = [&](Index h) { return std::find(merged.begin(), merged.end(), h) != merged.end(); };
+        auto in_group = [&](Index h) {
+            return std::find(path.begin() + first, path.begin() + last + 1, mesh.face(h)) != path.begin() + last + 1;
+        };
+        poly.clear();
+        const Index f = path[first];
+        Index start = invalid;
+        for (Index h = mesh.face_begin(f); h < mesh.face_begin(f) + mesh.face_size(f); ++h) {
+            if (!is_merged(h)) {
+                start = h;
+                break;
+            }
+        }
+        Index h = start;
+        for (size_t guard = 0; guard < kMaxClosePolygon && start != invalid; ++guard) {
+            poly.push_back(mesh.origin(h));
+            for (const auto& split : splits) {
+                if (split.first == h) poly.push_back(split.second);
             }
+            Index n = mesh.next(h);
+            for (int turn = 0; turn < 8 && is_merged(n); ++turn) n = mesh.next(mesh.twin(n));
+            if (is_merged(n) || !in_group(n)) return false;
+            h = n;
+            if (h == start) break;
+        }
+        if (h != start) return false;
+        for (size_t i = 0; i < poly.size(); ++i) {
+            for (size_t j = i + 1; j < poly.size(); ++j) {
+                if (poly[i] == poly[j]) return false;
+            }
+        }
+        return true;
+    };
 
-            const auto& t1 = triangles[tri1_idx];
-            const auto& t2 = triangles[tri2_idx];
+    auto add_split = [&](Index h) {
+        const Index m = static_cast<Index>(vertices.size());
+        vertices.push_back(0.5f * (vertices[mesh.origin(h)] + vertices[mesh.target(h)]));
+        splits.push_back({ h, m });
+        if (mesh.twin(h) != invalid) splits.push_back({ mesh.twin(h), m });
+        return m;
+    };
 
-            unsigned int shared_v1 = edge.first;
-            unsigned int shared_v2 = edge.second;
+    // 按 entry 从 target 回溯到起点得到路径并剖分；hb 为要取中点的边界半边 (以三角形结尾时为 invalid)
+    auto try_close = [&](Index target, Index hb) {
+        path.clear();
+        for (Index f = target; f != invalid; f = (entry[f] == invalid) ? invalid : mesh.face(mesh.twin(entry[f]))) path.push_back(f);
+        std::reverse(path.begin(), path.end());
+        const size_t n = path.size();
+        const bool to_triangle = hb == invalid;
+
+        const size_t saved = vertices.size();
+        pieces.clear();
+        Index entry_edge = invalid, entry_mid = invalid;
+        for (size_t s = 0; s < n;) {
+            // 首段至少包含起点三角形与第一个四边形，末尾的三角形也不能单独成段
+            bool done = false;
+            for (size_t e = (s == 0) ? 1 : s; e < n && !done; ++e) {
+                if (to_triangle && e + 2 == n) continue;
+                merged.clear();
+                splits.clear();
+                for (size_t j = s + 1; j <= e; ++j) {
+                    merged.push_back(entry[path[j]]);
+                    merged.push_back(mesh.twin(entry[path[j]]));
+                }
+                if (s > 0) {
+                    splits.push_back({ entry_edge, entry_mid });
+                    splits.push_back({ mesh.twin(entry_edge), entry_mid });
+                }
+                const Index exit_edge = (e + 1 < n) ? entry[path[e + 1]] : (to_triangle ? invalid : hb);
+                const Index exit_mid = (exit_edge != invalid) ? add_split(exit_edge) : invalid;
+                if (build_polygon(s, e) && quadrangulate()) {
+                    entry_edge = exit_edge;
+                    entry_mid = exit_mid;
+                    s = e + 1;
+                    done = true;
+                }
+                else if (exit_mid != invalid) {
+                    vertices.pop_back();
+                }
+                if (poly.size() >= kMaxClosePolygon) break;
+            }
+            if (!done) {
+                vertices.resize(saved);
+                return false;
+            }
+        }
+        for (Index f : path) used[f] = 1;
+        closed.insert(closed.end(), pieces.begin(), pieces.end());
+        return true;
+    };
 
-            unsigned int other_v1 = (t1.v0 != shared_v1 && t1.v0 != shared_v2) ? t1.v0 : ((t1.v1 != shared_v1 && t1.v1 != shared_v2) ? t1.v1 : t1.v2);
-            unsigned int other_v2 = (t2.v0 != shared_v1 && t2.v0 != shared_v2) ? t2.v0 : ((t2.v1 != shared_v1 && t2.v1 != shared_v2) ? t2.v1 : t2.v2);
+    auto boundary_edge = [&](Index f) {
+        for (Index h = mesh.face_begin(f); h < mesh.face_begin(f) + mesh.face_size(f); ++h) {
+            if (mesh.twin(h) == invalid) return h;
+        }
+        return invalid;
+    };
 
-            // 3. 
-            float quality = calculate_quad_quality(vertices[other_v1], vertices[shared_v1], vertices[other_v2], vertices[shared_v2]);
-            if (quality > 0.3f) { // 趨һֵ
-                result.quads.push_back({ other_v1, shared_v1, other_v2, shared_v2 });
-                triangle_merged[tri1_idx] = true;
-                triangle_merged[tri2_idx] = true;
+    // 只经过未改动的四边形做广度优先搜索，按距离由近到远尝试每个候选终点
+    auto search = [&](Index t, bool to_boundary) {
+        queue.assign(1, t);
+        stamp[t] = t;
+        entry[t] = invalid;
+        const Index t_boundary = to_boundary ? boundary_edge(t) : invalid;
+        int tries = 0;
+        auto attempt = [&](Index target, Index hb) { return tries++ < kMaxCloseTries && try_close(target, hb); };
+        for (size_t head = 0; head < queue.size() && queue.size() < kMaxCloseVisits && tries < kMaxCloseTries; ++head) {
+            const Index f = queue[head];
+            for (Index h = mesh.face_begin(f); h < mesh.face_begin(f) + mesh.face_size(f); ++h) {
+                const Index o = mesh.twin(h);
+                if (o == invalid) continue;
+                const Index g = mesh.face(o);
+                if (used[g] || stamp[g] == t) continue;
+                stamp[g] = t;
+                entry[g] = o;
+                if (g < num_tris) {
+                    if (!to_boundary && attempt(g, invalid)) return true;
+                    continue;
+                }
+                queue.push_back(g);
+                if (!to_boundary) continue;
+                const Index hb = boundary_edge(g);
+                if (hb != invalid && attempt(g, hb)) return true;
+                if (f == t && t_boundary != invalid && attempt(g, t_boundary)) return true;
             }
         }
+        return false;
+    };
+
+    size_t removed = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (Index t = 0; t < num_tris; ++t) {
+            if (!used[t] && search(t, pass == 1)) removed += (pass == 0) ? 2 : 1;
+        }
     }
 
-    // 4. ռδϲ
-    for (size_t i = 0; i < triangles.size(); ++i) {
-        if (!triangle_merged[i]) {
-            result.remaining_triangles.push_back(triangles[i]);
+    // 输出：未改动的三角形与四边形，加上收尾得到的四边形
+    std::vector<MeshTriangle> triangles;
+    std::vector<MeshQuad> quads;
+    for (Index f = 0; f < num_tris; ++f) {
+        if (!used[f]) triangles.push_back(result.remaining_triangles[f]);
+    }
+    for (Index f = num_tris; f < num_faces; ++f) {
+        if (!used[f]) quads.push_back(result.quads[f - num_tris]);
+    }
+    quads.insert(quads.end(), closed.begin(), closed.end());
+    result.remaining_triangles.swap(triangles);
+    result.quads.swap(quads);
+    return removed;
+}
+
+void Qmorph::compute_edge_quality(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    const Index num_half = static_cast<Index>(mesh.get_num_half_edges());
+    edge_quality_.assign(num_half, -1.0f);
+    // 每条内部边只由编号较小的半边写入两侧，各块之间没有写冲突
+    TaskScheduler::instance().parallel_for(0, num_half, 4096, [&](size_t lo, size_t hi) {
+        for (Index h = static_cast<Index>(lo); h < static_cast<Index>(hi); ++h) {
+            const Index t = mesh.twin(h);
+            if (t == Mesh2D::invalid_index || t < h) continue;
+            if (mesh.face_size(mesh.face(h)) != 3 || mesh.face_size(mesh.face(t)) != 3) continue;
+
+            const glm::vec2 a = mesh.position(mesh.origin(h));
+            const glm::vec2 b = mesh.position(mesh.target(h));
+            const glm::vec2 c = mesh.position(mesh.origin(mesh.next(mesh.next(h))));
+            const glm::vec2 d = mesh.position(mesh.origin(mesh.next(mesh.next(t))));
+            float quality = MeshQuality::quad_quality_fast(a, d, b, c);
+            if (quality > quality_threshold_) {
+                edge_quality_[h] = quality;
+                edge_quality_[t] = quality;
+            }
         }
+    });
+}
+
+// 原来的合并方式：按 (较小端点, 较大端点) 的顺序遍历内部边 (与原先 std::map 的遍历顺序相同)，
+// 两侧都未合并就合并。贪心的结果依赖遍历顺序，按半边编号遍历时合并数明显减少。
+// 边键用一次基数排序得到，与 build_edge_adjacency 相同
+void Qmorph::match_greedy(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    mate_.assign(mesh.get_num_faces(), Mesh2D::invalid_index);
+    const Index num_half = static_cast<Index>(mesh.get_num_half_edges());
+
+    int vbits = 1;
+    while (vbits < 32 && (static_cast<std::uint64_t>(1) << vbits) < mesh.get_num_vertices()) ++vbits;
+    edge_keys_.clear();
+    edge_ids_.clear();
+    for (Index h = 0; h < num_half; ++h) {
+        const Index t = mesh.twin(h);
+        if (edge_quality_[h] < 0.0f || t < h) continue;
+        const Index a = std::min(mesh.origin(h), mesh.target(h)), b = std::max(mesh.origin(h), mesh.target(h));
+        edge_keys_.push_back((static_cast<std::uint64_t>(a) << vbits) | b);
+        edge_ids_.push_back(h);
     }
+    radix_sort_pairs(edge_keys_, edge_ids_, 2 * vbits);
 
-    std::cout << "Q-Morph Conversion complete: " << result.quads.size() << " quads, " << result.remaining_triangles.size() << " triangles remaining." << std::endl;
-    return result;
+    for (Index h : edge_ids_) {
+        const Index t = mesh.twin(h);
+        const Index f1 = mesh.face(h), f2 = mesh.face(t);
+        if (mate_[f1] != Mesh2D::invalid_index || mate_[f2] != Mesh2D::invalid_index) continue;
+        mate_[f1] = h;
+        mate_[f2] = t;
+    }
 }
 
-// ʹһ򵥵ĻڽǶȵķ
-float Qmorph::calculate_quad_quality(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4) {
-    auto angle = [](const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
-        glm::vec2 v1 = a - b;
-        glm::vec2 v2 = c - b;
-        return std::acos(glm::dot(glm::normalize(v1), glm::normalize(v2)));
-        };
+// 局部占优匹配：每个未配对三角形指向质量最高的可用邻居，互相指向即配对；
+// 全局质量最高的可用边在每一轮中总是互相指向，因此每轮至少增加一对。
+// 每一轮分两步在任务池上并行：先各自选出候选 (只读 mate_)，再由互相指向的一对中编号较小的一方
+// 写入配对 (只读 candidate)，两步内都没有写冲突，结果与串行相同，是最大权匹配的 1/2 近似
+void Qmorph::match_locally_dominant(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    const Index invalid = Mesh2D::invalid_index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    auto& scheduler = TaskScheduler::instance();
+    mate_.assign(num_faces, invalid);
+
+    // 质量相同时按较小的三角形编号决胜，保证选择是全序的
+    auto better = [&](Index h1, Index h2) {
+        if (h2 == invalid) return true;
+        if (edge_quality_[h1] != edge_quality_[h2]) return edge_quality_[h1] > edge_quality_[h2];
+        return mesh.face(mesh.twin(h1)) < mesh.face(mesh.twin(h2));
+    };
+
+    std::vector<Index> candidate(num_faces, invalid);
+    std::vector<Index> active;
+    active.reserve(num_faces);
+    for (Index f = 0; f < num_faces; ++f) {
+        if (mesh.face_size(f) == 3) active.push_back(f);
+    }
+
+    while (!active.empty()) {
+        // 每个活动三角形选出当前最好的可用邻居
+        scheduler.parallel_for(0, active.size(), 2048, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                const Index f = active[i];
+                Index best = invalid;
+                const Index begin = mesh.face_begin(f);
+                for (Index h = begin; h < begin + 3; ++h) {
+                    if (edge_quality_[h] < 0.0f || mate_[mesh.face(mesh.twin(h))] != invalid) continue;
+                    if (better(h, best)) best = h;
+                }
+                candidate[f] = best;
+            }
+        });
+        // 互相指向的三角形配对
+        scheduler.parallel_for(0, active.size(), 2048, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                const Index f = active[i];
+                const Index h = candidate[f];
+                if (h == invalid) continue;
+                const Index t = mesh.twin(h);
+                const Index g = mesh.face(t);
+                if (f < g && candidate[g] == t) {
+                    mate_[f] = h;
+                    mate_[g] = t;
+                }
+            }
+        });
+        // 没有候选或已配对的三角形退出
+        active.erase(std::remove_if(active.begin(), active.end(), [&](Index f) {
+            return candidate[f] == invalid || mate_[f] != invalid;
+        }), active.end());
+    }
+}
 
-    float angles[4];
-    angles[0] = angle(p4, p1, p2);
-    angles[1] = angle(p1, p2, p3);
-    angles[2] = angle(p2, p3, p4);
-    angles[3] = angle(p3, p4, p1);
+// 长度为 3 的增广路：未配对的 u 与已配对 (v, w) 中的 v 相邻，且 w 还有另一个未配对邻居 x，
+// 则改为 (u, v)、(w, x)，多出一个四边形。一次线性扫描，用于面数超出 blossom 上限的大网格
+size_t Qmorph::augment_short_paths(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    const Index invalid = Mesh2D::invalid_index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
 
-    float min_angle_deg = 180.0f, max_angle_deg = 0.0f;
-    for (int i = 0; i < 4; ++i) {
-        float deg = glm::degrees(angles[i]);
-        min_angle_deg = std::min(min_angle_deg, deg);
-        max_angle_deg = std::max(max_angle_deg, deg);
+    size_t augmented = 0;
+    for (Index u = 0; u < num_faces; ++u) {
+        if (mate_[u] != invalid || mesh.face_size(u) != 3) continue;
+        const Index u_begin = mesh.face_begin(u);
+        for (Index hu = u_begin; hu < u_begin + 3 && mate_[u] == invalid; ++hu) {
+            if (edge_quality_[hu] < 0.0f) continue;
+            const Index v = mesh.face(mesh.twin(hu));
+            if (mate_[v] == invalid) continue;
+            const Index w = mesh.face(mesh.twin(mate_[v]));
+            const Index w_begin = mesh.face_begin(w);
+            for (Index hw = w_begin; hw < w_begin + 3; ++hw) {
+                if (edge_quality_[hw] < 0.0f) continue;
+                const Index x = mesh.face(mesh.twin(hw));
+                if (x == u || mate_[x] != invalid) continue;
+                mate_[u] = hu;
+                mate_[v] = mesh.twin(hu);
+                mate_[w] = hw;
+                mate_[x] = mesh.twin(hw);
+                ++augmented;
+                break;
+            }
+        }
     }
+    return augmented;
+}
+
+// Edmonds blossom 算法：从加权匹配出发，对每个未配对三角形搜索增广路，提高可合并边上的匹配基数
+// (只增加配对数，不按权重优化，不是精确的最大权匹配)。每次搜索只重置被访问过的顶点。
+// 完整的搜索失败时该顶点以后也不可能再被增广，因此每个顶点只搜索一次；
+// 但接近完美匹配时失败的搜索会扫过整个连通块，所以单次搜索访问的顶点数设有上限，
+// 被截断的搜索并不说明不存在增广路，这些顶点同样不再重试，结果可能比最大基数匹配少几对
+size_t Qmorph::augment_blossom(const Mesh2D& mesh) {
+    using Index = Mesh2D::Index;
+    constexpr size_t kMaxSearch = 1 << 12;
+    const Index invalid = Mesh2D::invalid_index;
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+
+    std::vector<Index> match(num_faces, invalid);
+    for (Index f = 0; f < num_faces; ++f) {
+        if (mate_[f] != invalid) match[f] = mesh.face(mesh.twin(mate_[f]));
+    }
+
+    std::vector<Index> parent(num_faces, invalid), base(num_faces);
+    std::vector<char> used(num_faces, 0), in_blossom(num_faces, 0);
+    std::vector<std::uint32_t> lca_mark(num_faces, 0);
+    std::uint32_t lca_stamp = 0;
+    std::vector<Index> touched, queue;
+    for (Index f = 0; f < num_faces; ++f) base[f] = f;
+
+    auto lca = [&](Index a, Index b) {
+        ++lca_stamp;
+        while (true) {
+            a = base[a];
+            lca_mark[a] = lca_stamp;
+            if (match[a] == invalid) break;
+            a = parent[match[a]];
+        }
+        while (true) {
+            b = base[b];
+            if (lca_mark[b] == lca_stamp) return b;
+            b = parent[match[b]];
+        }
+    };
+    auto mark_path = [&](Index v, Index b, Index child) {
+        while (base[v] != b) {
+            in_blossom[base[v]] = in_blossom[base[match[v]]] = 1;
+            parent[v] = child;
+            child = match[v];
+            v = parent[match[v]];
+        }
+    };
+    auto find_path = [&](Index root) {
+        for (Index v : touched) {
+            used[v] = 0;
+            parent[v] = invalid;
+            base[v] = v;
+        }
+        touched.clear();
+        queue.clear();
+        used[root] = 1;
+        touched.push_back(root);
+        queue.push_back(root);
+        for (size_t qi = 0; qi < queue.size() && touched.size() < kMaxSearch; ++qi) {
+            const Index v = queue[qi];
+            const Index begin = mesh.face_begin(v);
+            for (Index h = begin; h < begin + 3; ++h) {
+                if (edge_quality_[h] < 0.0f) continue;
+                const Index to = mesh.face(mesh.twin(h));
+                if (base[v] == base[to] || match[v] == to) continue;
+                if (to == root || (match[to] != invalid && parent[match[to]] != invalid)) {
+                    // 发现奇环：收缩成 blossom
+                    const Index cur_base = lca(v, to);
+                    for (Index u : touched) in_blossom[u] = 0;
+                    mark_path(v, cur_base, to);
+                    mark_path(to, cur_base, v);
+                    for (Index u : touched) {
+                        if (!in_blossom[base[u]]) continue;
+                        base[u] = cur_base;
+                        if (!used[u]) {
+                            used[u] = 1;
+                            queue.push_back(u);
+                        }
+                    }
+                }
+                else if (parent[to] == invalid) {
+                    parent[to] = v;
+                    touched.push_back(to);
+                    if (match[to] == invalid) return to;
+                    const Index next = match[to];
+                    used[next] = 1;
+                    touched.push_back(next);
+                    queue.push_back(next);
+                }
+            }
+        }
+        return invalid;
+    };
 
-    // ̫С̫Сͺܲ
-    if (max_angle_deg > 165.0f || min_angle_deg < 25.0f) {
-        return 0.0f;
+    size_t augmented = 0;
+    for (Index root = 0; root < num_faces; ++root) {
+        if (match[root] != invalid || mesh.face_size(root) != 3) continue;
+        Index v = find_path(root);
+        if (v == invalid) continue;
+        // 沿增广路翻转匹配边
+        while (v != invalid) {
+            const Index pv = parent[v];
+            const Index ppv = match[pv];
+            match[v] = pv;
+            match[pv] = v;
+            v = ppv;
+        }
+        ++augmented;
     }
 
-    // һ򵥵Խӽ90Խ
-    float quality = 1.0f - (max_angle_deg - 90.0f) / 75.0f;
-    return quality;
-}
\ No newline at end of file
+    // 写回为共享半边
+    for (Index f = 0; f < num_faces; ++f) {
+        mate_[f] = invalid;
+        if (match[f] == invalid) continue;
+        const Index begin = mesh.face_begin(f);
+        for (Index h = begin; h < begin + 3; ++h) {
+            if (mesh.twin(h) != invalid && mesh.face(mesh.twin(h)) == match[f]) {
+                mate_[f] = h;
+                break;
+            }
+        }
+    }
+    return augmented;
+}
@@ -1,25 +1,85 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include "CGALMeshGenerator.h"
+#include "Mesh2D.h"
+#include "QmorphFront.h"
 
-// Ϊ˱ѭãֻǰ
+// 为了避免循环引用，我们只进行前向声明
 class CGALMeshGenerator;
 
 class Qmorph {
 public:
-    // Ľṹ
+    // 定义输出结果的结构体
     struct Result {
         std::vector<CGALMeshGenerator::Quad> quads;
         std::vector<CGALMeshGenerator::Triangle> remaining_triangles;
+        double elapsed_ms = 0.0;    // 新增：转换耗时 (不含 Mesh2D 的建立)
+        float quad_fraction = 0.0f; // 新增：被合并进四边形的三角形比例
+        // 新增：非空时为转换后的顶点 (推进波前的收尾新增了边中点)，否则沿用输入网格的顶点
+        std::vector<glm::vec2> vertices;
+        size_t irregular_vertices = 0; // 新增：度数不为 4 的内部顶点数 (仅推进波前模式统计)
+    };
+
+    // 新增：三角形配对方式
+    enum class Mode {
+        Greedy,   // 按边键 (较小端点, 较大端点) 的顺序贪心合并
+        Matching, // 对偶图上的匹配：先做并行的局部占优加权匹配 (最大权的 1/2 近似)，再沿增广路增加配对数
+                  // (规模适中时用 blossom 增广到接近最大基数匹配，否则只用长度为 3 的增广路)，
+                  // 增广只看配对数不看权重，所以结果不是精确的最大权匹配
+        AdvancingFront // 从边界推进波前的 Q-Morph，再沿增广路补齐配对，剩余三角形沿四边形路径局部收尾
     };
 
     Qmorph() = default;
 
-    // ĺһ񣬷һıΪ
+    // 核心函数：接收一个三角网格，返回一个四边形为主的网格
+    // 新增：先转成共享的 Mesh2D，邻接关系只建立一次，之后可通过 get_mesh() 复用
     Result run(const CGALMeshGenerator& delaunay_mesh);
+    // 新增：直接在已建好半边结构的网格上转换，只处理其中的三角形面
+    Result run(const Mesh2D& mesh);
+
+    const Mesh2D& get_mesh() const { return mesh_; }
+
+    void set_mode(Mode mode) { mode_ = mode; }
+    Mode get_mode() const { return mode_; }
+    // 合并后四边形的最低质量，低于该值的三角形对不参与合并
+    void set_quality_threshold(float threshold) { quality_threshold_ = threshold; }
+    // 面数不超过该值时，在加权匹配之后用 Edmonds blossom 算法增广配对数 (单次搜索有访问上限)，
+    // 超过时只做一遍长度为 3 的增广
+    void set_blossom_max_faces(size_t max_faces) { blossom_max_faces_ = max_faces; }
+    // 推进波前模式下仍有三角形剩余时，沿四边形路径两两收尾 (见 close_front)，只改动路径上的单元；
+    // 没有合格凸四边形可用的三角形 (主要是输入中的狭长三角形) 会保留下来
+    void set_all_quad(bool all_quad) { all_quad_ = all_quad; }
+    void set_front_options(const QmorphFront::Options& options) { front_.set_options(options); }
 
 private:
-    // ˽и
-    float calculate_quad_quality(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4);
+    // 私有辅助函数
+    // 每条内部半边合并成四边形后的质量 (MeshQuality::quad_quality_fast)，不可合并为 -1
+    void compute_edge_quality(const Mesh2D& mesh);
+    // 以下函数填写 mate_[f]：三角形 f 与配对三角形共享的半边，未配对为 invalid_index
+    void match_greedy(const Mesh2D& mesh);
+    void match_locally_dominant(const Mesh2D& mesh);
+    size_t augment_blossom(const Mesh2D& mesh);
+    size_t augment_short_paths(const Mesh2D& mesh);
+    size_t match_pairs(const Mesh2D& mesh);
+    // 按 mate_ 输出四边形与未配对的三角形
+    void emit_pairs(const Mesh2D& mesh, Result& result);
+    void run_advancing_front(const Mesh2D& mesh, Result& result);
+    // 剩余三角形两两 (或与一条边界边) 沿四边形路径配对，只重新剖分路径上的单元
+    size_t close_front(const Mesh2D& mesh, Result& result);
+
+    Mesh2D mesh_;
+    Mode mode_ = Mode::Greedy;
+    float quality_threshold_ = 0.3f;
+    size_t blossom_max_faces_ = 1000000;
+    bool all_quad_ = true;
+    QmorphFront front_;
+    Mesh2D front_mesh_; // 推进波前换边之后的三角网格
+
+    // 扁平的工作数组，多次调用之间重用
+    std::vector<float> edge_quality_;
+    std::vector<Mesh2D::Index> mate_;
+    std::vector<std::uint64_t> edge_keys_; // 贪心模式按边键排序的内部边
+    std::vector<Mesh2D::Index> edge_ids_;
 };
\ No newline at end of file
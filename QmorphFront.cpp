@@ -0,0 +1,509 @@
+#include "QmorphFront.h"
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+namespace {
+constexpr float kPi = 3.14159265f;
+constexpr Mesh2D::Index kInvalid = Mesh2D::invalid_index;
+constexpr int kUnsetLevel = INT_MAX / 2;
+constexpr int kMaxWalk = 1 << 16; // 绕顶点旋转与沿线段行走的步数上限，防止坏网格上死循环
+}
+
+double QmorphFront::orient(Index a, Index b, Index c) const {
+    const double abx = static_cast<double>(xs_[b]) - xs_[a], aby = static_cast<double>(ys_[b]) - ys_[a];
+    const double acx = static_cast<double>(xs_[c]) - xs_[a], acy = static_cast<double>(ys_[c]) - ys_[a];
+    return abx * acy - aby * acx;
+}
+
+// 以 center 为顶点，从 from 方向逆时针转到 to 方向的角度，范围 [0, 2π)
+float QmorphFront::ccw_angle(Index center, Index from, Index to) const {
+    const glm::vec2 u = pos(from) - pos(center);
+    const glm::vec2 v = pos(to) - pos(center);
+    float angle = std::atan2(u.x * v.y - u.y * v.x, glm::dot(u, v));
+    return angle < 0.0f ? angle + 2.0f * kPi : angle;
+}
+
+// 绕 a 旋转查找半边 a->b；a 可能在边界上，因此两个方向都要转
+QmorphFront::Index QmorphFront::find_half_edge(Index a, Index b) const {
+    const Index t = vert_tri_[a];
+    if (t == kInvalid) return kInvalid;
+    Index start = 3 * t;
+    while (tri_verts_[start] != a) ++start;
+
+    Index g = start;
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        if (target(g) == b) return g;
+        const Index p = twin_[prev(g)];
+        if (p == kInvalid) break;
+        g = p;
+        if (g == start) return kInvalid; // 内部顶点已转完一圈
+    }
+    g = start;
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index t2 = twin_[g];
+        if (t2 == kInvalid) break;
+        g = next(t2);
+        if (g == start) break;
+        if (target(g) == b) return g;
+    }
+    return kInvalid;
+}
+
+bool QmorphFront::edge_exists(Index a, Index b) const {
+    return find_half_edge(a, b) != kInvalid || find_half_edge(b, a) != kInvalid;
+}
+
+// 波前边 h = a->b 在 a 端的前一条波前边 (x->a)：在未合并区域内绕 a 逆时针旋转
+QmorphFront::Index QmorphFront::front_prev(Index h) const {
+    Index g = h;
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index p = prev(g);
+        if (!is_free(twin_[p])) return p;
+        g = twin_[p];
+    }
+    return kInvalid;
+}
+
+// 波前边 h = a->b 在 b 端的后一条波前边 (b->y)：在未合并区域内绕 b 顺时针旋转
+QmorphFront::Index QmorphFront::front_next(Index h) const {
+    Index g = next(h);
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        if (!is_free(twin_[g])) return g;
+        g = next(twin_[g]);
+    }
+    return kInvalid;
+}
+
+bool QmorphFront::make_entry(Index h, FrontEntry& entry) const {
+    const Index hp = front_prev(h), hn = front_next(h);
+    if (hp == kInvalid || hn == kInvalid) return false;
+    const Index a = origin(h), b = target(h);
+    entry.a = a;
+    entry.b = b;
+    entry.level = std::max(level_[a], level_[b]);
+    entry.state = (ccw_angle(a, b, origin(hp)) < options_.side_angle ? 1 : 0) +
+                  (ccw_angle(b, target(hn), a) < options_.side_angle ? 1 : 0);
+    entry.length = glm::distance(pos(a), pos(b));
+    return true;
+}
+
+void QmorphFront::push_front(Index h) {
+    FrontEntry entry;
+    if (h != kInvalid && is_front(h) && make_entry(h, entry)) queue_.push(entry);
+}
+
+bool QmorphFront::is_locked(Index a, Index b) const {
+    for (const auto& e : locked_) {
+        if ((e.first == a && e.second == b) || (e.first == b && e.second == a)) return true;
+    }
+    return false;
+}
+
+// 只在未合并区域内部换边，且两个三角形组成严格凸四边形
+bool QmorphFront::can_flip(Index h) const {
+    const Index g = twin_[h];
+    if (!is_free(h) || !is_free(g)) return false;
+    const Index a = origin(h), b = target(h);
+    if (is_locked(a, b)) return false;
+    const Index c = origin(prev(h)), d = origin(prev(g));
+    return orient(a, d, c) > 0.0 && orient(d, b, c) > 0.0;
+}
+
+// 三角形 (a, b, c) 与 (b, a, d) 换边为 (a, d, c) 与 (d, b, c)，返回新边 d->c
+QmorphFront::Index QmorphFront::flip(Index h) {
+    const Index g = twin_[h];
+    const Index t1 = h / 3, t2 = g / 3;
+    const Index a = origin(h), b = target(h), c = origin(prev(h)), d = origin(prev(g));
+    const Index x1 = twin_[next(h)], x2 = twin_[prev(h)];
+    const Index y1 = twin_[next(g)], y2 = twin_[prev(g)];
+
+    const Index h1 = 3 * t1, h2 = 3 * t2;
+    tri_verts_[h1] = a; tri_verts_[h1 + 1] = d; tri_verts_[h1 + 2] = c;
+    tri_verts_[h2] = d; tri_verts_[h2 + 1] = b; tri_verts_[h2 + 2] = c;
+    twin_[h1] = y1; twin_[h1 + 1] = h2 + 2; twin_[h1 + 2] = x2;
+    twin_[h2] = y2; twin_[h2 + 1] = x1; twin_[h2 + 2] = h1 + 1;
+    if (y1 != kInvalid) twin_[y1] = h1;
+    if (x2 != kInvalid) twin_[x2] = h1 + 2;
+    if (y2 != kInvalid) twin_[y2] = h2;
+    if (x1 != kInvalid) twin_[x1] = h2 + 1;
+    vert_tri_[a] = vert_tri_[c] = vert_tri_[d] = t1;
+    vert_tri_[b] = t2;
+    ++stats_.swaps;
+    flip_log_.push_back({ d, c });
+    return h1 + 1;
+}
+
+// 收集线段 uv 穿过的边 (按从 u 到 v 的顺序)；穿过已合并区域、锁定边或恰好经过顶点时失败
+bool QmorphFront::collect_crossing(Index u, Index v, std::vector<std::pair<Index, Index>>& crossing) const {
+    crossing.clear();
+    const Index t = vert_tri_[u];
+    if (t == kInvalid) return false;
+    Index start = 3 * t;
+    while (tri_verts_[start] != u) ++start;
+
+    // 在 u 的一圈三角形中找到 uv 方向所在的那一个
+    Index e = kInvalid;
+    auto test = [&](Index g) {
+        if (!free_[g / 3]) return false;
+        const Index x = target(g), y = origin(prev(g));
+        const double ox = orient(u, x, v), oy = orient(u, v, y);
+        if (ox > 0.0 && oy > 0.0) {
+            e = next(g);
+            return true;
+        }
+        return false;
+    };
+    Index g = start;
+    bool found = false;
+    for (int guard = 0; guard < kMaxWalk && !found; ++guard) {
+        if ((found = test(g))) break;
+        const Index p = twin_[prev(g)];
+        if (p == kInvalid || p == start) break;
+        g = p;
+    }
+    g = start;
+    for (int guard = 0; guard < kMaxWalk && !found; ++guard) {
+        const Index t2 = twin_[g];
+        if (t2 == kInvalid) break;
+        g = next(t2);
+        if (g == start) break;
+        found = test(g);
+    }
+    if (!found) return false;
+
+    // 沿线段穿过三角形，e 的起点在 uv 右侧，终点在左侧
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index x = origin(e), y = target(e);
+        if (is_locked(x, y)) return false;
+        const Index t2 = twin_[e];
+        if (!is_free(t2)) return false;
+        crossing.push_back({ x, y });
+        const Index z = origin(prev(t2));
+        if (z == v) return true;
+        const double o = orient(u, v, z);
+        if (o == 0.0) return false;
+        e = (o > 0.0) ? next(t2) : prev(t2);
+    }
+    return false;
+}
+
+// Sloan 的换边恢复：依次翻转与 uv 相交的凸四边形对角线，新边仍相交则放回队尾
+bool QmorphFront::recover_edge(Index u, Index v) {
+    if (edge_exists(u, v)) return true;
+    std::vector<std::pair<Index, Index>> crossing;
+    if (!collect_crossing(u, v, crossing)) return false;
+
+    auto crosses = [&](Index c, Index d) {
+        return orient(u, v, c) * orient(u, v, d) < 0.0 && orient(c, d, u) * orient(c, d, v) < 0.0;
+    };
+    int swaps = 0;
+    const size_t max_steps = 4 * static_cast<size_t>(options_.max_recovery_swaps) + crossing.size();
+    for (size_t head = 0; head < crossing.size() && head < max_steps; ++head) {
+        const auto [x, y] = crossing[head];
+        Index e = find_half_edge(x, y);
+        if (e == kInvalid) e = find_half_edge(y, x);
+        if (e == kInvalid) continue;
+        if (!can_flip(e)) {
+            crossing.push_back({ x, y });
+            continue;
+        }
+        if (swaps++ >= options_.max_recovery_swaps) return false;
+        const Index nd = flip(e);
+        const Index c = origin(nd), d = target(nd);
+        if (c == u || c == v || d == u || d == v) continue;
+        if (crosses(c, d)) crossing.push_back({ c, d });
+    }
+    return edge_exists(u, v);
+}
+
+// 波前边 h = a->b 的端点 (at_a 为真时取 a，否则取 b) 在已合并一侧只有一条四边形边时，
+// 返回该边反向延长线的方向角 (a 端从 a->b 逆时针量起，b 端从 b->a 顺时针量起)；
+// 侧边沿这个方向延伸，端点就得到 4 条边，一层层推进时四边形的走向保持一致。
+// 端点在区域边界上或已合并一侧的边数不为 1 时返回 -1
+float QmorphFront::through_angle(Index h, bool at_a) const {
+    const Index a = origin(h), b = target(h);
+    Index k = twin_[h];
+    if (k == kInvalid) return -1.0f;
+    int count = 0;
+    Index other = kInvalid;
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index e = at_a ? next(k) : prev(k);
+        const Index o = twin_[e];
+        if (o == kInvalid) return -1.0f;
+        if (free_[o / 3]) break;
+        if (partner_[k / 3] != o / 3) {
+            ++count;
+            other = at_a ? target(e) : origin(e);
+        }
+        k = o;
+    }
+    if (count != 1) return -1.0f;
+
+    const Index center = at_a ? a : b, ref = at_a ? b : a;
+    const glm::vec2 u = pos(ref) - pos(center);
+    const glm::vec2 v = pos(center) - pos(other);
+    float angle = std::atan2(u.x * v.y - u.y * v.x, glm::dot(u, v));
+    if (!at_a) angle = -angle;
+    return angle < 0.0f ? angle + 2.0f * kPi : angle;
+}
+
+// a 端的侧边：夹角较小时直接用相邻波前边；否则在 a 的扇形中找最接近理想方向的边，
+// 偏差过大时翻转理想方向所穿过三角形的对边，得到一条更接近理想方向的边
+QmorphFront::Index QmorphFront::choose_side_a(Index h, Index p, float theta) {
+    if (theta < options_.side_angle) return p;
+    const Index a = origin(h), b = target(h);
+    float ideal = through_angle(h, true);
+    if (ideal <= 0.0f || ideal >= theta) ideal = theta < 1.25f * kPi ? 0.5f * theta : 0.5f * kPi;
+
+    Index best = kInvalid, swap_edge = kInvalid;
+    float best_dev = 1e30f, prev_angle = 0.0f;
+    Index g = h;
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index y = origin(prev(g));
+        const float angle = ccw_angle(a, b, y);
+        const float dev = std::fabs(angle - ideal);
+        if (dev < best_dev) {
+            best_dev = dev;
+            best = y;
+        }
+        if (prev_angle <= ideal && ideal <= angle) swap_edge = next(g);
+        prev_angle = angle;
+        const Index t = twin_[prev(g)];
+        if (!is_free(t)) break;
+        g = t;
+    }
+    if (best_dev > options_.side_tolerance && swap_edge != kInvalid && can_flip(swap_edge)) {
+        const Index d = origin(prev(twin_[swap_edge]));
+        const float angle = ccw_angle(a, b, d);
+        if (angle > 0.0f && angle < theta && std::fabs(angle - ideal) <= options_.side_tolerance) {
+            flip(swap_edge);
+            best = d;
+        }
+    }
+    return best;
+}
+
+// b 端的侧边，与 choose_side_a 对称：绕 b 顺时针，角度从 b->a 方向顺时针量起
+QmorphFront::Index QmorphFront::choose_side_b(Index h, Index n, float theta) {
+    if (theta < options_.side_angle) return n;
+    const Index a = origin(h), b = target(h);
+    float ideal = through_angle(h, false);
+    if (ideal <= 0.0f || ideal >= theta) ideal = theta < 1.25f * kPi ? 0.5f * theta : 0.5f * kPi;
+
+    Index best = kInvalid, swap_edge = kInvalid;
+    float best_dev = 1e30f, prev_angle = 0.0f;
+    Index g = next(h);
+    for (int guard = 0; guard < kMaxWalk; ++guard) {
+        const Index x = target(g);
+        const float angle = ccw_angle(b, x, a);
+        const float dev = std::fabs(angle - ideal);
+        if (dev < best_dev) {
+            best_dev = dev;
+            best = x;
+        }
+        if (prev_angle <= ideal && ideal <= angle) swap_edge = next(g);
+        prev_angle = angle;
+        const Index t = twin_[g];
+        if (!is_free(t)) break;
+        g = next(t);
+    }
+    if (best_dev > options_.side_tolerance && swap_edge != kInvalid && can_flip(swap_edge)) {
+        const Index d = origin(prev(twin_[swap_edge]));
+        const float angle = ccw_angle(b, d, a);
+        if (angle > 0.0f && angle < theta && std::fabs(angle - ideal) <= options_.side_tolerance) {
+            flip(swap_edge);
+            best = d;
+        }
+    }
+    return best;
+}
+
+void QmorphFront::commit_quad(Index t0, Index t1, const MeshQuad& quad) {
+    free_[t0] = free_[t1] = 0;
+    partner_[t0] = t1;
+    partner_[t1] = t0;
+
+    int level = kUnsetLevel;
+    for (Index v : { quad.v0, quad.v1 }) level = std::min(level, level_[v]);
+    for (Index v : { quad.v0, quad.v1, quad.v2, quad.v3 }) level_[v] = std::min(level_[v], level + 1);
+
+    // 四边形另一侧尚未合并的边成为新的波前；相邻波前边的端点夹角也变了，重新入队
+    for (Index t : { t0, t1 }) {
+        for (Index h = 3 * t; h < 3 * t + 3; ++h) {
+            const Index o = twin_[h];
+            if (!is_free(o)) continue;
+            push_front(o);
+            push_front(front_prev(o));
+            push_front(front_next(o));
+        }
+    }
+}
+
+// 检查 a, b, s_b, s_a 是否恰好由两个未合并的三角形组成，且为严格凸四边形
+bool QmorphFront::try_quad(Index h, Index s_a, Index s_b) {
+    const Index a = origin(h), b = target(h), c = origin(prev(h));
+    Index other;
+    if (c == s_a) other = twin_[next(h)];
+    else if (c == s_b) other = twin_[prev(h)];
+    else return false;
+    if (!is_free(other)) return false;
+    const Index apex = origin(prev(other));
+    if (apex != (c == s_a ? s_b : s_a)) return false;
+
+    if (orient(a, b, s_b) <= 0.0 || orient(b, s_b, s_a) <= 0.0 ||
+        orient(s_b, s_a, a) <= 0.0 || orient(s_a, a, b) <= 0.0) return false;
+    if (quality_(pos(a), pos(b), pos(s_b), pos(s_a)) <= options_.min_quality) return false;
+
+    commit_quad(h / 3, other / 3, { a, b, s_b, s_a });
+    ++stats_.front_quads;
+    return true;
+}
+
+// 退化情形：直接与 h 所在三角形的某个未合并邻居合并，取质量较高的一侧
+bool QmorphFront::try_pair(Index h) {
+    const Index a = origin(h), b = target(h), c = origin(prev(h));
+    float best_quality = options_.min_quality;
+    Index best = kInvalid;
+    MeshQuad best_quad{};
+    // 跨过 b->c：(a, b, d, c)；跨过 c->a：(a, b, c, d)
+    for (Index e : { next(h), prev(h) }) {
+        const Index o = twin_[e];
+        if (!is_free(o)) continue;
+        const Index d = origin(prev(o));
+        const MeshQuad quad = (e == next(h)) ? MeshQuad{ a, b, d, c } : MeshQuad{ a, b, c, d };
+        if (orient(quad.v0, quad.v1, quad.v2) <= 0.0 || orient(quad.v1, quad.v2, quad.v3) <= 0.0 ||
+            orient(quad.v2, quad.v3, quad.v0) <= 0.0 || orient(quad.v3, quad.v0, quad.v1) <= 0.0) continue;
+        const float q = quality_(pos(quad.v0), pos(quad.v1), pos(quad.v2), pos(quad.v3));
+        if (q > best_quality) {
+            best_quality = q;
+            best = o;
+            best_quad = quad;
+        }
+    }
+    if (best == kInvalid) return false;
+    commit_quad(h / 3, best / 3, best_quad);
+    ++stats_.paired_quads;
+    return true;
+}
+
+// 按相反顺序翻转记录下的新边，恢复到这一步开始时的连接关系
+void QmorphFront::undo_flips() {
+    std::vector<std::pair<Index, Index>> log;
+    log.swap(flip_log_);
+    for (auto it = log.rbegin(); it != log.rend(); ++it) {
+        const Index h = find_half_edge(it->first, it->second);
+        if (h != kInvalid && twin_[h] != kInvalid) {
+            flip(h);
+            stats_.swaps -= 2;
+        }
+    }
+    flip_log_.clear();
+}
+
+bool QmorphFront::process(const FrontEntry& entry) {
+    const Index a = entry.a, b = entry.b;
+    Index h = find_half_edge(a, b);
+    const Index hp = front_prev(h), hn = front_next(h);
+    if (hp == kInvalid || hn == kInvalid) return false;
+    const Index p = origin(hp), n = target(hn);
+    if (p == n) return false; // 只剩一个三角形的波前环
+
+    // 1. 侧边：每次换边后重新定位 h，已选定的边加锁
+    locked_.clear();
+    flip_log_.clear();
+    locked_.push_back({ a, b });
+    const Index s_a = choose_side_a(h, p, ccw_angle(a, b, p));
+    locked_.push_back({ a, s_a });
+    h = find_half_edge(a, b);
+    const Index s_b = choose_side_b(h, n, ccw_angle(b, n, a));
+    locked_.push_back({ b, s_b });
+    h = find_half_edge(a, b);
+
+    // 2. 顶边：两侧边的端点不同时，换边恢复 s_a - s_b
+    if (s_a != kInvalid && s_b != kInvalid && s_a != s_b && s_a != b && s_b != a) {
+        if (recover_edge(s_a, s_b)) {
+            h = find_half_edge(a, b);
+            if (try_quad(h, s_a, s_b)) return true;
+        }
+    }
+
+    // 3. 侧边或顶边不可用：撤销这一步的换边，退化为与相邻三角形配对
+    undo_flips();
+    h = find_half_edge(a, b);
+    return try_pair(h);
+}
+
+void QmorphFront::run(const Mesh2D& mesh, QualityFn quality, std::vector<MeshTriangle>& triangles, std::vector<Index>& partner) {
+    quality_ = quality;
+    stats_ = Stats();
+    queue_ = std::priority_queue<FrontEntry>();
+
+    // --- 1. 把 Mesh2D 的三角形面复制成可换边的扁平数组 ---
+    xs_ = mesh.get_x();
+    ys_ = mesh.get_y();
+    const Index num_faces = static_cast<Index>(mesh.get_num_faces());
+    std::vector<Index> local(mesh.get_num_half_edges(), kInvalid);
+    tri_verts_.clear();
+    for (Index f = 0; f < num_faces; ++f) {
+        if (mesh.face_size(f) != 3) continue;
+        for (Index k = 0; k < 3; ++k) {
+            local[mesh.face_begin(f) + k] = static_cast<Index>(tri_verts_.size());
+            tri_verts_.push_back(mesh.face_vertex(f, k));
+        }
+    }
+    const Index num_tris = static_cast<Index>(tri_verts_.size() / 3);
+    twin_.assign(tri_verts_.size(), kInvalid);
+    for (Index hm = 0; hm < local.size(); ++hm) {
+        if (local[hm] == kInvalid || mesh.twin(hm) == Mesh2D::invalid_index) continue;
+        twin_[local[hm]] = local[mesh.twin(hm)];
+    }
+    free_.assign(num_tris, 1);
+    partner_.assign(num_tris, kInvalid);
+    vert_tri_.assign(xs_.size(), kInvalid);
+    for (Index h = 0; h < tri_verts_.size(); ++h) vert_tri_[tri_verts_[h]] = h / 3;
+
+    // --- 2. 边界边为第 0 层波前 ---
+    level_.assign(xs_.size(), kUnsetLevel);
+    for (Index h = 0; h < tri_verts_.size(); ++h) {
+        if (twin_[h] == kInvalid) level_[origin(h)] = level_[target(h)] = 0;
+    }
+    for (Index h = 0; h < tri_verts_.size(); ++h) {
+        if (twin_[h] == kInvalid) push_front(h);
+    }
+
+    // --- 3. 依优先级推进波前；出队时优先级已变差的边按新优先级重新入队 ---
+    while (!queue_.empty()) {
+        const FrontEntry entry = queue_.top();
+        queue_.pop();
+        const Index h = find_half_edge(entry.a, entry.b);
+        if (h == kInvalid || !is_front(h)) continue;
+        FrontEntry current;
+        if (!make_entry(h, current)) continue;
+        current.retries = entry.retries;
+        current.level += entry.retries;
+        if (current < entry) {
+            queue_.push(current);
+            continue;
+        }
+        if (process(current)) continue;
+
+        // 失败的边推迟一层再试：相邻的边先推进后，两端的夹角与可用的侧边都会改变
+        if (current.retries < options_.max_retries) {
+            ++current.retries;
+            ++current.level;
+            queue_.push(current);
+            ++stats_.retried;
+        }
+        else {
+            ++stats_.rejected;
+        }
+    }
+
+    // --- 4. 输出换边后的三角形与配对关系 ---
+    triangles.resize(num_tris);
+    for (Index t = 0; t < num_tris; ++t) {
+        triangles[t] = { tri_verts_[3 * t], tri_verts_[3 * t + 1], tri_verts_[3 * t + 2] };
+    }
+    partner = partner_;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <utility>
+#include <glm/glm.hpp>
+#include "Mesh2D.h"
+
+// 推进波前的 Q-Morph：从边界边出发，用优先队列按层、状态、长度依次处理波前边。
+// 每一步在波前边两端选取侧边 (必要时换边得到接近理想方向的侧边)，再换边恢复顶边，
+// 把侧边与顶边围成的两个三角形合并为四边形，四边形的新边成为新的波前。
+// 波前就是尚未合并区域的边界，不单独存储；三角形、半边、顶点的状态都放在扁平数组中
+class QmorphFront {
+public:
+    using Index = Mesh2D::Index;
+    // 四边形质量函数，顶点按逆时针传入
+    using QualityFn = float (*)(const glm::vec2&, const glm::vec2&, const glm::vec2&, const glm::vec2&);
+
+    struct Options {
+        float side_angle = 2.35619449f;     // 3π/4：端点处的波前夹角小于该值时直接用相邻的波前边作侧边
+        float side_tolerance = 0.52359878f; // π/6：侧边方向偏离理想方向超过该值时尝试换边
+        float min_quality = 0.05f;          // 生成四边形的最低质量
+        int max_recovery_swaps = 32;        // 一次边恢复中的最大换边次数
+        int max_retries = 2;                // 处理失败的波前边推迟一层后重试的次数
+    };
+    struct Stats {
+        size_t front_quads = 0;  // 按侧边/顶边生成的四边形
+        size_t paired_quads = 0; // 侧边不可用时与相邻三角形直接合并得到的四边形
+        size_t swaps = 0;
+        size_t retried = 0;      // 处理失败后推迟重新入队的次数
+        size_t rejected = 0;     // 重试用完仍无法处理而留下的波前边
+    };
+
+    QmorphFront() = default;
+
+    void set_options(const Options& options) { options_ = options; }
+    const Stats& get_stats() const { return stats_; }
+
+    // 输入三角网格 (Mesh2D 中的非三角形面被忽略)，输出换边后的全部三角形，
+    // partner[t] 为与三角形 t 合并成四边形的相邻三角形，未合并为 invalid_index。
+    // 换边只改变连接关系，不增删顶点，因此输出仍使用 mesh 的顶点编号
+    void run(const Mesh2D& mesh, QualityFn quality, std::vector<MeshTriangle>& triangles, std::vector<Index>& partner);
+
+private:
+    struct FrontEntry {
+        int level;
+        int state;    // 两端可以直接使用相邻波前边作侧边的个数
+        float length;
+        Index a, b;
+        int retries = 0; // 已推迟的次数，每推迟一次 level 加一
+        // 优先级：层数小的先处理，其次状态高的，再次边短的
+        bool operator<(const FrontEntry& o) const {
+            if (level != o.level) return level > o.level;
+            if (state != o.state) return state < o.state;
+            return length > o.length;
+        }
+    };
+
+    static Index next(Index h) { return (h % 3 == 2) ? h - 2 : h + 1; }
+    static Index prev(Index h) { return (h % 3 == 0) ? h + 2 : h - 1; }
+    Index origin(Index h) const { return tri_verts_[h]; }
+    Index target(Index h) const { return tri_verts_[next(h)]; }
+    bool is_free(Index h) const { return h != Mesh2D::invalid_index && free_[h / 3]; }
+    bool is_front(Index h) const { return free_[h / 3] && !is_free(twin_[h]); }
+    glm::vec2 pos(Index v) const { return glm::vec2(xs_[v], ys_[v]); }
+    double orient(Index a, Index b, Index c) const;
+    float ccw_angle(Index center, Index from, Index to) const;
+
+    Index find_half_edge(Index a, Index b) const;
+    bool edge_exists(Index a, Index b) const;
+    Index front_prev(Index h) const;
+    Index front_next(Index h) const;
+    bool make_entry(Index h, FrontEntry& entry) const;
+    void push_front(Index h);
+
+    bool is_locked(Index a, Index b) const;
+    bool can_flip(Index h) const;
+    Index flip(Index h);
+    bool collect_crossing(Index u, Index v, std::vector<std::pair<Index, Index>>& crossing) const;
+    bool recover_edge(Index u, Index v);
+    void undo_flips();
+
+    float through_angle(Index h, bool at_a) const;
+    Index choose_side_a(Index h, Index p, float theta);
+    Index choose_side_b(Index h, Index n, float theta);
+    bool try_quad(Index h, Index s_a, Index s_b);
+    bool try_pair(Index h);
+    void commit_quad(Index t0, Index t1, const MeshQuad& quad);
+    bool process(const FrontEntry& entry);
+
+    Options options_;
+    Stats stats_;
+    QualityFn quality_ = nullptr;
+
+    std::vector<float> xs_, ys_;    // 顶点坐标 (SoA)
+    std::vector<Index> tri_verts_;  // 每个三角形 3 个顶点，半边 3t+j 从第 j 个顶点指向第 j+1 个
+    std::vector<Index> twin_;       // 每条半边的反向半边，边界为 invalid_index
+    std::vector<std::uint8_t> free_; // 三角形是否尚未合并
+    std::vector<Index> partner_;    // 合并成四边形的另一个三角形
+    std::vector<Index> vert_tri_;   // 每个顶点的一个关联三角形，换边时维护
+    std::vector<int> level_;        // 顶点所在的波前层数
+    std::vector<std::pair<Index, Index>> locked_; // 当前步骤中不允许换掉的边
+    std::vector<std::pair<Index, Index>> flip_log_; // 当前步骤中换出的新边，失败时据此撤销
+    std::priority_queue<FrontEntry> queue_;
+};
@@ -1,109 +1,152 @@
 #include "Simulation2D.h"
 #include "Boundary.h"
 #include "Utils.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
 #include <random>
 #include <algorithm>
 #include <iostream>
 
 constexpr float PI = 3.1415926535f;
 
-// --- תֲϵ ---
+// --- 辅助函数：将向量转换到局部坐标系 ---
 glm::vec2 Simulation2D::transform_to_local(const glm::vec2& vec, const glm::mat2& rot_matrix) const {
-    // תת
+    // 旋转矩阵的逆是它的转置
     return glm::transpose(rot_matrix) * vec;
 }
 
 
 
-Simulation2D::Simulation2D(const Boundary& boundary) : boundary_(boundary) {
+Simulation2D::Simulation2D(const Boundary& boundary) : Simulation2D(boundary, 80.0f, 0) {}
+
+Simulation2D::Simulation2D(const Boundary& boundary, float grid_resolution, unsigned int seed) : boundary_(boundary) {
     const auto& aabb = boundary.get_aabb();
     float domain_width = aabb.z - aabb.x;
-    float grid_cell_size = domain_width / 80.0f;
+    float grid_cell_size = domain_width / grid_resolution;
     grid_ = std::make_unique<BackgroundGrid>(boundary, grid_cell_size);
-    initialize_particles(boundary);
+    initialize_particles(boundary, seed);
 }
 
 
-// --- ޸ģֲϵ ---
-void Simulation2D::compute_forces() {
-    for (auto& p : particles_) { p.force = glm::vec2(0.0f); }
-
-    for (int i = 0; i < num_particles_; ++i) {
-        for (int j = i + 1; j < num_particles_; ++j) {
-            glm::vec2 diff_global = particles_[i].position - particles_[j].position;
-            float h_avg = (particles_[i].smoothing_h + particles_[j].smoothing_h) * 0.5f;
+// --- 核心修改：在力计算中引入局部坐标系 ---
+glm::vec2 Simulation2D::pair_force(int i, int j) const {
+    glm::vec2 diff_global = particles_[i].position - particles_[j].position;
+    float h_avg = (particles_[i].smoothing_h + particles_[j].smoothing_h) * 0.5f;
 
-            // ؼȫλתiľֲϵ
-            glm::vec2 diff_local_i = transform_to_local(diff_global, particles_[i].rotation);
-            float r_inf = l_inf_norm(diff_local_i);
+    // 关键：将全局位移向量转换到粒子i的局部坐标系
+    glm::vec2 diff_local_i = transform_to_local(diff_global, particles_[i].rotation);
+    float r_inf = l_inf_norm(diff_local_i);
 
-            if (r_inf < 2.0f * h_avg) {
-                float q = r_inf / h_avg;
-                if (q > 1e-6) {
-                    float rho_t_i = particles_[i].target_density;
-                    float rho_t_j = particles_[j].target_density;
-                    float P_term = (stiffness_ / (rho_t_i * rho_t_i)) + (stiffness_ / (rho_t_j * rho_t_j));
-                    float W_grad_mag = wendland_c6_kernel_derivative(q, h_avg);
+    if (r_inf < 2.0f * h_avg) {
+        float q = r_inf / h_avg;
+        if (q > 1e-6) {
+            float rho_t_i = particles_[i].target_density;
+            float rho_t_j = particles_[j].target_density;
+            float P_term = (stiffness_ / (rho_t_i * rho_t_i)) + (stiffness_ / (rho_t_j * rho_t_j));
+            float W_grad_mag = wendland_c6_kernel_derivative(q, h_avg);
 
-                    // L޹һھֲϵ£
-                    glm::vec2 normalized_diff_local = diff_local_i / r_inf;
+            // L∞归一化向量（在局部坐标系下）
+            glm::vec2 normalized_diff_local = diff_local_i / r_inf;
 
-                    // ֲϵµ
-                    glm::vec2 force_local = -mass_ * mass_ * P_term * W_grad_mag * normalized_diff_local;
+            // 计算局部坐标系下的力
+            glm::vec2 force_local = -mass_ * mass_ * P_term * W_grad_mag * normalized_diff_local;
 
-                    // ؼֲתȫϵ
-                    glm::vec2 force_global = particles_[i].rotation * force_local;
+            // 关键：将局部力转换回全局坐标系
+            return particles_[i].rotation * force_local;
+        }
+    }
+    return glm::vec2(0.0f);
+}
 
-                    particles_[i].force += force_global;
-                    particles_[j].force -= force_global;
-                }
+// 计数：pair_tests 为实际计算的粒子对数 (并行时每对算两次)，interactions 为落在核函数支撑域内的粒子对数
+void Simulation2D::compute_forces() {
+    SPHMESH_PROFILE_SCOPE("step.compute_forces");
+    SPHMESH_PROFILE_ONLY(const uint64_t n = static_cast<uint64_t>(num_particles_);)
+    auto& scheduler = TaskScheduler::instance();
+    // 并行路径的计算量是串行的两倍 (见下)，两个线程时并不更快，所以至少三个线程才并行
+    if (scheduler.get_num_threads() <= 2) {
+        // 串行：每对粒子只算一次 (n(n-1)/2 次)，按作用力与反作用力同时累加到两个粒子上
+        SPHMESH_PROFILE_COUNT("pair_tests", n * (n - 1) / 2);
+        SPHMESH_PROFILE_ONLY(uint64_t interactions = 0;)
+        for (auto& p : particles_) { p.force = glm::vec2(0.0f); }
+        for (int i = 0; i < num_particles_; ++i) {
+            for (int j = i + 1; j < num_particles_; ++j) {
+                glm::vec2 force_global = pair_force(i, j);
+                SPHMESH_PROFILE_ONLY(interactions += (force_global.x != 0.0f || force_global.y != 0.0f);)
+                particles_[i].force += force_global;
+                particles_[j].force -= force_global;
             }
         }
+        SPHMESH_PROFILE_COUNT("interactions", interactions);
+        return;
     }
+    // 并行：每个粒子只写自己的合力，各行之间没有写冲突。代价是每对粒子被两行各算一次，
+    // 共 n(n-1) 次，仍是 O(n^2) 的全配对；由编号较小的粒子的局部坐标系计算，与串行结果一致
+    SPHMESH_PROFILE_COUNT("pair_tests", n * (n - 1));
+    scheduler.parallel_for(0, num_particles_, 64, [this](size_t lo, size_t hi) {
+        SPHMESH_PROFILE_ONLY(uint64_t interactions = 0;)
+        for (int i = static_cast<int>(lo); i < static_cast<int>(hi); ++i) {
+            glm::vec2 force(0.0f);
+            for (int j = 0; j < i; ++j) force -= pair_force(j, i);
+            for (int j = i + 1; j < num_particles_; ++j) {
+                const glm::vec2 f = pair_force(i, j);
+                SPHMESH_PROFILE_ONLY(interactions += (f.x != 0.0f || f.y != 0.0f);)
+                force += f;
+            }
+            particles_[i].force = force;
+        }
+        SPHMESH_PROFILE_COUNT("interactions", interactions);
+    });
 }
 
 
-// --- ޸ģλøº󣬸ӵķ ---
+// --- 核心修改：在位置更新后，更新粒子的方向 ---
 void Simulation2D::update_positions() {
-    for (auto& p : particles_) {
-        p.velocity += (p.force / mass_) * time_step_;
-        p.velocity *= damping_;
-        p.position += p.velocity * time_step_;
-
-        // ӱÿӵĿ
-        p.smoothing_h = grid_->get_target_size(p.position);
-        p.target_density = 1.0f / (p.smoothing_h * p.smoothing_h);
-
-        // ؼӵתԶ뷽
-        glm::vec2 target_dir = grid_->get_target_direction(p.position);
-        glm::vec2 current_dir = p.rotation[0]; // ֲX
-
-        // ʹֵƽתĿ귽򣬷ֹ
-        glm::vec2 new_dir = glm::normalize(current_dir + (target_dir - current_dir) * 0.1f);
-
-        p.rotation[0] = new_dir;
-        p.rotation[1] = glm::vec2(-new_dir.y, new_dir.x); // 
-    }
+    SPHMESH_PROFILE_SCOPE("step.update_positions");
+    // 每个粒子两次背景网格查询 (目标尺寸与方向)
+    SPHMESH_PROFILE_COUNT("grid_lookups", 2 * particles_.size());
+    TaskScheduler::instance().parallel_for(0, particles_.size(), 256, [this](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            auto& p = particles_[i];
+            p.velocity += (p.force / mass_) * time_step_;
+            p.velocity *= damping_;
+            p.position += p.velocity * time_step_;
+
+            // 从背景网格更新每个粒子的目标参数
+            p.smoothing_h = grid_->get_target_size(p.position);
+            p.target_density = 1.0f / (p.smoothing_h * p.smoothing_h);
+
+            // 关键：更新粒子的旋转矩阵以对齐方向场
+            glm::vec2 target_dir = grid_->get_target_direction(p.position);
+            glm::vec2 current_dir = p.rotation[0]; // 局部X轴
+
+            // 使用少量插值平滑地转向目标方向，防止抖动
+            glm::vec2 new_dir = glm::normalize(current_dir + (target_dir - current_dir) * 0.1f);
+
+            p.rotation[0] = new_dir;
+            p.rotation[1] = glm::vec2(-new_dir.y, new_dir.x); // 保持正交
+        }
+    });
 }
 
 
 
 
-// ... (compute_forces, update_positions, step, get_particle_positions ֲ) ...
+// ... (compute_forces, update_positions, step, get_particle_positions 保持不变) ...
 
 
-void Simulation2D::initialize_particles(const Boundary& boundary) {
+void Simulation2D::initialize_particles(const Boundary& boundary, unsigned int seed) {
+    SPHMESH_PROFILE_SCOPE("sim.initialize_particles");
     particles_.clear();
     const glm::vec4& aabb = boundary.get_aabb();
-    std::mt19937 rng(std::random_device{}());
-    std::uniform_real_distribution<float> dist(-0.25f, 0.25f);
+    std::mt19937 rng(seed ? seed : std::random_device{}());
 
-    // ʹñĿߴ
+    // 使用背景网格的目标尺寸来决定播撒步长
     for (float y = aabb.y; y <= aabb.w; ) {
         float current_h_y = grid_->get_target_size({ aabb.x, y });
         for (float x = aabb.x; x <= aabb.z; ) {
             float current_h_x = grid_->get_target_size({ x, y });
-            glm::vec2 pos = { x + dist(rng) * current_h_x, y + dist(rng) * current_h_y };
+            glm::vec2 pos = { x + seeded_uniform(rng, -0.25f, 0.25f) * current_h_x, y + seeded_uniform(rng, -0.25f, 0.25f) * current_h_y };
             if (boundary.is_inside(pos)) {
                 float h_t = grid_->get_target_size(pos);
                 particles_.emplace_back(Particle{ pos, {}, {}, h_t, 1.0f / (h_t * h_t) });
@@ -115,10 +158,11 @@ void Simulation2D::initialize_particles(const Boundary& boundary) {
 
     num_particles_ = particles_.size();
     positions_for_render_.resize(num_particles_);
+    for (int i = 0; i < num_particles_; ++i) positions_for_render_[i] = particles_[i].position;
     std::cout << "Generated " << num_particles_ << " adaptive particles." << std::endl;
 }
 
-float Simulation2D::wendland_c6_kernel(float q, float h) {
+float Simulation2D::wendland_c6_kernel(float q, float h) const {
     if (q >= 0.0f && q < 2.0f) {
         float term = 1.0f - q / 2.0f;
         float term_sq = term * term;
@@ -129,7 +173,7 @@ float Simulation2D::wendland_c6_kernel(float q, float h) {
     return 0.0f;
 }
 
-float Simulation2D::wendland_c6_kernel_derivative(float q, float h) {
+float Simulation2D::wendland_c6_kernel_derivative(float q, float h) const {
     if (q > 1e-6f && q < 2.0f) {
         float term = 1.0f - q / 2.0f;
         float term_sq = term * term;
@@ -150,20 +194,58 @@ float Simulation2D::l_inf_norm(const glm::vec2& v) const {
 
 
 
+// 利用背景网格中的 SDF 做 O(1) 的内外判断：
+// 明确在内部 (d > band) 的粒子直接跳过；明确在外部 (d < -band) 的粒子沿 SDF 梯度做牛顿投影；
+// 只有落在窄带 |d| <= band 内的粒子才回退到精确的多边形判断和最近点投影
 void Simulation2D::handle_boundaries(const Boundary& boundary) {
-    for (auto& p : particles_) {
-        if (!boundary.is_inside(p.position)) {
-            p.position = closest_point_on_polygon(p.position, boundary.get_vertices());
-            p.velocity *= -0.5f;
+    SPHMESH_PROFILE_SCOPE("step.handle_boundaries");
+    const float band = grid_->get_sdf_band();
+    // 粒子之间互不影响，SDF 与多边形查询都是只读的
+    TaskScheduler::instance().parallel_for(0, particles_.size(), 256, [&](size_t lo, size_t hi) {
+        // 计数：SDF 牛顿投影、窄带内的精确内外判断、精确最近点投影
+        SPHMESH_PROFILE_ONLY(uint64_t sdf_projections = 0, exact_tests = 0, exact_projections = 0;)
+        for (size_t i = lo; i < hi; ++i) {
+            auto& p = particles_[i];
+            bool escaped = false;
+            // 网格范围之外没有可信的 SDF，按窄带处理
+            float d = grid_->covers(p.position) ? grid_->get_signed_distance(p.position) : 0.0f;
+            if (d > band) continue;
+            if (d < -band) {
+                // 牛顿迭代：x <- x - d * grad / |grad|^2，把粒子推到零等值线附近
+                glm::vec2 x = p.position;
+                for (int it = 0; it < 4 && d < -0.1f * band; ++it) {
+                    glm::vec2 g = grid_->get_sdf_gradient(x);
+                    float g_len_sq = glm::dot(g, g);
+                    if (g_len_sq < 1e-8f) break;
+                    x -= (d / g_len_sq) * g;
+                    d = grid_->get_signed_distance(x);
+                }
+                p.position = x;
+                escaped = true;
+                SPHMESH_PROFILE_ONLY(++sdf_projections;)
+            }
+            // 窄带内 (包括投影后因插值误差仍略在外部的粒子) 使用精确的多边形判断
+            SPHMESH_PROFILE_ONLY(exact_tests += (d <= band);)
+            if (d <= band && !boundary.is_inside(p.position)) {
+                p.position = boundary.closest_point(p.position);
+                escaped = true;
+                SPHMESH_PROFILE_ONLY(++exact_projections;)
+            }
+            if (escaped) p.velocity *= -0.5f;
         }
-    }
+        SPHMESH_PROFILE_COUNT("boundary_sdf_projections", sdf_projections);
+        SPHMESH_PROFILE_COUNT("boundary_exact_tests", exact_tests);
+        SPHMESH_PROFILE_COUNT("boundary_exact_projections", exact_projections);
+    });
 }
 
 void Simulation2D::step() {
     if (num_particles_ == 0) return;
+    SPHMESH_PROFILE_SCOPE("step");
     compute_forces();
     update_positions();
     handle_boundaries(boundary_);
+    SPHMESH_PROFILE_SCOPE("step.render_copy");
     for (int i = 0; i < num_particles_; ++i) {
         positions_for_render_[i] = particles_[i].position;
     }
@@ -173,11 +255,14 @@ const std::vector<glm::vec2>& Simulation2D::get_particle_positions() const {
     return positions_for_render_;
 }
 
-// ʵ
+// 新增函数实现
 float Simulation2D::get_kinetic_energy() const {
-    float total_energy = 0.0f;
-    for (const auto& p : particles_) {
-        total_energy += 0.5f * mass_ * glm::dot(p.velocity, p.velocity);
-    }
-    return total_energy;
+    // 分块与线程数无关，结果可复现
+    return TaskScheduler::instance().parallel_reduce(0, particles_.size(), 4096, 0.0f,
+        [this](size_t lo, size_t hi) {
+            float energy = 0.0f;
+            for (size_t i = lo; i < hi; ++i) energy += 0.5f * mass_ * glm::dot(particles_[i].velocity, particles_[i].velocity);
+            return energy;
+        },
+        [](float a, float b) { return a + b; });
 }
\ No newline at end of file
@@ -15,31 +15,37 @@ public:
         glm::vec2 force = glm::vec2(0.0f);
         float smoothing_h = 0.0f;
         float target_density = 0.0f;
-        glm::mat2 rotation = glm::mat2(1.0f); // ֲϵת
+        glm::mat2 rotation = glm::mat2(1.0f); // 新增：局部坐标系的旋转矩阵
 		bool is_boundary = false;
     };
 
     Simulation2D(const Boundary& boundary);
+    // 新增：grid_resolution 为包围盒宽度方向的背景网格单元数 (默认 80)，粒子数约与其平方成正比；
+    // seed 固定初始粒子的随机扰动，0 表示使用随机种子
+    Simulation2D(const Boundary& boundary, float grid_resolution, unsigned int seed);
     void step();
+    // 单独的力计算阶段，step() 的第一步；公开以便基准测试单独计时
+    void compute_forces();
     const std::vector<glm::vec2>& get_particle_positions() const;
     const std::vector<Particle>& get_particles() const { return particles_; }
-    // ϵͳܶܣж
+    // 新增：计算系统总动能，用于收敛判断
     float get_kinetic_energy() const;
-    // ṩԱķ
+    // 新增：提供对背景网格的访问
     BackgroundGrid* get_background_grid() const { return grid_.get(); }
-    float get_min_target_size() const { return h_min_; } // <-- 
+    float get_min_target_size() const { return h_min_; } // <-- 新增
 
 private:
-    void initialize_particles(const Boundary& boundary);
-    void compute_forces();
+    void initialize_particles(const Boundary& boundary, unsigned int seed);
     void update_positions();
     void handle_boundaries(const Boundary& boundary);
 
-    // 
+    // 辅助函数
+    // 粒子 j 作用在粒子 i 上的力 (在 i 的局部坐标系中计算)，j 受到的反作用力为其相反数
+    glm::vec2 pair_force(int i, int j) const;
     glm::vec2 transform_to_local(const glm::vec2& vec, const glm::mat2& rot_matrix) const;
     float l_inf_norm(const glm::vec2& v) const;
-    float wendland_c6_kernel(float q, float h);
-    float wendland_c6_kernel_derivative(float q, float h);
+    float wendland_c6_kernel(float q, float h) const;
+    float wendland_c6_kernel_derivative(float q, float h) const;
 
     std::vector<Particle> particles_;
     std::vector<glm::vec2> positions_for_render_;
@@ -47,11 +53,11 @@ private:
     std::unique_ptr<BackgroundGrid> grid_;
     int num_particles_ = 0;
 
-    // SPH ģ
+    // SPH 模拟参数
     float time_step_ = 0.005f;
     float mass_ = 1.0f;
-    float stiffness_ = 1.0f;//releaceģʽ1.0f
+    float stiffness_ = 1.0f;//releace模式1.0f好用
     float damping_ = 0.998f;
-    float h_max_;             // Ŀߴ
-    float h_min_;             // <-- ȱʧ
+    float h_max_;             // 最大目标尺寸
+    float h_min_;             // <-- 新增：补上这个缺失的声明
 };
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "TaskScheduler.h"
+#include <chrono>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 当前线程所属的任务池及其在池中的序号，不属于任何任务池的线程为 -1
+thread_local const TaskScheduler* tls_scheduler = nullptr;
+thread_local int tls_index = -1;
+
+// 等待任务组时找不到可执行任务的情况下，休眠前先让出时间片的次数
+constexpr int kWaitSpins = 64;
+
+uint64_t elapsed_ns(Clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+void TaskScheduler::TaskGroup::execute(const Task& task) {
+    try {
+        task();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_) error_ = std::current_exception();
+    }
+}
+
+void TaskScheduler::TaskGroup::run(Task task) {
+    // 没有工作线程时直接在调用线程上执行，串行路径不经过队列
+    if (scheduler_.workers_.empty()) {
+        execute(task);
+        return;
+    }
+    ++pending_;
+    scheduler_.push([this, task = std::move(task)] {
+        execute(task);
+        // 计数归零之后 wait() 可能返回并销毁任务组，之后只能访问任务池
+        TaskScheduler& scheduler = scheduler_;
+        if (pending_.fetch_sub(1) == 1) {
+            // 在 sleep_mutex_ 下唤醒：等待者检查计数与进入休眠之间不会漏掉通知
+            std::lock_guard<std::mutex> lock(scheduler.sleep_mutex_);
+            scheduler.wake_.notify_all();
+        }
+    });
+}
+
+void TaskScheduler::TaskGroup::wait_pending() {
+    int spins = 0;
+    while (pending_.load() > 0) {
+        if (scheduler_.run_one()) {
+            spins = 0;
+            continue;
+        }
+        if (++spins < kWaitSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        // 有新任务入队时也要醒来帮忙，否则所有线程都在等待时嵌套的子任务没人执行
+        std::unique_lock<std::mutex> lock(scheduler_.sleep_mutex_);
+        scheduler_.wake_.wait(lock, [this] { return pending_.load() == 0 || scheduler_.queued_.load() > 0; });
+        spins = 0;
+    }
+}
+
+void TaskScheduler::TaskGroup::wait() {
+    wait_pending();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        std::swap(error, error_);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(unsigned int num_threads) {
+    start(num_threads);
+}
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+void TaskScheduler::set_num_threads(unsigned int num_threads) {
+    stop();
+    start(num_threads);
+}
+
+void TaskScheduler::start(unsigned int num_threads) {
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max(1u, num_threads);
+    stop_ = false;
+    for (unsigned int k = 1; k < num_threads; ++k) workers_.push_back(std::make_unique<Worker>());
+    for (unsigned int k = 0; k + 1 < num_threads; ++k) threads_.emplace_back(&TaskScheduler::worker_loop, this, static_cast<int>(k));
+}
+
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+    workers_.clear();
+}
+
+void TaskScheduler::push(Task task) {
+    Worker& target = (tls_scheduler == this && tls_index >= 0) ? *workers_[tls_index] : external_;
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    {
+        // 计数在 sleep_mutex_ 下增加，工作线程检查条件与进入休眠之间不会漏掉唤醒
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        ++queued_;
+    }
+    wake_.notify_one();
+}
+
+bool TaskScheduler::find_task(int self, Task& task) {
+    if (queued_.load() == 0) return false;
+    auto take = [&](Worker& worker, bool back) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) return false;
+        if (back) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+        else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        return true;
+    };
+
+    bool found = (self >= 0 && take(*workers_[self], true)) || take(external_, false);
+    const int n = static_cast<int>(workers_.size());
+    for (int k = 1; !found && k <= n; ++k) {
+        const int victim = (std::max(self, 0) + k) % n;
+        if (victim == self) continue;
+        found = take(*workers_[victim], false);
+        if (found && self >= 0) ++workers_[self]->steals;
+    }
+    if (found) --queued_;
+    return found;
+}
+
+bool TaskScheduler::run_one() {
+    const int self = (tls_scheduler == this) ? tls_index : -1;
+    Task task;
+    if (!find_task(self, task)) return false;
+    task();
+    if (self >= 0) ++workers_[self]->executed;
+    else ++helped_;
+    return true;
+}
+
+void TaskScheduler::worker_loop(int index) {
+    tls_scheduler = this;
+    tls_index = index;
+    Worker& self = *workers_[index];
+    while (true) {
+        Task task;
+        if (find_task(index, task)) {
+            const auto start = Clock::now();
+            task();
+            self.busy_ns += elapsed_ns(start);
+            ++self.executed;
+            continue;
+        }
+        const auto start = Clock::now();
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        self.idle_ns += elapsed_ns(start);
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
+
+TaskScheduler::Stats TaskScheduler::get_stats() const {
+    Stats stats;
+    stats.tasks = helped_.load();
+    for (const auto& worker : workers_) {
+        stats.tasks += worker->executed.load();
+        stats.steals += worker->steals.load();
+        stats.busy_ms += worker->busy_ns.load() * 1e-6;
+        stats.idle_ms += worker->idle_ns.load() * 1e-6;
+    }
+    return stats;
+}
+
+void TaskScheduler::reset_stats() {
+    helped_ = 0;
+    for (auto& worker : workers_) {
+        worker->executed = 0;
+        worker->steals = 0;
+        worker->busy_ns = 0;
+        worker->idle_ns = 0;
+    }
+}
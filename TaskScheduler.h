@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+
+// 全项目共享的工作窃取任务池：每个工作线程有自己的双端队列，自己从尾部取 (后进先出，缓存友好)，
+// 空闲时从其他队列的头部窃取 (先进先出，拿到的是较大的子区间)。
+// 等待任务组的线程 (包括不属于任务池的调用线程) 在等待期间也执行任务，嵌套并行不会死锁，
+// 也不会在任务池之外另开线程。线程数为 1 时所有任务都在调用线程上串行执行
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    // 调度统计：idle 为工作线程找不到任务而休眠的时间，efficiency = busy / (busy + idle)
+    struct Stats {
+        uint64_t tasks = 0;
+        uint64_t steals = 0;
+        double busy_ms = 0.0;
+        double idle_ms = 0.0;
+        double efficiency() const { return busy_ms + idle_ms > 0.0 ? busy_ms / (busy_ms + idle_ms) : 1.0; }
+    };
+
+    // 一组任务，wait() 返回时组内 (包括任务中再提交的) 任务全部完成。
+    // 任务抛出的异常不会终止工作线程，组内第一个异常由 wait() 重新抛出
+    class TaskGroup {
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance()) : scheduler_(scheduler) {}
+        // 析构时只等待，不抛出异常
+        ~TaskGroup() { wait_pending(); }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void run(Task task);
+        void wait();
+
+    private:
+        // 执行任务，捕获异常并记录到 error_
+        void execute(const Task& task);
+        // 帮助执行任务直到组内任务全部完成；没有可执行的任务时先短暂自旋，再休眠到有新任务或组完成
+        void wait_pending();
+
+        TaskScheduler& scheduler_;
+        std::atomic<size_t> pending_{ 0 };
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+    };
+
+    // 进程内共享的任务池，第一次使用时按硬件线程数创建
+    static TaskScheduler& instance();
+
+    // num_threads 为并发度 (含等待中的调用线程)，0 表示硬件线程数
+    explicit TaskScheduler(unsigned int num_threads = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // 重新创建工作线程，只能在没有任务运行时调用
+    void set_num_threads(unsigned int num_threads);
+    unsigned int get_num_threads() const { return static_cast<unsigned int>(workers_.size()) + 1; }
+
+    Stats get_stats() const;
+    void reset_stats();
+
+    // 把 [begin, end) 递归二分为不超过 grain 的子区间，func(lo, hi) 处理一个子区间
+    template <typename Func>
+    void parallel_for(size_t begin, size_t end, size_t grain, const Func& func) {
+        if (end <= begin) return;
+        grain = std::max<size_t>(1, grain);
+        if (end - begin <= grain || workers_.empty()) {
+            func(begin, end);
+            return;
+        }
+        TaskGroup group(*this);
+        split_range(group, begin, end, grain, func);
+        group.wait();
+    }
+
+    // 按固定的 grain 分块，map(lo, hi) 得到每块的部分结果，再按块的顺序用 reduce 合并；
+    // 分块与线程数无关，浮点累加的结果可以复现
+    template <typename T, typename Map, typename Reduce>
+    T parallel_reduce(size_t begin, size_t end, size_t grain, T identity, const Map& map, const Reduce& reduce) {
+        if (end <= begin) return identity;
+        grain = std::max<size_t>(1, grain);
+        const size_t num_chunks = (end - begin + grain - 1) / grain;
+        std::vector<T> partial(num_chunks, identity);
+        parallel_for(0, num_chunks, 1, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                partial[c] = map(begin + c * grain, std::min(end, begin + (c + 1) * grain));
+            }
+        });
+        T result = identity;
+        for (auto& value : partial) result = reduce(result, value);
+        return result;
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<uint64_t> busy_ns{ 0 }, idle_ns{ 0 }, executed{ 0 }, steals{ 0 };
+    };
+
+    template <typename Func>
+    void split_range(TaskGroup& group, size_t begin, size_t end, size_t grain, const Func& func) {
+        while (end - begin > grain) {
+            const size_t mid = begin + (end - begin) / 2;
+            group.run([this, &group, mid, end, grain, &func] { split_range(group, mid, end, grain, func); });
+            end = mid;
+        }
+        func(begin, end);
+    }
+
+    void start(unsigned int num_threads);
+    void stop();
+    void push(Task task);
+    // 依次尝试：本线程的队列尾部、外部提交队列、其他工作线程队列的头部
+    bool find_task(int self, Task& task);
+    // 等待中的线程执行一个任务，没有可执行的任务时返回 false
+    bool run_one();
+    void worker_loop(int index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    Worker external_; // 非工作线程提交的任务
+    std::atomic<uint64_t> helped_{ 0 }; // 等待中的线程执行的任务数
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_{ 0 };
+    bool stop_ = false;
+};
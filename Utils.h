@@ -2,8 +2,12 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <random>
 
-// Ϊ inlineԱضӴ
+// 将辅助函数设为 inline，以避免多重定义链接错误
 inline glm::vec2 closest_point_on_segment(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b) {
     glm::vec2 ab = b - a;
     glm::vec2 ap = p - a;
@@ -20,7 +24,7 @@ inline glm::vec2 closest_point_on_polygon(const glm::vec2& p, const std::vector<
     if (vertices.empty()) return p;
     glm::vec2 closest_point = vertices[0];
     float min_dist_sq = FLT_MAX;
-    // ؼ޸ʹ j = i++  i = j++
+    // 关键错误修复：使用 j = i++ 而不是 i = j++
     for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
         glm::vec2 closest_pt_on_edge = closest_point_on_segment(p, vertices[j], vertices[i]);
         float dist_sq = glm::dot(p - closest_pt_on_edge, p - closest_pt_on_edge);
@@ -30,4 +34,29 @@ inline glm::vec2 closest_point_on_polygon(const glm::vec2& p, const std::vector<
         }
     }
     return closest_point;
-}
\ No newline at end of file
+}
+
+// 由 mt19937 的原始输出得到 [min, max] 内的浮点数。std::uniform_real_distribution 的算法由标准库决定，
+// 不同标准库下同一种子会得到不同的数；mt19937 的输出序列由标准规定，需要可复现的输入时用这个函数
+inline float seeded_uniform(std::mt19937& rng, float min, float max) {
+    return min + (max - min) * (static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f));
+}
+
+// 命令行参数解析：整个字符串都是合法数字且不越界时写入 value 并返回 true，否则 value 不变
+inline bool parse_float(const char* text, float& value) {
+    char* end = nullptr;
+    errno = 0;
+    const float parsed = std::strtof(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE) return false;
+    value = parsed;
+    return true;
+}
+
+inline bool parse_int(const char* text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
@@ -1,20 +1,24 @@
 #include "Viewer.h"
+#include "MeshQuality.h"
+#include "MeshRenumbering.h"
+#include "MeshExporter.h"
+#include "Profiler.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <vector>
 #include <algorithm>
 
-// --- 캯־ļ ---
+// --- 构造函数：打开日志文件 ---
 Viewer::Viewer(int width, int height, const std::string& title)
     : width_(width), height_(height), title_(title), window_(nullptr) {
     init();
     convergence_log_.open("convergence_log.csv");
     if (convergence_log_.is_open()) {
-        convergence_log_ << "Step,KineticEnergy\n"; // дCSVͷ
+        convergence_log_ << "Step,KineticEnergy\n"; // 写入CSV表头
     }
 }
 
-// --- ر־ļ ---
+// --- 析构函数：关闭日志文件 ---
 Viewer::~Viewer() {
     delete shader_;
     delete point_shader_;
@@ -26,6 +30,11 @@ Viewer::~Viewer() {
     if (convergence_log_.is_open()) {
         convergence_log_.close();
     }
+    // 新增：以 SPHMESH_PROFILE 编译时，退出时输出各阶段的耗时与计数
+    if (Profiler::enabled()) {
+        Profiler::instance().print(std::cout);
+        Profiler::instance().save_json("profile.json");
+    }
     glfwTerminate();
 }
 
@@ -41,7 +50,7 @@ void Viewer::set_background_grid(BackgroundGrid* grid) {
 
 
 
-// --- ѭ߼ ---
+// --- 主循环：添加新逻辑 ---
 void Viewer::main_loop() {
     while (!glfwWindowShouldClose(window_)) {
         if (glfwGetKey(window_, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -53,7 +62,12 @@ void Viewer::main_loop() {
             if (step_count_ % 10 == 0 && convergence_log_.is_open()) {
                 convergence_log_ << step_count_ << "," << sim2d_->get_kinetic_energy() << "\n";
             }
+            // 后台重剖分 (含 M 键的实时重剖分)：只提交快照，网格在工作线程上增量更新
+            if (async_remesher_ && step_count_ % remesh_interval_ == 0) {
+                async_remesher_->submit(sim2d_->get_particles(), step_count_);
+            }
         }
+        poll_async_mesh();
 
         update_particle_buffers();
 
@@ -76,12 +90,16 @@ void Viewer::main_loop() {
 
                 glBindVertexArray(VAO_mesh_);
 
-                // ʣ
-                if (!delaunay_generator_->get_triangles().empty()) {
+                // 四边形视图：EBO 中是四边形与剩余三角形的线框索引
+                if (current_view_ == ViewMode::Quads) {
+                    if (mesh_line_index_count_ > 0) glDrawElements(GL_LINES, mesh_line_index_count_, GL_UNSIGNED_INT, 0);
+                }
+                // 绘制剩余的三角形
+                else if (!delaunay_generator_->get_triangles().empty()) {
                     glDrawElements(GL_TRIANGLES, delaunay_generator_->get_triangles().size() * 3, GL_UNSIGNED_INT, 0);
                 }
 
-                // ı (Ҫ EBO)
+                // 绘制四边形 (需要更新 EBO)
                 if (!delaunay_generator_->get_quads().empty()) {
                     std::vector<unsigned int> quad_line_indices;
                     for (const auto& q : delaunay_generator_->get_quads()) {
@@ -99,7 +117,7 @@ void Viewer::main_loop() {
         }
         
         else if (show_size_field_) {
-            // --- ƴС ---
+            // --- 绘制大小场 ---
             if (grid_ && size_field_shader_) {
                 size_field_shader_->use();
                 size_field_shader_->setMat4("view", view);
@@ -114,19 +132,19 @@ void Viewer::main_loop() {
                 glBindVertexArray(VAO_size_field_);
                 glDrawArrays(GL_TRIANGLES, 0, grid_->get_width() * grid_->get_height() * 6);
             }
-            // --- ڴС֮ϵӱ߽ ---
+            // --- 在大小场之上叠加边界线 ---
             if (boundary_ && shader_) {
                 shader_->use();
                 shader_->setMat4("view", view);
                 shader_->setMat4("projection", projection);
                 glLineWidth(1.0f);
                 glBindVertexArray(VAO_boundary_);
-                glDrawArrays(GL_LINE_LOOP, 0, boundary_->get_vertices().size());
+                draw_boundary_rings();
             }
         }
         
         else {
-            // Ʊ߽
+            // 绘制边界
             if (boundary_ && shader_) {
                 shader_->use();
                 shader_->setMat4("model", model);
@@ -134,10 +152,10 @@ void Viewer::main_loop() {
                 shader_->setMat4("projection", projection);
                 glLineWidth(1.0f);
                 glBindVertexArray(VAO_boundary_);
-                glDrawArrays(GL_LINE_LOOP, 0, boundary_->get_vertices().size());
+                draw_boundary_rings();
                 glLineWidth(1.0f);
             }
-            // 
+            // 绘制粒子
             if (sim2d_ && point_shader_) {
                 point_shader_->use();
                 shader_->setMat4("model", model);
@@ -158,26 +176,27 @@ void Viewer::main_loop() {
 
 
 
-// ---  ---
+// --- 新增函数 ---
 
 void Viewer::update_mesh_buffers() {
-    if (!delaunay_generator_ || delaunay_generator_->get_vertices().empty()) return;
+    if (!delaunay_generator_) return;
+    // 更新顶点数据 (全四边形细分会新增顶点，此时四边形视图使用转换结果自带的顶点)
+    const auto& vertices = (current_view_ == ViewMode::Quads && !quad_vertices_.empty()) ? quad_vertices_ : delaunay_generator_->get_vertices();
+    if (vertices.empty()) return;
 
     glBindVertexArray(VAO_mesh_);
-
-    // ¶
     glBindBuffer(GL_ARRAY_BUFFER, VBO_mesh_);
-    glBufferData(GL_ARRAY_BUFFER, delaunay_generator_->get_vertices().size() * sizeof(glm::vec2), delaunay_generator_->get_vertices().data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(), GL_STATIC_DRAW);
 
-    //  (EBO)
-    // ݵǰͼģʽ EBO 
+    // 更新索引数据 (EBO)
+    // 根据当前视图模式决定 EBO 的内容
     if (current_view_ == ViewMode::Triangles) {
         const auto& tris = delaunay_generator_->get_triangles();
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_mesh_);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, tris.size() * sizeof(CGALMeshGenerator::Triangle), tris.data(), GL_STATIC_DRAW);
     }
     else if (current_view_ == ViewMode::Quads) {
-        // ıΣҪΪ߿ģʽߵ
+        // 对于四边形，我们需要为线框模式创建边的索引
         std::vector<unsigned int> line_indices;
         line_indices.reserve(quads_.size() * 8 + remaining_triangles_.size() * 6);
         for (const auto& q : quads_) {
@@ -193,6 +212,7 @@ void Viewer::update_mesh_buffers() {
         }
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_mesh_);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, line_indices.size() * sizeof(unsigned int), line_indices.data(), GL_DYNAMIC_DRAW);
+        mesh_line_index_count_ = line_indices.size();
     }
 
     glBindVertexArray(0);
@@ -238,6 +258,84 @@ void Viewer::save_particle_snapshot() {
     }
 }
 
+void Viewer::export_mesh() {
+    if (!delaunay_generator_ || (delaunay_generator_->get_vertices().empty() && quad_vertices_.empty())) {
+        std::cerr << "Error: No mesh to export, press 'C' to generate one first." << std::endl;
+        return;
+    }
+    // 后台重剖分时，文件名使用网格对应的模拟步而不是当前步
+    const std::string base = "mesh_step_" + std::to_string(async_remesher_ && async_mesh_ ? async_mesh_->step : step_count_);
+    if (current_view_ == ViewMode::Quads) {
+        const auto& vertices = quad_vertices_.empty() ? delaunay_generator_->get_vertices() : quad_vertices_;
+        MeshExporter::save(base + ".msh", vertices, remaining_triangles_, quads_);
+        MeshExporter::save(base + ".vtu", vertices, remaining_triangles_, quads_);
+    }
+    else {
+        const std::vector<CGALMeshGenerator::Quad> no_quads;
+        MeshExporter::save(base + ".msh", delaunay_generator_->get_vertices(), delaunay_generator_->get_triangles(), no_quads);
+        MeshExporter::save(base + ".vtu", delaunay_generator_->get_vertices(), delaunay_generator_->get_triangles(), no_quads);
+    }
+}
+
+void Viewer::toggle_async_remesh(bool convert_quads) {
+    const char* name = convert_quads ? "Async remesh" : "Live remesh";
+    if (async_remesher_ && async_quads_ == convert_quads) {
+        async_remesher_.reset(); // 等待正在处理的快照完成后退出工作线程
+        async_mesh_.reset();
+        std::cout << name << ": OFF" << std::endl;
+        return;
+    }
+    async_quads_ = convert_quads;
+    // 已在运行时只切换是否做四边形转换，对下一份快照生效
+    if (async_remesher_) {
+        sync_async_options();
+        std::cout << name << ": ON" << std::endl;
+        return;
+    }
+    if (!delaunay_generator_ || !sim2d_ || !boundary_) {
+        std::cerr << "Error: " << name << " needs a simulation, a boundary and a mesh generator." << std::endl;
+        return;
+    }
+    async_remesher_ = std::make_unique<AsyncRemesher>(*boundary_);
+    sync_async_options();
+    async_mesh_.reset();
+    quads_.clear();
+    remaining_triangles_.clear();
+    quad_vertices_.clear();
+    mesh_line_index_count_ = 0;
+    current_view_ = ViewMode::Quads;
+    show_size_field_ = false;
+    show_mesh_ = true;
+    async_remesher_->submit(sim2d_->get_particles(), step_count_);
+    std::cout << name << ": ON" << std::endl;
+}
+
+// Q/L 键修改的转换方式与光顺方式同步到后台流水线，对下一份快照生效
+void Viewer::sync_async_options() {
+    if (!async_remesher_) return;
+    AsyncRemesher::Options options = async_remesher_->get_options();
+    options.convert_quads = async_quads_ && qmorph_converter_ != nullptr;
+    if (qmorph_converter_) options.quad_mode = qmorph_converter_->get_mode();
+    options.smooth = smooth_quads_;
+    options.smooth_options = smoother_.get_options();
+    async_remesher_->set_options(options);
+}
+
+// 每帧检查一次：有更新的网格完成时才重新上传缓冲区。四边形网格尚未完成时先显示三角网格。
+// 按对象而不是模拟步判断是否更新：同一步的三角网格先完成，之后完成的四边形网格仍要显示
+void Viewer::poll_async_mesh() {
+    if (!async_remesher_) return;
+    auto mesh = async_remesher_->get_quad_mesh();
+    auto triangles = async_remesher_->get_triangle_mesh();
+    if (!mesh || (triangles && !async_remesher_->get_options().convert_quads)) mesh = triangles;
+    if (!mesh || mesh == async_mesh_) return;
+    async_mesh_ = mesh;
+    quad_vertices_ = mesh->vertices;
+    remaining_triangles_ = mesh->triangles;
+    quads_ = mesh->quads;
+    update_mesh_buffers();
+}
+
 void Viewer::setup_size_field_buffers() {
     if (!grid_) return;
     size_field_shader_ = new Shader("shaders/size_field.vert", "shaders/size_field.frag");
@@ -256,7 +354,7 @@ void Viewer::setup_size_field_buffers() {
 
     for (int y = 0; y < h - 1; ++y) {
         for (int x = 0; x < w - 1; ++x) {
-            // ÿӴ
+            // 每个格子创建两个三角形
             Vertex v0 = { min_c + glm::vec2(x * cs, y * cs),       field[y * w + x] };
             Vertex v1 = { min_c + glm::vec2((x + 1) * cs, y * cs),   field[y * w + x + 1] };
             Vertex v2 = { min_c + glm::vec2(x * cs, (y + 1) * cs),   field[(y + 1) * w + x] };
@@ -279,14 +377,14 @@ void Viewer::setup_size_field_buffers() {
     glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 }
-// --- ̬̻ص ---
+// --- 新增：静态键盘回调函数 ---
 
 void Viewer::key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) 
 {
     auto* viewer = static_cast<Viewer*>(glfwGetWindowUserPointer(window));
-    if (viewer && action == GLFW_PRESS) { // ֻڰʱһ
+    if (viewer && action == GLFW_PRESS) { // 只在按下时触发一次
         if (key == GLFW_KEY_V) {
-            // ѭлͼ: Particles -> Size Field -> Mesh
+            // 循环切换视图: Particles -> Size Field -> Mesh
             if (!viewer->show_size_field_ && !viewer->show_mesh_) {
                 viewer->show_size_field_ = true;
                 std::cout << "View Mode: Size Field" << std::endl;
@@ -304,9 +402,51 @@ void Viewer::key_callback(GLFWwindow* window, int key, int scancode, int action,
         if (key == GLFW_KEY_S) {
             viewer->save_particle_snapshot();
         }
-        // ---  C ߼ ---
+        if (key == GLFW_KEY_E) {
+            viewer->export_mesh();
+        }
+        // 新增：M 键切换实时重剖分：与 A 键共用后台流水线，只做三角剖分 (CDT 增量更新)，渲染线程不等待
+        if (key == GLFW_KEY_M) {
+            viewer->toggle_async_remesh(false);
+        }
+        // 新增：Q 键轮换 Q-Morph 的转换方式 (贪心 / 加权匹配 / 推进波前)
+        if (key == GLFW_KEY_Q && viewer->qmorph_converter_) {
+            Qmorph::Mode mode = viewer->qmorph_converter_->get_mode();
+            const char* name = "Greedy";
+            if (mode == Qmorph::Mode::Greedy) { mode = Qmorph::Mode::Matching; name = "Matching"; }
+            else if (mode == Qmorph::Mode::Matching) { mode = Qmorph::Mode::AdvancingFront; name = "Advancing Front"; }
+            else mode = Qmorph::Mode::Greedy;
+            viewer->qmorph_converter_->set_mode(mode);
+            std::cout << "Q-Morph mode: " << name << std::endl;
+            viewer->sync_async_options();
+        }
+        // 新增：L 键轮换转换后的光顺方式 (Laplacian / 基于角度 / 基于优化 / 关闭)
+        if (key == GLFW_KEY_L) {
+            MeshSmoother::Options options = viewer->smoother_.get_options();
+            const char* name = "Off";
+            if (!viewer->smooth_quads_) { viewer->smooth_quads_ = true; options.method = MeshSmoother::Method::Laplacian; name = "Laplacian"; }
+            else if (options.method == MeshSmoother::Method::Laplacian) { options.method = MeshSmoother::Method::AngleBased; name = "Angle-based"; }
+            else if (options.method == MeshSmoother::Method::AngleBased) { options.method = MeshSmoother::Method::Optimization; name = "Optimization"; }
+            else viewer->smooth_quads_ = false;
+            viewer->smoother_.set_options(options);
+            viewer->sync_async_options();
+            std::cout << "Smoothing: " << name << std::endl;
+        }
+        // 新增：A 键切换后台流水线重剖分：模拟继续运行，三角剖分与四边形转换在工作线程上重叠进行
+        if (key == GLFW_KEY_A) {
+            viewer->toggle_async_remesh(true);
+        }
+        // 新增：R 键对当前的四边形网格重新编号 (RCM)，降低下游求解器的矩阵带宽
+        if (key == GLFW_KEY_R && viewer->current_view_ == ViewMode::Quads && viewer->delaunay_generator_) {
+            if (viewer->quad_vertices_.empty()) viewer->quad_vertices_ = viewer->delaunay_generator_->get_vertices();
+            MeshRenumbering renumbering;
+            if (renumbering.renumber(viewer->quad_vertices_, viewer->remaining_triangles_, viewer->quads_)) {
+                viewer->update_mesh_buffers();
+            }
+        }
+        // --- 新增 C 键逻辑 ---
         if (key == GLFW_KEY_C) {
-            // --- ؼ޸Լ ---
+            // --- 关键修复：添加诊断性检查 ---
             if (!viewer->delaunay_generator_) {
                 std::cerr << "Error: Delaunay Generator is not set!" << std::endl;
                 return;
@@ -320,7 +460,7 @@ void Viewer::key_callback(GLFWwindow* window, int key, int scancode, int action,
                 return;
             }
             
-            // ǰģʽɳʼ
+            // 如果当前不在网格模式，则生成初始三角网格
             if (viewer->current_view_ != ViewMode::Triangles && viewer->current_view_ != ViewMode::Quads) {
                 std::cout << "Generating Delaunay Mesh with CGAL..." << std::endl;
                 viewer->delaunay_generator_->generate_mesh(viewer->sim2d_->get_particles(), *viewer->boundary_);
@@ -334,7 +474,19 @@ void Viewer::key_callback(GLFWwindow* window, int key, int scancode, int action,
                     auto result = viewer->qmorph_converter_->run(*viewer->delaunay_generator_);
                     viewer->quads_ = result.quads;
                     viewer->remaining_triangles_ = result.remaining_triangles;
-                    viewer->update_mesh_buffers(); // »Էӳ
+                    viewer->quad_vertices_ = result.vertices;
+                    // 新增：输出转换后网格的质量统计
+                    Mesh2D quad_mesh;
+                    quad_mesh.build(result.vertices.empty() ? viewer->delaunay_generator_->get_vertices() : result.vertices,
+                                    result.remaining_triangles, result.quads);
+                    // 新增：光顺内部顶点 (L 键切换方式)，光顺后的坐标作为四边形视图的顶点
+                    if (viewer->smooth_quads_ && viewer->smoother_.smooth(quad_mesh)) {
+                        viewer->quad_vertices_ = quad_mesh.get_positions();
+                    }
+                    MeshQuality quality;
+                    quality.evaluate(quad_mesh);
+                    quality.print_report(std::cout);
+                    viewer->update_mesh_buffers(); // 更新缓冲区以反映新网格
                     viewer->current_view_ = ViewMode::Quads;
                     std::cout << "View Mode: Quadrilateral-Dominant Mesh." << std::endl;
                 }
@@ -383,20 +535,37 @@ void Viewer::set_qmorph_generator(Qmorph* converter) {
 }
 
 
-// --- oB{ ---
+// --- 靜態回調函數 ---
 
 void Viewer::setup_boundary_buffers() {
     if (!boundary_) return;
+    // 所有环 (外环与孔洞) 拼接进同一个 VBO，记录每个环的起点
+    std::vector<glm::vec2> ring_vertices;
+    boundary_ring_starts_.clear();
+    for (size_t r = 0; r < boundary_->get_num_rings(); ++r) {
+        boundary_ring_starts_.push_back(static_cast<int>(ring_vertices.size()));
+        const auto& ring = boundary_->get_ring(r);
+        ring_vertices.insert(ring_vertices.end(), ring.begin(), ring.end());
+    }
+    boundary_ring_starts_.push_back(static_cast<int>(ring_vertices.size()));
+
     glGenVertexArrays(1, &VAO_boundary_);
     glGenBuffers(1, &VBO_boundary_);
     glBindVertexArray(VAO_boundary_);
     glBindBuffer(GL_ARRAY_BUFFER, VBO_boundary_);
-    glBufferData(GL_ARRAY_BUFFER, boundary_->get_vertices().size() * sizeof(glm::vec2), boundary_->get_vertices().data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, ring_vertices.size() * sizeof(glm::vec2), ring_vertices.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 }
 
+// 每个环单独绘制为闭合折线，调用前需绑定 VAO_boundary_
+void Viewer::draw_boundary_rings() {
+    for (size_t r = 0; r + 1 < boundary_ring_starts_.size(); ++r) {
+        glDrawArrays(GL_LINE_LOOP, boundary_ring_starts_[r], boundary_ring_starts_[r + 1] - boundary_ring_starts_[r]);
+    }
+}
+
 
 void Viewer::run() {
     shader_ = new Shader("shaders/simple.vert", "shaders/simple.frag");
@@ -412,10 +581,10 @@ void Viewer::init() {
     window_ = glfwCreateWindow(width_, height_, title_.c_str(), nullptr, nullptr);
     glfwMakeContextCurrent(window_);
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { return; }
-    glfwSetWindowUserPointer(window_, this); // ؼthisָ봰ڹ
+    glfwSetWindowUserPointer(window_, this); // 关键：将this指针与窗口关联
 
     glfwSetWindowUserPointer(window_, this);
-    glfwSetKeyCallback(window_, key_callback); // <-- ע̻ص
+    glfwSetKeyCallback(window_, key_callback); // <-- 注册键盘回调
     glfwSetFramebufferSizeCallback(window_, framebuffer_size_callback);
     glfwSetMouseButtonCallback(window_, mouse_button_callback);
     glfwSetCursorPosCallback(window_, cursor_pos_callback);
@@ -1,6 +1,6 @@
 #pragma once
 #include <glad/glad.h>
-#include <glfw/glfw3.h>
+#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <string>
 #include <fstream>
@@ -12,7 +12,10 @@
 #include "BackgroundGrid.h" 
 //#include "DelaunayMeshGenerator.h" 
 #include "CGALMeshGenerator.h"
-#include "qmorph.h"
+#include "Qmorph.h"
+#include "MeshSmoother.h"
+#include "AsyncRemesher.h"
+#include <memory>
 
 class Viewer {
 public:
@@ -26,19 +29,20 @@ public:
     void set_simulation2d(Simulation2D* sim);
     void set_mesh_generator2d(MeshGenerator2D* generator);
     void run();
-    void set_background_grid(BackgroundGrid* grid); // 
-    void set_cgal_generator(CGALMeshGenerator* generator); // 
+    void set_background_grid(BackgroundGrid* grid); // 新增
+    void set_cgal_generator(CGALMeshGenerator* generator); // 新增
     void set_qmorph_generator(Qmorph* converter);
 
 private:
     void init();
     void main_loop();
     //void process_input();
-    // ̻ص
+    // 新增：键盘回调函数
     static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
     void update_camera_vectors();
 
     void setup_boundary_buffers();
+    void draw_boundary_rings();
     void update_particle_buffers();
     void update_mesh_buffers();
 
@@ -47,10 +51,15 @@ private:
     static void cursor_pos_callback(GLFWwindow* window, double xpos, double ypos);
     static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 
-    // ӻģʽлݵ
+    // 新增：可视化模式切换和数据导出
     void toggle_view_mode();
     void save_particle_snapshot();
-    // ΪСû
+    void export_mesh(); // 新增：把当前显示的网格导出为 .msh 与 .vtu
+    // 新增：后台流水线重剖分 (A 键：三角剖分 + 四边形转换；M 键：只做三角剖分)
+    void toggle_async_remesh(bool convert_quads);
+    void sync_async_options();
+    void poll_async_mesh();
+    // 新增：为大小场设置缓冲区
     void setup_size_field_buffers();
 
 private:
@@ -64,22 +73,33 @@ private:
     Shader* size_field_shader_ = nullptr;
     unsigned int VAO_size_field_ = 0, VBO_size_field_ = 0;
     BackgroundGrid* grid_ = nullptr;
-    // ߼
+    // 控制逻辑
     bool show_size_field_ = false;
     int step_count_ = 0;
     std::ofstream convergence_log_;
 
     CGALMeshGenerator* delaunay_generator_ = nullptr;
     unsigned int VAO_mesh_ = 0, VBO_mesh_ = 0, EBO_mesh_ = 0;
-    bool show_mesh_ = false; // ʾ
+    bool show_mesh_ = false; // 新增：控制网格显示
+    int remesh_interval_ = 5;  // 每隔多少步更新一次网格
 
-    Qmorph* qmorph_converter_ = nullptr; // 
-    // 洢Q-Morphת
+    Qmorph* qmorph_converter_ = nullptr; // 新增
+    // 新增：存储Q-Morph转换结果
     std::vector<CGALMeshGenerator::Quad> quads_;
     std::vector<CGALMeshGenerator::Triangle> remaining_triangles_;
+    std::vector<glm::vec2> quad_vertices_; // 新增：转换新增了顶点或光顺后的顶点数组，否则为空
+    MeshSmoother smoother_;      // 新增：转换后的光顺
+    bool smooth_quads_ = true;
+    size_t mesh_line_index_count_ = 0; // 四边形视图线框的索引数
+
+    // 新增：后台流水线重剖分，模拟不停顿，显示最近完成的网格
+    std::unique_ptr<AsyncRemesher> async_remesher_;
+    bool async_quads_ = true; // 后台流水线是否做四边形转换 (M 键开启的实时重剖分只显示三角网格)
+    std::shared_ptr<const AsyncRemesher::Mesh> async_mesh_; // 当前显示的网格，同一模拟步的三角网格与四边形网格是不同的对象
 
 
     unsigned int VAO_boundary_ = 0, VBO_boundary_ = 0;
+    std::vector<int> boundary_ring_starts_; // 新增：各边界环在 VBO 中的起点
     unsigned int VAO_particles_ = 0, VBO_particles_ = 0;
    
 
@@ -99,6 +119,6 @@ private:
 
     float h_ = 0.10f;
 
-    enum class ViewMode { Particles, SizeField, Triangles, Quads }; // <--  Quads ģʽ
+    enum class ViewMode { Particles, SizeField, Triangles, Quads }; // <-- 增加 Quads 模式
     ViewMode current_view_ = ViewMode::Particles;
 };
\ No newline at end of file
@@ -4,7 +4,11 @@
 #include <cstdint>
 #include <algorithm>
 #include <cmath>
-#include <vector>
+#include <numeric>
+#include <random>
+#include <limits>
+
+#include "TaskScheduler.h"
 
 namespace CDT
 {
@@ -20,6 +24,10 @@ namespace CDT
     };
 
     using VertInd = std::uint32_t;
+    using TriInd = std::uint32_t;
+
+    // Sentinel for "no triangle" / "no vertex"
+    constexpr std::uint32_t noNeighbor = static_cast<std::uint32_t>(-1);
 
     // An edge, identified by the vertex indices
     template <typename T>
@@ -35,7 +43,7 @@ namespace CDT
         };
     };
 
-    // A triangle, identified by the vertex indices
+    // A triangle, identified by the vertex indices (counter-clockwise)
     template <typename T>
     struct Triangle
     {
@@ -50,6 +58,17 @@ namespace CDT
     };
 
     // The main triangulation class
+    //
+    // Incremental Delaunay triangulation on a compact adjacency structure:
+    //  - triangles are stored as flat arrays: 3 vertex indices, 3 neighbours
+    //    (neighbour j is across the edge opposite vertex j) and 3 constraint flags;
+    //  - vertices are inserted in BRIO order (random rounds, each Hilbert-sorted)
+    //    and located by walking from the previously inserted vertex;
+    //  - the Delaunay property is restored with Lawson flips;
+    //  - constraint edges are recovered with Sloan's edge-flipping algorithm;
+    //  - outer triangles and holes are removed by a linear nesting-depth flood.
+    // The three super-triangle vertices are appended after the user vertices
+    // (indices vertices.size() .. vertices.size() + 2) and never exported.
     template <typename T>
     class Triangulation
     {
@@ -58,14 +77,46 @@ namespace CDT
         std::vector<Triangle<T>> triangles;
 
         void insertVertices(const std::vector<V2d<T>>& newVertices);
+        // Same result as insertVertices, built from numThreads strips triangulated concurrently on the TaskScheduler pool
+        void insertVerticesParallel(const std::vector<V2d<T>>& newVertices, unsigned numThreads);
         void insertEdges(const std::vector<Edge<T>>& edges);
         void eraseOuterTrianglesAndHoles();
 
     private:
         std::vector<Edge<T>> internalEdges;
 
+        // Internal mesh, including the super triangle
+        std::vector<double> xs_, ys_;
+        std::vector<VertInd> triVerts_;
+        std::vector<TriInd> triNeighbors_;
+        std::vector<std::uint8_t> triConstrained_;
+        std::vector<TriInd> vertTri_; // one incident triangle per vertex, noNeighbor if not inserted
+        VertInd superStart_ = 0;
+
+        bool initialize();
         void triangulate();
-        std::vector<int> getAdjacency() const;
+        void triangulateParallel(unsigned numThreads);
+        bool loadTriangulation(const std::vector<Triangle<T>>& tris, const std::vector<TriInd>& neighbors);
+        std::vector<std::uint8_t> nestingMask(bool keepOdd) const;
+        void exportTriangles(const std::vector<std::uint8_t>* keep);
+        std::vector<VertInd> insertionOrder() const;
+
+        TriInd addTriangle();
+        void setTriangle(TriInd t, VertInd a, VertInd b, VertInd c, TriInd na, TriInd nb, TriInd nc, std::uint8_t ca, std::uint8_t cb, std::uint8_t cc);
+        void replaceNeighbor(TriInd t, TriInd oldNeighbor, TriInd newNeighbor);
+        int vertexIndex(TriInd t, VertInd v) const;
+        int neighborIndex(TriInd t, TriInd n) const;
+
+        double orient(VertInd a, VertInd b, VertInd c) const;
+        bool inCircle(TriInd t, VertInd d) const;
+
+        TriInd locate(VertInd p, TriInd start) const;
+        void insertPoint(VertInd p, TriInd& hint);
+        void flip(TriInd t, int i);
+        void legalize(std::vector<std::pair<TriInd, int>>& stack);
+
+        bool findEdge(VertInd u, VertInd v, TriInd& t, int& i) const;
+        void insertConstraint(VertInd a, VertInd b, int depth);
     };
 
     template <typename T>
@@ -73,231 +124,1118 @@ namespace CDT
     {
         vertices.insert(vertices.end(), newVertices.begin(), newVertices.end());
         triangulate();
+        // Constraints inserted before new vertices are recovered again
+        for (const auto& e : internalEdges)
+        {
+            insertConstraint(e.v1, e.v2, 0);
+        }
+        exportTriangles(nullptr);
     }
 
     template <typename T>
     void Triangulation<T>::insertEdges(const std::vector<Edge<T>>& edges)
     {
+        if (triVerts_.empty())
+        {
+            return;
+        }
+        internalEdges.reserve(internalEdges.size() + edges.size());
         for (const auto& edge : edges)
         {
-            const auto it = std::find_if(
-                internalEdges.begin(),
-                internalEdges.end(),
-                [&edge](const Edge<T>& e)
-                {
-                    return (e.v1 == edge.v1 && e.v2 == edge.v2) || (e.v1 == edge.v2 && e.v2 == edge.v1);
-                });
-            if (it == internalEdges.end())
+            TriInd t;
+            int i;
+            if (findEdge(edge.v1, edge.v2, t, i) && triConstrained_[t * 3 + i])
             {
-                internalEdges.push_back(edge);
+                continue; // already a constraint
             }
+            internalEdges.push_back(edge);
+            insertConstraint(edge.v1, edge.v2, 0);
         }
-        triangulate();
+        exportTriangles(nullptr);
     }
 
+    // Flood from the super triangle: crossing a constraint edge increases the nesting
+    // depth by one; triangles at odd depth are inside the domain. Each triangle is
+    // visited once, so this is linear in the number of triangles.
     template <typename T>
     void Triangulation<T>::eraseOuterTrianglesAndHoles()
     {
-        if (internalEdges.empty())
+        if (internalEdges.empty() || triVerts_.empty())
         {
             return;
         }
+        const auto keep = nestingMask(true);
+        exportTriangles(&keep);
+    }
 
-        const auto adj = getAdjacency();
-        std::vector<bool> isGood(triangles.size(), false);
-        std::vector<VertInd> q;
-        q.reserve(triangles.size());
-
-        for (VertInd i = 0; i < triangles.size(); ++i)
+    // keepOdd = true keeps the constrained domain; false keeps its complement
+    // inside the convex hull (used to fill the seams of the parallel triangulation)
+    template <typename T>
+    std::vector<std::uint8_t> Triangulation<T>::nestingMask(bool keepOdd) const
+    {
+        const TriInd numTris = static_cast<TriInd>(triVerts_.size() / 3);
+        std::vector<int> depth(numTris, -1);
+        std::vector<TriInd> layer, nextLayer;
+        for (TriInd t = 0; t < numTris; ++t)
         {
-            bool isBorder = false;
             for (int j = 0; j < 3; ++j)
             {
-                if (adj[i * 3 + j] == -1)
+                if (triVerts_[t * 3 + j] >= superStart_)
                 {
-                    isBorder = true;
+                    depth[t] = 0;
+                    layer.push_back(t);
                     break;
                 }
             }
-
-            if (isBorder)
-            {
-                q.push_back(i);
-            }
         }
 
-        std::size_t head = 0;
-        while (head < q.size())
+        for (int level = 0; !layer.empty(); ++level)
         {
-            const VertInd triInd = q[head++];
-
-            for (int i = 0; i < 3; ++i)
+            for (std::size_t head = 0; head < layer.size(); ++head)
             {
-                const VertInd v1 = triangles[triInd].vertices[i];
-                const VertInd v2 = triangles[triInd].vertices[(i + 1) % 3];
-                const auto it = std::find_if(
-                    internalEdges.begin(),
-                    internalEdges.end(),
-                    [v1, v2](const Edge<T>& e)
-                    {
-                        return (e.v1 == v1 && e.v2 == v2) || (e.v1 == v2 && e.v2 == v1);
-                    });
-
-                if (it == internalEdges.end())
+                const TriInd t = layer[head];
+                for (int j = 0; j < 3; ++j)
                 {
-                    const int neighbor = adj[triInd * 3 + i];
-                    if (neighbor != -1 && !isGood[neighbor])
+                    const TriInd n = triNeighbors_[t * 3 + j];
+                    if (n == noNeighbor || depth[n] != -1)
+                    {
+                        continue;
+                    }
+                    if (triConstrained_[t * 3 + j])
                     {
-                        isGood[neighbor] = true;
-                        q.push_back(neighbor);
+                        nextLayer.push_back(n);
                     }
+                    else
+                    {
+                        depth[n] = level;
+                        layer.push_back(n);
+                    }
+                }
+            }
+            layer.clear();
+            for (const TriInd n : nextLayer)
+            {
+                if (depth[n] == -1)
+                {
+                    depth[n] = level + 1;
+                    layer.push_back(n);
                 }
             }
+            nextLayer.clear();
+        }
+
+        std::vector<std::uint8_t> keep(numTris, 0);
+        for (TriInd t = 0; t < numTris; ++t)
+        {
+            keep[t] = ((depth[t] % 2 == 1) == keepOdd) ? 1 : 0;
         }
+        return keep;
+    }
 
-        const auto oldTriangles = triangles;
+    // Resets the internal mesh and sets up coordinates with the super-triangle
+    // vertices appended; returns false when there is nothing to triangulate
+    template <typename T>
+    bool Triangulation<T>::initialize()
+    {
         triangles.clear();
-        for (VertInd i = 0; i < oldTriangles.size(); ++i)
+        xs_.clear();
+        ys_.clear();
+        triVerts_.clear();
+        triNeighbors_.clear();
+        triConstrained_.clear();
+        vertTri_.clear();
+        superStart_ = 0;
+        if (vertices.size() < 3)
         {
-            if (!isGood[i])
-            {
-                triangles.push_back(oldTriangles[i]);
-            }
+            return false;
+        }
+
+        const VertInd n = static_cast<VertInd>(vertices.size());
+        xs_.resize(n + 3);
+        ys_.resize(n + 3);
+        double minX = vertices[0].x, maxX = minX, minY = vertices[0].y, maxY = minY;
+        for (VertInd i = 0; i < n; ++i)
+        {
+            xs_[i] = vertices[i].x;
+            ys_[i] = vertices[i].y;
+            minX = std::min(minX, xs_[i]);
+            maxX = std::max(maxX, xs_[i]);
+            minY = std::min(minY, ys_[i]);
+            maxY = std::max(maxY, ys_[i]);
         }
+        const double deltaMax = std::max(std::max(maxX - minX, maxY - minY), 1e-6);
+        const double midx = (minX + maxX) / 2;
+        const double midy = (minY + maxY) / 2;
+
+        // Counter-clockwise: bottom-left, bottom-right, top
+        superStart_ = n;
+        xs_[n] = midx - 20 * deltaMax;     ys_[n] = midy - deltaMax;
+        xs_[n + 1] = midx + 20 * deltaMax; ys_[n + 1] = midy - deltaMax;
+        xs_[n + 2] = midx;                 ys_[n + 2] = midy + 20 * deltaMax;
+
+        // Euler: a triangulation of n + 3 points has at most 2n + 1 triangles
+        triVerts_.reserve(3 * (2 * static_cast<std::size_t>(n) + 1));
+        triNeighbors_.reserve(triVerts_.capacity());
+        triConstrained_.reserve(triVerts_.capacity());
+        vertTri_.assign(n + 3, noNeighbor);
+        return true;
     }
 
     template <typename T>
     void Triangulation<T>::triangulate()
     {
-        if (vertices.size() < 3)
+        if (!initialize())
         {
             return;
         }
-        const T minX = std::min_element(vertices.begin(), vertices.end(), [](const V2d<T>& a, const V2d<T>& b) { return a.x < b.x; })->x;
-        const T minY = std::min_element(vertices.begin(), vertices.end(), [](const V2d<T>& a, const V2d<T>& b) { return a.y < b.y; })->y;
-        const T maxX = std::max_element(vertices.begin(), vertices.end(), [](const V2d<T>& a, const V2d<T>& b) { return a.x < b.x; })->x;
-        const T maxY = std::max_element(vertices.begin(), vertices.end(), [](const V2d<T>& a, const V2d<T>& b) { return a.y < b.y; })->y;
-        const T dx = maxX - minX;
-        const T dy = maxY - minY;
-        const T deltaMax = std::max(dx, dy);
-        const T midx = (minX + maxX) / 2;
-        const T midy = (minY + maxY) / 2;
 
-        const V2d<T> p1 = { midx - 20 * deltaMax, midy - deltaMax };
-        const V2d<T> p2 = { midx, midy + 20 * deltaMax };
-        const V2d<T> p3 = { midx + 20 * deltaMax, midy - deltaMax };
+        const VertInd n = superStart_;
+        const TriInd super = addTriangle();
+        setTriangle(super, n, n + 1, n + 2, noNeighbor, noNeighbor, noNeighbor, 0, 0, 0);
 
-        const VertInd superInd1 = (VertInd)vertices.size();
-        const VertInd superInd2 = superInd1 + 1;
-        const VertInd superInd3 = superInd2 + 1;
+        TriInd hint = super;
+        for (const VertInd v : insertionOrder())
+        {
+            insertPoint(v, hint);
+        }
+    }
 
-        vertices.push_back(p1);
-        vertices.push_back(p2);
-        vertices.push_back(p3);
+    template <typename T>
+    void Triangulation<T>::insertVerticesParallel(const std::vector<V2d<T>>& newVertices, unsigned numThreads)
+    {
+        vertices.insert(vertices.end(), newVertices.begin(), newVertices.end());
+        triangulateParallel(numThreads);
+        for (const auto& e : internalEdges)
+        {
+            insertConstraint(e.v1, e.v2, 0);
+        }
+        exportTriangles(nullptr);
+    }
 
-        triangles.clear();
-        triangles.push_back({ superInd1, superInd2, superInd3 });
+    // Links pairs of open triangle slots that share an edge; slots left unpaired
+    // are returned. Each entry is (edge key, triangle * 3 + slot).
+    inline std::vector<std::pair<std::uint64_t, std::uint32_t>> pairOpenSlots(std::vector<std::pair<std::uint64_t, std::uint32_t>>& open, std::vector<TriInd>& neighbors)
+    {
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> unpaired;
+        std::sort(open.begin(), open.end());
+        for (std::size_t i = 0; i < open.size();)
+        {
+            if (i + 1 < open.size() && open[i + 1].first == open[i].first)
+            {
+                neighbors[open[i].second] = open[i + 1].second / 3;
+                neighbors[open[i + 1].second] = open[i].second / 3;
+                i += 2;
+            }
+            else
+            {
+                unpaired.push_back(open[i]);
+                ++i;
+            }
+        }
+        return unpaired;
+    }
 
-        for (VertInd i = 0; i < vertices.size() - 3; i++)
+    // Strip decomposition:
+    //  1. points are split into numThreads strips of equal count along x; each strip is
+    //     triangulated concurrently together with the points within an overlap margin;
+    //  2. a local triangle whose circumcircle stays inside the strip's x-range (margin
+    //     included) has an empty circle globally, so it is certified as a global Delaunay
+    //     triangle; it is emitted only by the strip that owns its circumcentre (a triangle
+    //     certified anywhere is also certified by its owner). Neighbours inside a strip
+    //     come from the local adjacency; only edges on the strip's certified border are
+    //     matched globally, so no full edge sort is needed;
+    //  3. the uncertified seams are filled by triangulating the border vertices and the
+    //     uncovered ones, with the border edges as constraints, keeping only the triangles
+    //     outside the certified region;
+    //  4. the merged triangulation is wrapped into the super triangle so that constraint
+    //     insertion and hole removal work exactly as after triangulate().
+    template <typename T>
+    void Triangulation<T>::triangulateParallel(unsigned numThreads)
+    {
+        const VertInd n = static_cast<VertInd>(vertices.size());
+        if (numThreads <= 1 || n < 4096u * numThreads)
+        {
+            triangulate();
+            return;
+        }
+
+        std::vector<VertInd> byX(n);
+        std::iota(byX.begin(), byX.end(), 0);
+        std::sort(byX.begin(), byX.end(), [this](VertInd a, VertInd b) { return vertices[a].x < vertices[b].x; });
+
+        double minY = vertices[0].y, maxY = minY;
+        for (const auto& v : vertices)
+        {
+            minY = std::min(minY, static_cast<double>(v.y));
+            maxY = std::max(maxY, static_cast<double>(v.y));
+        }
+        const double width = static_cast<double>(vertices[byX.back()].x) - vertices[byX.front()].x;
+        const double spacing = std::sqrt(std::max(width * (maxY - minY), 1e-12) / n);
+        const double overlap = 4 * spacing;
+        const double inf = std::numeric_limits<double>::infinity();
+
+        // --- 1 + 2. Concurrent strip triangulation and certification ---
+        struct StripResult
+        {
+            std::vector<Triangle<T>> tris;
+            std::vector<TriInd> neighbors; // strip-local emitted index, noNeighbor on the border
+        };
+        std::vector<StripResult> strips(numThreads);
+        auto processStrip = [&](unsigned k)
         {
-            std::vector<Edge<T>> edges;
-            std::vector<Triangle<T>> newTriangles;
-            for (const auto& triangle : triangles)
+            const std::size_t first = static_cast<std::size_t>(n) * k / numThreads;
+            const std::size_t last = static_cast<std::size_t>(n) * (k + 1) / numThreads;
+            const double x0 = k == 0 ? -inf : static_cast<double>(vertices[byX[first]].x);
+            const double x1 = k + 1 == numThreads ? inf : static_cast<double>(vertices[byX[last]].x);
+            const double lo = x0 - overlap, hi = x1 + overlap;
+            const auto byValue = [this](VertInd a, double x) { return vertices[a].x < x; };
+            const std::size_t begin = std::lower_bound(byX.begin(), byX.end(), lo, byValue) - byX.begin();
+            const std::size_t end = std::lower_bound(byX.begin(), byX.end(), hi, byValue) - byX.begin();
+
+            Triangulation<T> local;
+            local.vertices.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i)
             {
-                const auto p1_ = vertices[triangle.v1];
-                const auto p2_ = vertices[triangle.v2];
-                const auto p3_ = vertices[triangle.v3];
+                local.vertices.push_back(vertices[byX[i]]);
+            }
+            local.triangulate();
 
-                const T c_x = ((p1_.x * p1_.x + p1_.y * p1_.y) * (p2_.y - p3_.y) + (p2_.x * p2_.x + p2_.y * p2_.y) * (p3_.y - p1_.y) + (p3_.x * p3_.x + p3_.y * p3_.y) * (p1_.y - p2_.y)) / (2 * (p1_.x * (p2_.y - p3_.y) - p2_.x * (p1_.y - p3_.y) + p3_.x * (p1_.y - p2_.y)));
-                const T c_y = ((p1_.x * p1_.x + p1_.y * p1_.y) * (p3_.x - p2_.x) + (p2_.x * p2_.x + p2_.y * p2_.y) * (p1_.x - p3_.x) + (p3_.x * p3_.x + p3_.y * p3_.y) * (p2_.x - p1_.x)) / (2 * (p1_.x * (p2_.y - p3_.y) - p2_.x * (p1_.y - p3_.y) + p3_.x * (p1_.y - p2_.y)));
-                const T c_r = std::sqrt((p1_.x - c_x) * (p1_.x - c_x) + (p1_.y - c_y) * (p1_.y - c_y));
+            // Classify local triangles: certified (circle inside [lo, hi]) and owned (centre in [x0, x1))
+            const TriInd numLocal = static_cast<TriInd>(local.triVerts_.size() / 3);
+            std::vector<std::uint8_t> certified(numLocal, 0);
+            std::vector<TriInd> emitted(numLocal, noNeighbor);
+            StripResult& out = strips[k];
+            for (TriInd t = 0; t < numLocal; ++t)
+            {
+                const VertInd* v = &local.triVerts_[t * 3];
+                if (v[0] >= local.superStart_ || v[1] >= local.superStart_ || v[2] >= local.superStart_)
+                {
+                    continue;
+                }
+                const double ax = local.xs_[v[0]], ay = local.ys_[v[0]];
+                const double bx = local.xs_[v[1]] - ax, by = local.ys_[v[1]] - ay;
+                const double cx = local.xs_[v[2]] - ax, cy = local.ys_[v[2]] - ay;
+                const double d = 2 * (bx * cy - by * cx);
+                if (d <= 0)
+                {
+                    continue;
+                }
+                const double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+                const double ux = (cy * b2 - by * c2) / d, uy = (bx * c2 - cx * b2) / d;
+                const double r = std::sqrt(ux * ux + uy * uy);
+                const double centerX = ax + ux;
+                if (centerX - r < lo || centerX + r > hi)
+                {
+                    continue;
+                }
+                certified[t] = 1;
+                if (centerX >= x0 && centerX < x1)
+                {
+                    emitted[t] = static_cast<TriInd>(out.tris.size());
+                    out.tris.push_back({ byX[begin + v[0]], byX[begin + v[1]], byX[begin + v[2]] });
+                }
+            }
+            out.neighbors.assign(out.tris.size() * 3, noNeighbor);
+            for (TriInd t = 0; t < numLocal; ++t)
+            {
+                if (emitted[t] == noNeighbor)
+                {
+                    continue;
+                }
+                for (int j = 0; j < 3; ++j)
+                {
+                    const TriInd l = local.triNeighbors_[t * 3 + j];
+                    if (l != noNeighbor && emitted[l] != noNeighbor)
+                    {
+                        out.neighbors[emitted[t] * 3 + j] = emitted[l];
+                    }
+                }
+            }
+        };
+        // strips run as tasks on the shared pool, one strip per task
+        TaskScheduler::instance().parallel_for(0, numThreads, 1, [&](std::size_t lo, std::size_t hi)
+        {
+            for (std::size_t k = lo; k < hi; ++k)
+            {
+                processStrip(static_cast<unsigned>(k));
+            }
+        });
 
-                if (std::sqrt(std::pow(vertices[i].x - c_x, 2) + std::pow(vertices[i].y - c_y, 2)) < c_r)
+        std::vector<Triangle<T>> merged;
+        std::vector<TriInd> neighbors;
+        merged.reserve(2 * static_cast<std::size_t>(n));
+        neighbors.reserve(6 * static_cast<std::size_t>(n));
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> open;
+        auto edgeKey = [](std::uint64_t a, std::uint64_t b) { return std::min(a, b) << 32 | std::max(a, b); };
+        for (auto& strip : strips)
+        {
+            const TriInd offset = static_cast<TriInd>(merged.size());
+            for (std::size_t s = 0; s < strip.neighbors.size(); ++s)
+            {
+                if (strip.neighbors[s] == noNeighbor)
                 {
-                    edges.push_back({ triangle.v1, triangle.v2 });
-                    edges.push_back({ triangle.v2, triangle.v3 });
-                    edges.push_back({ triangle.v3, triangle.v1 });
+                    const auto& t = strip.tris[s / 3];
+                    const int j = static_cast<int>(s % 3);
+                    open.push_back({ edgeKey(t.vertices[(j + 1) % 3], t.vertices[(j + 2) % 3]), static_cast<std::uint32_t>(offset * 3 + s) });
+                    neighbors.push_back(noNeighbor);
                 }
                 else
                 {
-                    newTriangles.push_back(triangle);
+                    neighbors.push_back(offset + strip.neighbors[s]);
                 }
             }
+            merged.insert(merged.end(), strip.tris.begin(), strip.tris.end());
+            StripResult().tris.swap(strip.tris);
+        }
+
+        // --- 3. Border edges of the certified region: open slots no other strip closes ---
+        const auto border = pairOpenSlots(open, neighbors);
 
-            for (auto it1 = edges.begin(); it1 != edges.end(); ++it1)
+        std::vector<VertInd> seamIndex(n, noNeighbor);
+        std::vector<std::uint8_t> covered(n, 0);
+        for (const auto& t : merged)
+        {
+            covered[t.v1] = covered[t.v2] = covered[t.v3] = 1;
+        }
+        Triangulation<T> seam;
+        std::vector<VertInd> seamToGlobal;
+        auto addSeamVertex = [&](VertInd v)
+        {
+            if (seamIndex[v] == noNeighbor)
             {
-                for (auto it2 = edges.begin(); it2 != edges.end(); ++it2)
+                seamIndex[v] = static_cast<VertInd>(seamToGlobal.size());
+                seamToGlobal.push_back(v);
+                seam.vertices.push_back(vertices[v]);
+            }
+            return seamIndex[v];
+        };
+        std::vector<Edge<T>> seamEdges;
+        seamEdges.reserve(border.size());
+        for (const auto& e : border)
+        {
+            const VertInd a = addSeamVertex(static_cast<VertInd>(e.first >> 32));
+            const VertInd b = addSeamVertex(static_cast<VertInd>(e.first & 0xffffffffu));
+            seamEdges.push_back({ a, b });
+        }
+        for (VertInd v = 0; v < n; ++v)
+        {
+            if (!covered[v])
+            {
+                addSeamVertex(v);
+            }
+        }
+
+        open = border;
+        if (seam.vertices.size() >= 3)
+        {
+            seam.triangulate();
+            for (const auto& e : seamEdges)
+            {
+                seam.insertConstraint(e.v1, e.v2, 0);
+            }
+            const auto keep = seam.nestingMask(seamEdges.empty());
+            const TriInd numSeam = static_cast<TriInd>(seam.triVerts_.size() / 3);
+            std::vector<TriInd> seamToMerged(numSeam, noNeighbor);
+            for (TriInd t = 0; t < numSeam; ++t)
+            {
+                const VertInd* v = &seam.triVerts_[t * 3];
+                if (keep[t] && v[0] < seam.superStart_ && v[1] < seam.superStart_ && v[2] < seam.superStart_)
                 {
-                    if (it1 == it2)
+                    seamToMerged[t] = static_cast<TriInd>(merged.size());
+                    merged.push_back({ seamToGlobal[v[0]], seamToGlobal[v[1]], seamToGlobal[v[2]] });
+                }
+            }
+            neighbors.resize(merged.size() * 3, noNeighbor);
+            for (TriInd t = 0; t < numSeam; ++t)
+            {
+                if (seamToMerged[t] == noNeighbor)
+                {
+                    continue;
+                }
+                const auto& tri = merged[seamToMerged[t]];
+                for (int j = 0; j < 3; ++j)
+                {
+                    const TriInd l = seam.triNeighbors_[t * 3 + j];
+                    const std::uint32_t slot = seamToMerged[t] * 3 + j;
+                    if (l != noNeighbor && seamToMerged[l] != noNeighbor)
                     {
-                        continue;
+                        neighbors[slot] = seamToMerged[l];
                     }
-                    if ((it1->v1 == it2->v2) && (it1->v2 == it2->v1))
+                    else
                     {
-                        it1->v1 = (VertInd)-1;
-                        it1->v2 = (VertInd)-1;
-                        it2->v1 = (VertInd)-1;
-                        it2->v2 = (VertInd)-1;
+                        open.push_back({ edgeKey(tri.vertices[(j + 1) % 3], tri.vertices[(j + 2) % 3]), slot });
                     }
                 }
             }
+        }
+        // Whatever stays open now lies on the convex hull
+        pairOpenSlots(open, neighbors);
+
+        // --- 4. Load the merged triangulation; fall back to the sequential path on failure ---
+        if (!loadTriangulation(merged, neighbors))
+        {
+            triangulate();
+        }
+    }
+
+    // Builds the internal mesh from a triangulation of the convex hull of vertices with
+    // known adjacency (noNeighbor on the hull), then fans out the region between the hull
+    // and the super triangle so the result is equivalent to triangulate()
+    template <typename T>
+    bool Triangulation<T>::loadTriangulation(const std::vector<Triangle<T>>& tris, const std::vector<TriInd>& neighbors)
+    {
+        if (!initialize() || tris.empty())
+        {
+            return false;
+        }
+        const VertInd n = superStart_;
+        const TriInd numTris = static_cast<TriInd>(tris.size());
+        triVerts_.resize(3 * static_cast<std::size_t>(numTris));
+        triNeighbors_.assign(neighbors.begin(), neighbors.end());
+        triConstrained_.assign(triVerts_.size(), 0);
+
+        // Hull edges a->b (interior on the left), keyed by their start vertex
+        std::vector<std::uint32_t> hullSlots;
+        std::vector<std::uint32_t> hullFrom(n + 3, noNeighbor);
+        for (TriInd t = 0; t < numTris; ++t)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                triVerts_[t * 3 + j] = tris[t].vertices[j];
+                vertTri_[tris[t].vertices[j]] = t;
+            }
+            if (orient(triVerts_[t * 3], triVerts_[t * 3 + 1], triVerts_[t * 3 + 2]) <= 0)
+            {
+                return false;
+            }
+            for (int j = 0; j < 3; ++j)
+            {
+                if (triNeighbors_[t * 3 + j] != noNeighbor)
+                {
+                    continue;
+                }
+                const VertInd a = tris[t].vertices[(j + 1) % 3];
+                if (hullFrom[a] != noNeighbor)
+                {
+                    return false; // the merged mesh is not a single disk
+                }
+                hullFrom[a] = static_cast<std::uint32_t>(hullSlots.size());
+                hullSlots.push_back(t * 3 + j);
+            }
+        }
+        if (hullSlots.size() < 3)
+        {
+            return false;
+        }
 
-            for (const auto& edge : edges)
+        // Each hull edge is joined to the super vertex farthest along its outward normal;
+        // between consecutive edges the super vertex advances counter-clockwise
+        auto edgeOf = [this](std::uint32_t slot, VertInd& a, VertInd& b)
+        {
+            const TriInd t = slot / 3;
+            const int j = slot % 3;
+            a = triVerts_[t * 3 + (j + 1) % 3];
+            b = triVerts_[t * 3 + (j + 2) % 3];
+        };
+        auto superFor = [&](VertInd a, VertInd b)
+        {
+            const double nx = ys_[b] - ys_[a], ny = xs_[a] - xs_[b];
+            VertInd best = n;
+            for (VertInd s = n + 1; s < n + 3; ++s)
             {
-                if (edge.v1 != (VertInd)-1 && edge.v2 != (VertInd)-1)
+                if (xs_[s] * nx + ys_[s] * ny > xs_[best] * nx + ys_[best] * ny)
                 {
-                    newTriangles.push_back({ edge.v1, edge.v2, i });
+                    best = s;
                 }
             }
-            triangles = newTriangles;
+            return best;
+        };
+
+        const std::size_t m = hullSlots.size();
+        std::vector<std::uint32_t> orderedSlots;
+        orderedSlots.reserve(m);
+        {
+            std::uint32_t cur = 0;
+            for (std::size_t k = 0; k < m; ++k)
+            {
+                orderedSlots.push_back(hullSlots[cur]);
+                VertInd a, b;
+                edgeOf(hullSlots[cur], a, b);
+                cur = hullFrom[b];
+                if (cur == noNeighbor)
+                {
+                    return false;
+                }
+            }
+            if (orderedSlots.front() != hullSlots[cur])
+            {
+                return false; // more than one hull loop
+            }
         }
 
-        const auto oldTriangles = triangles;
+        std::vector<TriInd> outer(m);
+        std::vector<VertInd> outerSuper(m);
+        for (std::size_t k = 0; k < m; ++k)
+        {
+            VertInd a, b;
+            edgeOf(orderedSlots[k], a, b);
+            const VertInd s = superFor(a, b);
+            const TriInd w = addTriangle();
+            setTriangle(w, b, a, s, noNeighbor, noNeighbor, orderedSlots[k] / 3, 0, 0, 0);
+            triNeighbors_[orderedSlots[k]] = w;
+            if (orient(b, a, s) <= 0)
+            {
+                return false;
+            }
+            outer[k] = w;
+            outerSuper[k] = s;
+        }
+        for (std::size_t k = 0; k < m; ++k)
+        {
+            // The shared edge with the next triangle around the hull vertex b is b-s,
+            // stored opposite a (slot 1) in the fan triangle (b, a, s)
+            VertInd a, b;
+            edgeOf(orderedSlots[k], a, b);
+            TriInd pending = outer[k];
+            int pendingSlot = 1;
+            VertInd s = outerSuper[k];
+            const VertInd target = outerSuper[(k + 1) % m];
+            while (s != target)
+            {
+                const VertInd next = s + 1 == n + 3 ? n : s + 1;
+                const TriInd x = addTriangle();
+                setTriangle(x, b, s, next, noNeighbor, noNeighbor, pending, 0, 0, 0);
+                if (orient(b, s, next) <= 0)
+                {
+                    return false;
+                }
+                triNeighbors_[pending * 3 + pendingSlot] = x;
+                pending = x;
+                pendingSlot = 1;
+                s = next;
+            }
+            const TriInd w = outer[(k + 1) % m];
+            triNeighbors_[pending * 3 + pendingSlot] = w;
+            triNeighbors_[w * 3] = pending;
+        }
+        // setTriangle may have pointed user vertices at fan triangles, which is fine;
+        // super vertices must point at a triangle containing them
+        return true;
+    }
+
+    // BRIO: random rounds of doubling size, each round sorted along a Hilbert curve,
+    // so consecutive insertions are spatially close and the walk stays short
+    template <typename T>
+    std::vector<VertInd> Triangulation<T>::insertionOrder() const
+    {
+        const VertInd n = superStart_;
+        std::vector<VertInd> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937 rng(0x5eed);
+        std::shuffle(order.begin(), order.end(), rng);
+
+        double minX = xs_[0], maxX = minX, minY = ys_[0], maxY = minY;
+        for (VertInd i = 0; i < n; ++i)
+        {
+            minX = std::min(minX, xs_[i]);
+            maxX = std::max(maxX, xs_[i]);
+            minY = std::min(minY, ys_[i]);
+            maxY = std::max(maxY, ys_[i]);
+        }
+        const double scale = 65535.0 / std::max(std::max(maxX - minX, maxY - minY), 1e-12);
+
+        std::vector<std::uint64_t> keys(n);
+        for (VertInd i = 0; i < n; ++i)
+        {
+            std::uint32_t x = static_cast<std::uint32_t>((xs_[i] - minX) * scale);
+            std::uint32_t y = static_cast<std::uint32_t>((ys_[i] - minY) * scale);
+            std::uint64_t d = 0;
+            for (std::uint32_t s = 1u << 15; s > 0; s >>= 1)
+            {
+                const std::uint32_t rx = (x & s) ? 1 : 0;
+                const std::uint32_t ry = (y & s) ? 1 : 0;
+                d += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+                if (ry == 0)
+                {
+                    if (rx == 1)
+                    {
+                        x = 65535 - x;
+                        y = 65535 - y;
+                    }
+                    std::swap(x, y);
+                }
+            }
+            keys[i] = d;
+        }
+
+        std::size_t end = n;
+        while (end > 0)
+        {
+            const std::size_t begin = end <= 128 ? 0 : end / 2;
+            std::sort(order.begin() + begin, order.begin() + end,
+                [&keys](VertInd a, VertInd b) { return keys[a] < keys[b]; });
+            end = begin;
+        }
+        return order;
+    }
+
+    template <typename T>
+    void Triangulation<T>::exportTriangles(const std::vector<std::uint8_t>* keep)
+    {
         triangles.clear();
+        const TriInd numTris = static_cast<TriInd>(triVerts_.size() / 3);
+        triangles.reserve(numTris);
+        for (TriInd t = 0; t < numTris; ++t)
+        {
+            const VertInd* v = &triVerts_[t * 3];
+            if (v[0] >= superStart_ || v[1] >= superStart_ || v[2] >= superStart_)
+            {
+                continue;
+            }
+            if (keep && !(*keep)[t])
+            {
+                continue;
+            }
+            triangles.push_back({ v[0], v[1], v[2] });
+        }
+    }
+
+    template <typename T>
+    TriInd Triangulation<T>::addTriangle()
+    {
+        const TriInd t = static_cast<TriInd>(triVerts_.size() / 3);
+        triVerts_.resize(triVerts_.size() + 3);
+        triNeighbors_.resize(triNeighbors_.size() + 3);
+        triConstrained_.resize(triConstrained_.size() + 3);
+        return t;
+    }
 
-        for (const auto& triangle : oldTriangles)
+    template <typename T>
+    void Triangulation<T>::setTriangle(TriInd t, VertInd a, VertInd b, VertInd c, TriInd na, TriInd nb, TriInd nc, std::uint8_t ca, std::uint8_t cb, std::uint8_t cc)
+    {
+        triVerts_[t * 3] = a;
+        triVerts_[t * 3 + 1] = b;
+        triVerts_[t * 3 + 2] = c;
+        triNeighbors_[t * 3] = na;
+        triNeighbors_[t * 3 + 1] = nb;
+        triNeighbors_[t * 3 + 2] = nc;
+        triConstrained_[t * 3] = ca;
+        triConstrained_[t * 3 + 1] = cb;
+        triConstrained_[t * 3 + 2] = cc;
+        vertTri_[a] = vertTri_[b] = vertTri_[c] = t;
+    }
+
+    template <typename T>
+    void Triangulation<T>::replaceNeighbor(TriInd t, TriInd oldNeighbor, TriInd newNeighbor)
+    {
+        if (t == noNeighbor)
         {
-            if (triangle.v1 < superInd1 && triangle.v2 < superInd1 && triangle.v3 < superInd1)
+            return;
+        }
+        for (int j = 0; j < 3; ++j)
+        {
+            if (triNeighbors_[t * 3 + j] == oldNeighbor)
             {
-                triangles.push_back(triangle);
+                triNeighbors_[t * 3 + j] = newNeighbor;
+                return;
             }
         }
+    }
+
+    template <typename T>
+    int Triangulation<T>::vertexIndex(TriInd t, VertInd v) const
+    {
+        return triVerts_[t * 3] == v ? 0 : (triVerts_[t * 3 + 1] == v ? 1 : 2);
+    }
+
+    template <typename T>
+    int Triangulation<T>::neighborIndex(TriInd t, TriInd n) const
+    {
+        return triNeighbors_[t * 3] == n ? 0 : (triNeighbors_[t * 3 + 1] == n ? 1 : 2);
+    }
 
-        vertices.erase(vertices.end() - 3, vertices.end());
+    // > 0 if c is to the left of a->b
+    template <typename T>
+    double Triangulation<T>::orient(VertInd a, VertInd b, VertInd c) const
+    {
+        return (xs_[b] - xs_[a]) * (ys_[c] - ys_[a]) - (ys_[b] - ys_[a]) * (xs_[c] - xs_[a]);
     }
 
+    // true if d lies strictly inside the circumcircle of (counter-clockwise) triangle t
     template <typename T>
-    std::vector<int> Triangulation<T>::getAdjacency() const
+    bool Triangulation<T>::inCircle(TriInd t, VertInd d) const
     {
-        std::vector<int> adj(triangles.size() * 3, -1);
-        for (VertInd i = 0; i < triangles.size(); ++i)
+        const VertInd* v = &triVerts_[t * 3];
+        const double adx = xs_[v[0]] - xs_[d], ady = ys_[v[0]] - ys_[d];
+        const double bdx = xs_[v[1]] - xs_[d], bdy = ys_[v[1]] - ys_[d];
+        const double cdx = xs_[v[2]] - xs_[d], cdy = ys_[v[2]] - ys_[d];
+        const double det = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+            + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+            + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+        return det > 0;
+    }
+
+    // Visibility walk; the starting edge rotates so the walk cannot cycle
+    template <typename T>
+    TriInd Triangulation<T>::locate(VertInd p, TriInd start) const
+    {
+        TriInd t = start;
+        int offset = 0;
+        for (;;)
         {
-            for (VertInd j = i + 1; j < triangles.size(); ++j)
+            bool moved = false;
+            for (int k = 0; k < 3; ++k)
+            {
+                const int j = (k + offset) % 3;
+                const VertInd a = triVerts_[t * 3 + (j + 1) % 3];
+                const VertInd b = triVerts_[t * 3 + (j + 2) % 3];
+                if (orient(a, b, p) < 0 && triNeighbors_[t * 3 + j] != noNeighbor)
+                {
+                    t = triNeighbors_[t * 3 + j];
+                    moved = true;
+                    break;
+                }
+            }
+            if (!moved)
             {
-                const auto& t1 = triangles[i];
-                const auto& t2 = triangles[j];
-                int shared = 0;
-                int t1E = -1;
-                int t2E = -1;
-                if ((t1.v1 == t2.v1 && t1.v2 == t2.v2) || (t1.v1 == t2.v2 && t1.v2 == t2.v1)) { shared++; t1E = 2; t2E = 2; }
-                if ((t1.v2 == t2.v1 && t1.v3 == t2.v2) || (t1.v2 == t2.v2 && t1.v3 == t2.v1)) { shared++; t1E = 0; t2E = 2; }
-                if ((t1.v3 == t2.v1 && t1.v1 == t2.v2) || (t1.v3 == t2.v2 && t1.v1 == t2.v1)) { shared++; t1E = 1; t2E = 2; }
+                return t;
+            }
+            offset = (offset + 1) % 3;
+        }
+    }
 
-                if ((t1.v1 == t2.v2 && t1.v2 == t2.v3) || (t1.v1 == t2.v3 && t1.v2 == t2.v2)) { shared++; t1E = 2; t2E = 0; }
-                if ((t1.v2 == t2.v2 && t1.v3 == t2.v3) || (t1.v2 == t2.v3 && t1.v3 == t2.v2)) { shared++; t1E = 0; t2E = 0; }
-                if ((t1.v3 == t2.v2 && t1.v1 == t2.v3) || (t1.v3 == t2.v3 && t1.v1 == t2.v2)) { shared++; t1E = 1; t2E = 0; }
+    template <typename T>
+    void Triangulation<T>::insertPoint(VertInd p, TriInd& hint)
+    {
+        const TriInd t = locate(p, hint);
+        const VertInd v0 = triVerts_[t * 3], v1 = triVerts_[t * 3 + 1], v2 = triVerts_[t * 3 + 2];
+        if ((xs_[p] == xs_[v0] && ys_[p] == ys_[v0]) || (xs_[p] == xs_[v1] && ys_[p] == ys_[v1]) || (xs_[p] == xs_[v2] && ys_[p] == ys_[v2]))
+        {
+            return; // duplicate vertex: stays out of the triangulation
+        }
+
+        int onEdge = -1;
+        for (int j = 0; j < 3; ++j)
+        {
+            if (orient(triVerts_[t * 3 + (j + 1) % 3], triVerts_[t * 3 + (j + 2) % 3], p) == 0)
+            {
+                onEdge = j;
+            }
+        }
+
+        std::vector<std::pair<TriInd, int>> stack;
+        const TriInd o = onEdge >= 0 ? triNeighbors_[t * 3 + onEdge] : noNeighbor;
+        if (o == noNeighbor)
+        {
+            // Split t into three triangles around p
+            const TriInd n0 = triNeighbors_[t * 3], n1 = triNeighbors_[t * 3 + 1], n2 = triNeighbors_[t * 3 + 2];
+            const std::uint8_t c0 = triConstrained_[t * 3], c1 = triConstrained_[t * 3 + 1], c2 = triConstrained_[t * 3 + 2];
+            const TriInd t1 = addTriangle();
+            const TriInd t2 = addTriangle();
+            setTriangle(t, v0, v1, p, t1, t2, n2, 0, 0, c2);
+            setTriangle(t1, v1, v2, p, t2, t, n0, 0, 0, c0);
+            setTriangle(t2, v2, v0, p, t, t1, n1, 0, 0, c1);
+            replaceNeighbor(n0, t, t1);
+            replaceNeighbor(n1, t, t2);
+            stack.push_back({ t, 2 });
+            stack.push_back({ t1, 2 });
+            stack.push_back({ t2, 2 });
+        }
+        else
+        {
+            // p lies on the edge shared by t and o: split both into two
+            const int i = onEdge;
+            const VertInd vi = triVerts_[t * 3 + i];
+            const VertInd a = triVerts_[t * 3 + (i + 1) % 3];
+            const VertInd b = triVerts_[t * 3 + (i + 2) % 3];
+            const TriInd nta = triNeighbors_[t * 3 + (i + 1) % 3], ntb = triNeighbors_[t * 3 + (i + 2) % 3];
+            const std::uint8_t cta = triConstrained_[t * 3 + (i + 1) % 3], ctb = triConstrained_[t * 3 + (i + 2) % 3];
+            const std::uint8_t cab = triConstrained_[t * 3 + i];
+            const int k = neighborIndex(o, t);
+            const VertInd q = triVerts_[o * 3 + k];
+            const TriInd nob = triNeighbors_[o * 3 + (k + 1) % 3], noa = triNeighbors_[o * 3 + (k + 2) % 3];
+            const std::uint8_t cob = triConstrained_[o * 3 + (k + 1) % 3], coa = triConstrained_[o * 3 + (k + 2) % 3];
 
-                if ((t1.v1 == t2.v3 && t1.v2 == t2.v1) || (t1.v1 == t2.v1 && t1.v2 == t2.v3)) { shared++; t1E = 2; t2E = 1; }
-                if ((t1.v2 == t2.v3 && t1.v3 == t2.v1) || (t1.v2 == t2.v1 && t1.v3 == t2.v3)) { shared++; t1E = 0; t2E = 1; }
-                if ((t1.v3 == t2.v3 && t1.v1 == t2.v1) || (t1.v3 == t2.v1 && t1.v1 == t2.v3)) { shared++; t1E = 1; t2E = 1; }
+            const TriInd t1 = addTriangle();
+            const TriInd o1 = addTriangle();
+            setTriangle(t, vi, a, p, o1, t1, ntb, cab, 0, ctb);
+            setTriangle(t1, vi, p, b, o, nta, t, cab, cta, 0);
+            setTriangle(o, q, b, p, t1, o1, noa, cab, 0, coa);
+            setTriangle(o1, q, p, a, t, nob, o, cab, cob, 0);
+            replaceNeighbor(nta, t, t1);
+            replaceNeighbor(nob, o, o1);
+            stack.push_back({ t, 2 });
+            stack.push_back({ t1, 1 });
+            stack.push_back({ o, 2 });
+            stack.push_back({ o1, 1 });
+        }
+        legalize(stack);
+        hint = vertTri_[p];
+    }
+
+    // Flip the edge opposite vertex i of t. With t = (p, a, b) and its neighbour
+    // o = (q, b, a), the result is t = (p, a, q) and o = (p, q, b).
+    template <typename T>
+    void Triangulation<T>::flip(TriInd t, int i)
+    {
+        const TriInd o = triNeighbors_[t * 3 + i];
+        const VertInd p = triVerts_[t * 3 + i];
+        const VertInd a = triVerts_[t * 3 + (i + 1) % 3];
+        const VertInd b = triVerts_[t * 3 + (i + 2) % 3];
+        const TriInd nta = triNeighbors_[t * 3 + (i + 1) % 3], ntb = triNeighbors_[t * 3 + (i + 2) % 3];
+        const std::uint8_t cta = triConstrained_[t * 3 + (i + 1) % 3], ctb = triConstrained_[t * 3 + (i + 2) % 3];
+        const int k = neighborIndex(o, t);
+        const VertInd q = triVerts_[o * 3 + k];
+        const TriInd nob = triNeighbors_[o * 3 + (k + 1) % 3], noa = triNeighbors_[o * 3 + (k + 2) % 3];
+        const std::uint8_t cob = triConstrained_[o * 3 + (k + 1) % 3], coa = triConstrained_[o * 3 + (k + 2) % 3];
 
-                if (shared == 2)
+        setTriangle(t, p, a, q, nob, o, ntb, cob, 0, ctb);
+        setTriangle(o, p, q, b, noa, nta, t, coa, cta, 0);
+        replaceNeighbor(nob, o, t);
+        replaceNeighbor(nta, t, o);
+    }
+
+    // Each stack entry is (triangle, index of the new vertex); the edge opposite
+    // it is flipped while it violates the empty-circle property
+    template <typename T>
+    void Triangulation<T>::legalize(std::vector<std::pair<TriInd, int>>& stack)
+    {
+        while (!stack.empty())
+        {
+            const TriInd t = stack.back().first;
+            const int i = stack.back().second;
+            stack.pop_back();
+            const TriInd o = triNeighbors_[t * 3 + i];
+            if (o == noNeighbor || triConstrained_[t * 3 + i])
+            {
+                continue;
+            }
+            const VertInd q = triVerts_[o * 3 + neighborIndex(o, t)];
+            if (inCircle(t, q))
+            {
+                flip(t, i);
+                stack.push_back({ t, 0 });
+                stack.push_back({ o, 0 });
+            }
+        }
+    }
+
+    // Finds the triangle t containing edge u-v; i is the index of its third vertex
+    template <typename T>
+    bool Triangulation<T>::findEdge(VertInd u, VertInd v, TriInd& t, int& i) const
+    {
+        if (u >= vertTri_.size() || v >= vertTri_.size() || vertTri_[u] == noNeighbor)
+        {
+            return false;
+        }
+        const TriInd start = vertTri_[u];
+        t = start;
+        do
+        {
+            const int j = vertexIndex(t, u);
+            if (triVerts_[t * 3 + (j + 1) % 3] == v)
+            {
+                i = (j + 2) % 3;
+                return true;
+            }
+            if (triVerts_[t * 3 + (j + 2) % 3] == v)
+            {
+                i = (j + 1) % 3;
+                return true;
+            }
+            t = triNeighbors_[t * 3 + (j + 2) % 3];
+        } while (t != start && t != noNeighbor);
+        if (t == start)
+        {
+            return false;
+        }
+        // Open fan (super-triangle vertex): rotate the other way as well
+        t = triNeighbors_[start * 3 + (vertexIndex(start, u) + 1) % 3];
+        while (t != noNeighbor)
+        {
+            const int j = vertexIndex(t, u);
+            if (triVerts_[t * 3 + (j + 1) % 3] == v)
+            {
+                i = (j + 2) % 3;
+                return true;
+            }
+            if (triVerts_[t * 3 + (j + 2) % 3] == v)
+            {
+                i = (j + 1) % 3;
+                return true;
+            }
+            t = triNeighbors_[t * 3 + (j + 1) % 3];
+        }
+        return false;
+    }
+
+    // Sloan's algorithm: collect the edges crossing a-b, flip them (when their quad is
+    // convex) until none cross, then restore the Delaunay property on the new edges
+    template <typename T>
+    void Triangulation<T>::insertConstraint(VertInd a, VertInd b, int depth)
+    {
+        if (a == b || a >= superStart_ || b >= superStart_ || vertTri_[a] == noNeighbor || vertTri_[b] == noNeighbor || depth > 64)
+        {
+            return;
+        }
+
+        TriInd t;
+        int i;
+        if (findEdge(a, b, t, i))
+        {
+            triConstrained_[t * 3 + i] = 1;
+            const TriInd o = triNeighbors_[t * 3 + i];
+            if (o != noNeighbor)
+            {
+                triConstrained_[o * 3 + neighborIndex(o, t)] = 1;
+            }
+            return;
+        }
+
+        const double abx = xs_[b] - xs_[a], aby = ys_[b] - ys_[a];
+        const double abLenSq = abx * abx + aby * aby;
+        auto between = [&](VertInd c)
+        {
+            const double d = (xs_[c] - xs_[a]) * abx + (ys_[c] - ys_[a]) * aby;
+            return d > 0 && d < abLenSq;
+        };
+
+        // --- 1. Find the triangle around a whose wedge contains the direction a->b ---
+        std::vector<Edge<T>> crossing;
+        VertInd left = noNeighbor, right = noNeighbor;
+        const TriInd start = vertTri_[a];
+        t = start;
+        do
+        {
+            const int j = vertexIndex(t, a);
+            const VertInd x = triVerts_[t * 3 + (j + 1) % 3];
+            const VertInd y = triVerts_[t * 3 + (j + 2) % 3];
+            const double ox = orient(a, b, x), oy = orient(a, b, y);
+            if (ox == 0 && x < superStart_ && between(x))
+            {
+                insertConstraint(a, x, depth + 1);
+                insertConstraint(x, b, depth + 1);
+                return;
+            }
+            if (ox < 0 && oy > 0)
+            {
+                right = x;
+                left = y;
+                break;
+            }
+            t = triNeighbors_[t * 3 + (j + 2) % 3];
+        } while (t != start && t != noNeighbor);
+        if (left == noNeighbor)
+        {
+            return;
+        }
+
+        // --- 2. Walk along a->b collecting the crossed edges ---
+        for (;;)
+        {
+            crossing.push_back({ left, right });
+            const int j = 3 - vertexIndex(t, left) - vertexIndex(t, right);
+            const TriInd o = triNeighbors_[t * 3 + j];
+            if (o == noNeighbor)
+            {
+                return;
+            }
+            const VertInd q = triVerts_[o * 3 + neighborIndex(o, t)];
+            t = o;
+            if (q == b)
+            {
+                break;
+            }
+            const double oq = orient(a, b, q);
+            if (oq == 0)
+            {
+                insertConstraint(a, q, depth + 1);
+                insertConstraint(q, b, depth + 1);
+                return;
+            }
+            if (oq > 0)
+            {
+                left = q;
+            }
+            else
+            {
+                right = q;
+            }
+        }
+
+        // --- 3. Flip crossing edges away ---
+        std::vector<Edge<T>> newEdges;
+        std::size_t head = 0;
+        std::size_t budget = 64 * crossing.size() * crossing.size() + 1024;
+        while (head < crossing.size() && budget-- > 0)
+        {
+            const Edge<T> e = crossing[head++];
+            if (!findEdge(e.v1, e.v2, t, i))
+            {
+                continue;
+            }
+            const TriInd o = triNeighbors_[t * 3 + i];
+            const VertInd p = triVerts_[t * 3 + i];
+            const VertInd q = triVerts_[o * 3 + neighborIndex(o, t)];
+            const double ou = orient(p, q, e.v1), ov = orient(p, q, e.v2);
+            if ((ou > 0 && ov < 0) || (ou < 0 && ov > 0))
+            {
+                flip(t, i);
+                const bool sharesEnd = p == a || p == b || q == a || q == b;
+                const double op = orient(a, b, p), oq = orient(a, b, q);
+                if (!sharesEnd && ((op > 0 && oq < 0) || (op < 0 && oq > 0)))
+                {
+                    crossing.push_back({ p, q });
+                }
+                else
+                {
+                    newEdges.push_back({ p, q });
+                }
+            }
+            else
+            {
+                crossing.push_back(e);
+            }
+            // Compact the queue once the consumed prefix dominates
+            if (head > 1024 && head * 2 > crossing.size())
+            {
+                crossing.erase(crossing.begin(), crossing.begin() + head);
+                head = 0;
+            }
+        }
+
+        if (!findEdge(a, b, t, i))
+        {
+            return;
+        }
+        triConstrained_[t * 3 + i] = 1;
+        triConstrained_[triNeighbors_[t * 3 + i] * 3 + neighborIndex(triNeighbors_[t * 3 + i], t)] = 1;
+
+        // --- 4. Restore the Delaunay property on the newly created edges ---
+        bool swapped = true;
+        for (int pass = 0; swapped && pass < 64; ++pass)
+        {
+            swapped = false;
+            for (auto& e : newEdges)
+            {
+                if (!findEdge(e.v1, e.v2, t, i) || triConstrained_[t * 3 + i])
+                {
+                    continue;
+                }
+                const TriInd o = triNeighbors_[t * 3 + i];
+                if (o == noNeighbor)
+                {
+                    continue;
+                }
+                const VertInd p = triVerts_[t * 3 + i];
+                const VertInd q = triVerts_[o * 3 + neighborIndex(o, t)];
+                if (inCircle(t, q))
                 {
-                    adj[i * 3 + t1E] = j;
-                    adj[j * 3 + t2E] = i;
+                    flip(t, i);
+                    e = { p, q };
+                    swapped = true;
                 }
             }
         }
-        return adj;
     }
-}
\ No newline at end of file
+}
@@ -1,45 +1,61 @@
 #include "Viewer.h"
 #include "Boundary.h"
+#include "BoundaryImporter.h"
 #include "Simulation2D.h"
 #include "MeshGenerator2D.h"
 #include "models.h"
-#include "qmorph.h"
+#include "Qmorph.h"
+#include "Utils.h"
 #include <iostream>
 #include <vector>
 #include <glm/glm.hpp>
 #include <algorithm>
-
-int main() {
-    // --- 1. xKwһģ ---
-    std::vector<glm::vec2> active_shape_vertices = get_lake_shape_vertices();
-
-    if (active_shape_vertices.empty()) return -1;
-
-
-
-    // --- 2. ҪČ ---
-    Boundary boundary(active_shape_vertices);
+#include <string>
+
+int main(int argc, char** argv) {
+    // --- 1. 選擇並歸一化模型 ---
+    // 用法：SPHMesh [边界文件 (.poly/.csv/.wkt)] [简化容差]
+    BoundaryImporter::Result imported;
+    if (argc > 1) {
+        BoundaryImporter::Options options;
+        if (argc > 2 && !parse_float(argv[2], options.simplify_tolerance)) {
+            std::cerr << "Error: Invalid simplify tolerance " << argv[2] << std::endl;
+            std::cerr << "Usage: SPHMesh [boundary (.poly/.csv/.wkt)] [simplify tolerance]" << std::endl;
+            return -1;
+        }
+        if (!BoundaryImporter::load(argv[1], imported, options)) return -1;
+    }
+    else {
+        imported.outer = get_lake_shape_vertices();
+    }
+
+    if (imported.outer.empty()) return -1;
+
+
+
+    // --- 2. 創建所有需要的對象 ---
+    Boundary boundary(std::move(imported.outer), std::move(imported.holes));
     Simulation2D sim(boundary);
     CGALMeshGenerator  generator;
     Qmorph qmorph_converter;
     //MeshGenerator2D generator;
 
-    // --- 3. O Viewer ---
+    // --- 3. 設置 Viewer ---
     Viewer viewer(1280, 720, "SPH Remeshing - Dynamic Mesh Generation");
 
-    // Ќ󶼽o Viewer 
+    // 將所有對象都交給 Viewer 來管理
    viewer.set_boundary(&boundary);
     viewer.set_simulation2d(&sim);
    // viewer.set_mesh_generator2d(&generator);
 
-   // ֱӴ sim ȡ grid ָ룬
+   // 直接从 sim 对象获取 grid 指针，代码更清晰
     viewer.set_background_grid(sim.get_background_grid());
 
     viewer.set_cgal_generator(&generator);
     viewer.set_qmorph_generator(&qmorph_converter);
 
 
-    // --- 4. ѭh ---
+    // --- 4. 啟動主循環 ---
     viewer.run();
 
     return 0;
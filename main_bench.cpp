@@ -0,0 +1,507 @@
+#include "BackgroundGrid.h"
+#include "Boundary.h"
+#include "CGALMeshGenerator.h"
+#include "DelaunayMeshGenerator.h"
+#include "EdgeAdjacency.h"
+#include "MeshGenerator2D.h"
+#include "Qmorph.h"
+#include "Simulation2D.h"
+#include "TaskScheduler.h"
+#include "Utils.h"
+#include "models.h"
+#ifdef SPHMESH_WITH_TRIANGLE
+#include "MeshGeneratorDelaunay.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 热点函数的微基准测试：所有输入都由固定种子的 create_complex_lake 与随机点生成。
+// 随机数直接取自 mt19937 的输出 (seeded_uniform)，同一种子在不同提交、不同标准库之间得到相同的输入
+// (编译器的浮点舍入差异除外)，结果写成 JSON 便于比较
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Params = std::vector<std::pair<std::string, double>>;
+
+struct Options {
+    std::vector<int> sizes = { 1000, 10000, 100000 };      // compute_forces / 三角化 / 四边形转换的粒子数
+    std::vector<int> boundary_sizes = { 64, 256, 1024, 4096, 16384 }; // 边界查询的边界顶点数
+    int num_queries = 100000;       // 每次边界查询计时的查询点数
+    int num_samples = 1000000;      // 每次背景网格采样计时的采样点数
+    int max_force_particles = 20000; // compute_forces 是 O(n^2) 的全配对，超过该粒子数时跳过
+    unsigned int seed = 12345;
+    double min_time_ms = 500.0;     // 每项至少累计运行的时间，不足时重复
+    unsigned int num_threads = 0;   // 0 为硬件线程数
+    std::string output = "sphmesh_bench.json";
+    std::string filter;             // 非空时只运行名字中包含该子串的项目
+};
+
+struct Result {
+    std::string name;
+    Params params;
+    int iterations = 0;
+    double min_ms = 0.0;
+    double median_ms = 0.0;
+    double mean_ms = 0.0;
+};
+
+// 防止被测调用的结果被优化掉
+volatile double g_sink = 0.0;
+
+void print_usage() {
+    std::cout <<
+        "Usage: sphmesh_bench [options]\n"
+        "  --sizes <n,n,...>      particle counts for forces/triangulation/qmorph (default 1000,10000,100000)\n"
+        "  --boundary-sizes <..>  boundary vertex counts for the boundary queries (default 64,...,16384)\n"
+        "  --force-limit <n>      skip compute_forces (O(n^2)) above this particle count (default 20000)\n"
+        "  --seed <s>             positive seed for all generated inputs (default 12345)\n"
+        "  --min-time <ms>        repeat each benchmark until it ran this long (default 500)\n"
+        "  --threads <n>          task pool size (default: hardware threads)\n"
+        "  --filter <text>        only run benchmarks whose name contains text\n"
+        "  --quick                small sizes for a smoke test\n"
+        "  --out <file.json>      results file (default sphmesh_bench.json)\n";
+}
+
+// 逗号分隔的正整数列表，任何一项不合法时返回 false
+bool parse_list(const std::string& text, std::vector<int>& values) {
+    std::vector<int> parsed;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        int value = 0;
+        if (!parse_int(item.c_str(), value) || value <= 0) return false;
+        parsed.push_back(value);
+    }
+    if (parsed.empty()) return false;
+    values.swap(parsed);
+    return true;
+}
+
+int invalid_value(const std::string& option, const char* value) {
+    std::cerr << "Error: Invalid value " << value << " for " << option << std::endl;
+    print_usage();
+    return -1;
+}
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    bool wants(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    // 重复执行 func 直到累计时间达到 min_time (至少一次)，记录每次的耗时。
+    // 计时期间关闭 std::cout，被测函数自身的进度输出不计入耗时也不刷屏
+    template <typename Func>
+    void measure(const std::string& name, Params params, Func&& func) {
+        std::vector<double> times;
+        double total = 0.0;
+        std::streambuf* cout_buffer = std::cout.rdbuf(nullptr);
+        while (times.empty() || (total < options_.min_time_ms && times.size() < 1000)) {
+            const auto start = Clock::now();
+            func();
+            times.push_back(elapsed_ms(start));
+            total += times.back();
+        }
+        std::cout.rdbuf(cout_buffer);
+        std::cout.clear();
+        std::sort(times.begin(), times.end());
+
+        Result result;
+        result.name = name;
+        result.params = std::move(params);
+        result.iterations = static_cast<int>(times.size());
+        result.min_ms = times.front();
+        result.median_ms = times.size() % 2 ? times[times.size() / 2] : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+        result.mean_ms = total / times.size();
+
+        std::cout << "  " << name;
+        for (const auto& p : result.params) std::cout << " " << p.first << "=" << p.second;
+        std::cout << ": median " << result.median_ms << " ms, min " << result.min_ms << " ms ("
+                  << result.iterations << " iterations)" << std::endl;
+        results_.push_back(std::move(result));
+    }
+
+    bool save_json(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot write benchmark results to " << path << std::endl;
+            return false;
+        }
+        file << "{\n  \"benchmark\": \"sphmesh\",\n  \"seed\": " << options_.seed
+             << ",\n  \"threads\": " << TaskScheduler::instance().get_num_threads()
+             << ",\n  \"min_time_ms\": " << options_.min_time_ms << ",\n  \"results\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            file << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"params\": {";
+            for (size_t k = 0; k < r.params.size(); ++k) {
+                file << (k ? ", " : "") << "\"" << r.params[k].first << "\": " << r.params[k].second;
+            }
+            file << "}, \"iterations\": " << r.iterations << ", \"min_ms\": " << r.min_ms
+                 << ", \"median_ms\": " << r.median_ms << ", \"mean_ms\": " << r.mean_ms << "}";
+        }
+        file << (results_.empty() ? "]\n" : "\n  ]\n") << "}\n";
+        std::cout << "Saved benchmark results to " << path << std::endl;
+        return true;
+    }
+
+private:
+    const Options& options_;
+    std::vector<Result> results_;
+};
+
+// 基准测试用的湖泊边界，尺寸与交互界面的默认湖泊相近 (直径约 10)
+Boundary make_lake(int num_vertices, unsigned int seed) {
+    return Boundary(create_complex_lake(num_vertices, 5.0f, 0.5f, 0.1f, seed));
+}
+
+// 包围盒 (四周各放大 10%) 内均匀分布的随机点
+std::vector<glm::vec2> make_points(const Boundary& boundary, int count, unsigned int seed) {
+    const glm::vec4& aabb = boundary.get_aabb();
+    const glm::vec2 margin = 0.1f * glm::vec2(aabb.z - aabb.x, aabb.w - aabb.y);
+    std::mt19937 rng(seed);
+    std::vector<glm::vec2> points(count);
+    for (auto& p : points) {
+        p.x = seeded_uniform(rng, aabb.x - margin.x, aabb.z + margin.x);
+        p.y = seeded_uniform(rng, aabb.y - margin.y, aabb.w + margin.y);
+    }
+    return points;
+}
+
+// 以 std::map 按无向边配对半边，作为 build_edge_adjacency 的参照 (Qmorph 原先的做法)
+size_t map_edge_adjacency(const std::vector<MeshTriangle>& triangles, std::vector<std::uint32_t>& twin) {
+    const std::uint32_t invalid = 0xFFFFFFFFu;
+    twin.assign(triangles.size() * 3, invalid);
+    std::map<std::pair<unsigned int, unsigned int>, std::uint32_t> open_edges;
+    size_t paired = 0;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int a = triangles[t][k], b = triangles[t][(k + 1) % 3];
+            const std::uint32_t h = static_cast<std::uint32_t>(3 * t + k);
+            auto inserted = open_edges.emplace(std::make_pair(std::min(a, b), std::max(a, b)), h);
+            if (inserted.second) continue;
+            twin[h] = inserted.first->second;
+            twin[inserted.first->second] = h;
+            open_edges.erase(inserted.first);
+            ++paired;
+        }
+    }
+    return paired;
+}
+
+// 原先 Qmorph 的贪心合并：按 std::map 的 (较小端点, 较大端点) 顺序遍历内部边，
+// 质量为基于 acos 的角度度量，作为 Greedy 模式合并数的参照
+size_t map_greedy_quads(const std::vector<glm::vec2>& vertices, const std::vector<MeshTriangle>& triangles) {
+    auto quality = [](const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4) {
+        auto angle = [](const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+            return glm::degrees(std::acos(glm::dot(glm::normalize(a - b), glm::normalize(c - b))));
+        };
+        const float angles[4] = { angle(p4, p1, p2), angle(p1, p2, p3), angle(p2, p3, p4), angle(p3, p4, p1) };
+        const float min_angle = *std::min_element(angles, angles + 4), max_angle = *std::max_element(angles, angles + 4);
+        if (max_angle > 165.0f || min_angle < 25.0f) return 0.0f;
+        return 1.0f - (max_angle - 90.0f) / 75.0f;
+    };
+
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<size_t>> edge_to_triangles;
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int a = triangles[t][k], b = triangles[t][(k + 1) % 3];
+            edge_to_triangles[{ std::min(a, b), std::max(a, b) }].push_back(t);
+        }
+    }
+    std::vector<char> merged(triangles.size(), 0);
+    size_t quads = 0;
+    for (const auto& [edge, tris] : edge_to_triangles) {
+        if (tris.size() != 2 || merged[tris[0]] || merged[tris[1]]) continue;
+        unsigned int other[2];
+        for (int i = 0; i < 2; ++i) {
+            const auto& t = triangles[tris[i]];
+            for (int k = 0; k < 3; ++k) {
+                if (t[k] != edge.first && t[k] != edge.second) other[i] = t[k];
+            }
+        }
+        if (quality(vertices[other[0]], vertices[edge.first], vertices[other[1]], vertices[edge.second]) > 0.3f) {
+            merged[tris[0]] = merged[tris[1]] = 1;
+            ++quads;
+        }
+    }
+    return quads;
+}
+
+// 粒子数大致与网格分辨率的平方成正比，但分辨率低时边界粒子占比较大，
+// 所以按平方关系迭代修正几次，直到生成的粒子数与目标相差不到 5%
+float resolution_for(const Boundary& boundary, int num_particles, unsigned int seed) {
+    float resolution = 80.0f;
+    for (int pass = 0; pass < 4; ++pass) {
+        const Simulation2D probe(boundary, resolution, seed);
+        const float count = static_cast<float>(std::max<size_t>(1, probe.get_particles().size()));
+        if (std::abs(count - num_particles) < 0.05f * num_particles) break;
+        resolution *= std::sqrt(num_particles / count);
+    }
+    return resolution;
+}
+
+void bench_boundary(Runner& runner, const Options& options) {
+    std::cout << "Boundary queries (" << options.num_queries << " points):" << std::endl;
+    for (int size : options.boundary_sizes) {
+        const Boundary boundary = make_lake(size, options.seed);
+        const auto points = make_points(boundary, options.num_queries, options.seed + 1);
+        const Params params = { { "boundary_vertices", size }, { "queries", options.num_queries } };
+
+        if (runner.wants("boundary_is_inside")) {
+            runner.measure("boundary_is_inside", params, [&] {
+                int inside = 0;
+                for (const auto& p : points) inside += boundary.is_inside(p);
+                g_sink = inside;
+            });
+        }
+        if (runner.wants("boundary_closest_point")) {
+            runner.measure("boundary_closest_point", params, [&] {
+                float sum = 0.0f;
+                for (const auto& p : points) sum += boundary.closest_point(p).x;
+                g_sink = sum;
+            });
+        }
+        // 不经过边索引的逐边遍历，作为 closest_point 的参照
+        if (runner.wants("closest_point_on_polygon")) {
+            runner.measure("closest_point_on_polygon", params, [&] {
+                float sum = 0.0f;
+                for (const auto& p : points) sum += closest_point_on_polygon(p, boundary.get_vertices()).x;
+                g_sink = sum;
+            });
+        }
+    }
+}
+
+void bench_background_grid(Runner& runner, const Options& options) {
+    std::cout << "Background grid:" << std::endl;
+    const int boundary_size = 1024;
+    const Boundary boundary = make_lake(boundary_size, options.seed);
+    const float width = boundary.get_aabb().z - boundary.get_aabb().x;
+    for (float resolution : { 80.0f, 160.0f, 320.0f }) {
+        if (!runner.wants("background_grid_build")) break;
+        runner.measure("background_grid_build", { { "boundary_vertices", boundary_size }, { "resolution", resolution } }, [&] {
+            BackgroundGrid grid(boundary, width / resolution);
+            g_sink = grid.get_width();
+        });
+    }
+
+    if (!runner.wants("background_grid_sample")) return;
+    const BackgroundGrid grid(boundary, width / 80.0f);
+    const auto points = make_points(boundary, options.num_samples, options.seed + 2);
+    runner.measure("background_grid_sample", { { "resolution", 80 }, { "samples", options.num_samples } }, [&] {
+        float sum = 0.0f;
+        for (const auto& p : points) {
+            sum += grid.get_target_size(p);
+            sum += grid.get_target_direction(p).x;
+        }
+        g_sink = sum;
+    });
+}
+
+void bench_particles(Runner& runner, const Options& options) {
+    const Boundary boundary = make_lake(256, options.seed);
+    for (int size : options.sizes) {
+        std::streambuf* cout_buffer = std::cout.rdbuf(nullptr); // 粒子生成的进度输出
+        const float resolution = resolution_for(boundary, size, options.seed);
+        Simulation2D simulation(boundary, resolution, options.seed);
+        std::cout.rdbuf(cout_buffer);
+        std::cout.clear();
+        const int count = static_cast<int>(simulation.get_particles().size());
+        std::cout << "Particles: requested " << size << ", generated " << count << " (resolution " << resolution << ")" << std::endl;
+        const Params params = { { "requested", size }, { "particles", count } };
+
+        if (runner.wants("compute_forces") && count > options.max_force_particles) {
+            std::cout << "  compute_forces skipped: " << count << " particles exceeds --force-limit "
+                      << options.max_force_particles << " (O(n^2) pairs per step)" << std::endl;
+        }
+        else if (runner.wants("compute_forces")) {
+            runner.measure("compute_forces", params, [&] {
+                simulation.compute_forces();
+                g_sink = simulation.get_particles().front().force.x;
+            });
+        }
+
+        // 不经过三角化、直接按网格单元连接粒子的结构化生成器，网格尺寸取背景网格的单元尺寸
+        if (runner.wants("structured_mesh")) {
+            const float grid_size = simulation.get_background_grid()->get_cell_size();
+            MeshGenerator2D structured;
+            runner.measure("structured_mesh", params, [&] {
+                structured.generate(simulation, boundary, grid_size);
+                g_sink = static_cast<double>(structured.get_quads().size());
+            });
+        }
+
+        // 另外两个三角化后端 (cdd 与 Triangle 库)，与下面的 cgal_triangulate 使用相同的粒子与边界
+        if (runner.wants("cdd_triangulate")) {
+            float min_spacing = std::numeric_limits<float>::max();
+            for (const auto& p : simulation.get_particles()) min_spacing = std::min(min_spacing, p.smoothing_h);
+            DelaunayMeshGenerator cdd;
+            runner.measure("cdd_triangulate", params, [&] {
+                cdd.generate_mesh(simulation.get_particles(), boundary, min_spacing);
+                g_sink = static_cast<double>(cdd.get_triangles().size());
+            });
+        }
+#ifdef SPHMESH_WITH_TRIANGLE
+        if (runner.wants("triangle_triangulate")) {
+            MeshGeneratorDelaunay triangle;
+            runner.measure("triangle_triangulate", params, [&] {
+                triangle.generate_mesh(simulation.get_particles(), boundary);
+                g_sink = static_cast<double>(triangle.get_triangles().size());
+            });
+        }
+#endif
+
+        // 按各项的完整名字判断，--filter 给出某一项的全名时也能匹配
+        const bool want_triangulate = runner.wants("cgal_triangulate");
+        const bool want_qmorph = runner.wants("qmorph");
+        const bool want_adjacency = runner.wants("edge_adjacency_sorted") || runner.wants("edge_adjacency_map");
+        const bool want_greedy = runner.wants("qmorph_greedy") || runner.wants("qmorph_greedy_map");
+        if (!want_triangulate && !want_qmorph && !want_adjacency && !want_greedy) continue;
+        CGALMeshGenerator generator;
+        if (want_triangulate) {
+            runner.measure("cgal_triangulate", params, [&] {
+                generator.generate_mesh(simulation.get_particles(), boundary);
+                g_sink = static_cast<double>(generator.get_triangles().size());
+            });
+        }
+        else {
+            generator.generate_mesh(simulation.get_particles(), boundary);
+        }
+
+        // 三角网格的半边配对：基数排序的边键 与 std::map 参照
+        if (want_adjacency) {
+            Params adjacency_params = params;
+            adjacency_params.push_back({ "triangles", static_cast<double>(generator.get_triangles().size()) });
+            std::vector<std::uint32_t> twin;
+            if (runner.wants("edge_adjacency_sorted")) {
+                runner.measure("edge_adjacency_sorted", adjacency_params, [&] {
+                    g_sink = static_cast<double>(build_edge_adjacency(generator.get_triangles(), twin));
+                });
+            }
+            if (runner.wants("edge_adjacency_map")) {
+                runner.measure("edge_adjacency_map", adjacency_params, [&] {
+                    g_sink = static_cast<double>(map_edge_adjacency(generator.get_triangles(), twin));
+                });
+            }
+        }
+
+        // Greedy 模式与原先按 std::map 顺序合并的参照：合并数记录在参数中，明显变少时给出警告
+        if (want_greedy) {
+            std::streambuf* cout_buffer = std::cout.rdbuf(nullptr);
+            Qmorph greedy;
+            greedy.set_mode(Qmorph::Mode::Greedy);
+            const size_t quads = greedy.run(generator).quads.size();
+            std::cout.rdbuf(cout_buffer);
+            std::cout.clear();
+            const size_t reference_quads = map_greedy_quads(generator.get_vertices(), generator.get_triangles());
+            Params greedy_params = params;
+            greedy_params.push_back({ "triangles", static_cast<double>(generator.get_triangles().size()) });
+            greedy_params.push_back({ "quads", static_cast<double>(quads) });
+            greedy_params.push_back({ "reference_quads", static_cast<double>(reference_quads) });
+            std::cout << "Greedy quads: " << quads << " (std::map order reference " << reference_quads << ")" << std::endl;
+            if (quads < reference_quads * 0.99) {
+                std::cerr << "Warning: Greedy merged " << quads << " quads, fewer than the reference " << reference_quads << std::endl;
+            }
+            if (runner.wants("qmorph_greedy")) {
+                runner.measure("qmorph_greedy", greedy_params, [&] {
+                    g_sink = static_cast<double>(greedy.run(generator).quads.size());
+                });
+            }
+            if (runner.wants("qmorph_greedy_map")) {
+                runner.measure("qmorph_greedy_map", greedy_params, [&] {
+                    g_sink = static_cast<double>(map_greedy_quads(generator.get_vertices(), generator.get_triangles()));
+                });
+            }
+        }
+
+        if (want_qmorph) {
+            Params qmorph_params = params;
+            qmorph_params.push_back({ "triangles", static_cast<double>(generator.get_triangles().size()) });
+            runner.measure("qmorph", qmorph_params, [&] {
+                Qmorph qmorph;
+                qmorph.set_mode(Qmorph::Mode::AdvancingFront);
+                qmorph.set_all_quad(false); // 只计转换本身，不含局部收尾
+                auto result = qmorph.run(generator);
+                g_sink = static_cast<double>(result.quads.size());
+            });
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "-h" || arg == "--help") {
+            print_usage();
+            return 0;
+        }
+        else if (arg == "--quick") {
+            options.sizes = { 500, 2000 };
+            options.boundary_sizes = { 64, 1024 };
+            options.num_queries = 10000;
+            options.num_samples = 100000;
+            options.min_time_ms = 50.0;
+        }
+        else if (arg == "--sizes" && has_value) {
+            if (!parse_list(argv[++i], options.sizes)) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--boundary-sizes" && has_value) {
+            if (!parse_list(argv[++i], options.boundary_sizes)) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--force-limit" && has_value) {
+            if (!parse_int(argv[++i], options.max_force_particles) || options.max_force_particles <= 0) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--seed" && has_value) {
+            int seed = 0;
+            if (!parse_int(argv[++i], seed) || seed <= 0) return invalid_value(arg, argv[i]);
+            options.seed = static_cast<unsigned int>(seed);
+        }
+        else if (arg == "--min-time" && has_value) {
+            float min_time = 0.0f;
+            if (!parse_float(argv[++i], min_time) || min_time < 0.0f) return invalid_value(arg, argv[i]);
+            options.min_time_ms = min_time;
+        }
+        else if (arg == "--threads" && has_value) {
+            int threads = 0;
+            if (!parse_int(argv[++i], threads) || threads < 0) return invalid_value(arg, argv[i]);
+            options.num_threads = static_cast<unsigned int>(threads);
+        }
+        else if (arg == "--filter" && has_value) options.filter = argv[++i];
+        else if (arg == "--out" && has_value) options.output = argv[++i];
+        else {
+            std::cerr << "Error: Unknown or incomplete option " << arg << std::endl;
+            print_usage();
+            return -1;
+        }
+    }
+    TaskScheduler::instance().set_num_threads(options.num_threads);
+    std::cout << "sphmesh_bench: seed " << options.seed << ", " << TaskScheduler::instance().get_num_threads()
+              << " threads, min time " << options.min_time_ms << " ms" << std::endl;
+
+    Runner runner(options);
+    bench_boundary(runner, options);
+    bench_background_grid(runner, options);
+    bench_particles(runner, options);
+    return runner.save_json(options.output) ? 0 : -1;
+}
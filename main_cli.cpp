@@ -0,0 +1,160 @@
+#include "MeshingBatch.h"
+#include "MeshingPipeline.h"
+#include "Profiler.h"
+#include "TaskScheduler.h"
+#include "Utils.h"
+#include "models.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// 无界面的命令行入口：不创建窗口，不链接 GLFW/GLAD，适合在没有显示的计算节点上运行
+namespace {
+
+void print_usage() {
+    std::cout <<
+        "Usage: sphmesh_cli <boundary (.poly/.csv/.wkt) | --lake> [options]\n"
+        "       sphmesh_cli --batch <manifest> [options]\n"
+        "  -o <file>              export the mesh (.msh, .vtu, anything else = raw SoA)\n"
+        "  --simplify <tol>       simplify the boundary while importing\n"
+        "  --max-steps <n>        relaxation step limit (default 5000)\n"
+        "  --energy-ratio <r>     converged when kinetic energy < r * peak (default 0.01)\n"
+        "  --mode <m>             greedy | matching | front (default matching)\n"
+        "  --no-all-quad          front mode: keep the leftover triangles instead of closing them locally\n"
+        "  --triangles            skip the quad conversion\n"
+        "  --smooth <m>           none | laplacian | angle | optimization (default laplacian)\n"
+        "  --renumber <m>         none | rcm | hilbert (default rcm)\n"
+        "  --quality              print a mesh quality report\n"
+        "  --threads <n>          task pool size shared by all stages (default: hardware threads)\n"
+        "  --profile <file.json>  write per-phase timings and counters (needs SPHMESH_PROFILE)\n"
+        "Batch options (manifest lines: <input> [output]):\n"
+        "  -j <n>                 concurrent jobs (default: hardware threads)\n"
+        "  --out-dir <dir>        directory for outputs not given in the manifest\n"
+        "  --format <ext>         extension for those outputs (default .msh)\n"
+        "  --results <file>       write one CSV line per job as it finishes\n";
+}
+
+void print_scheduler_stats() {
+    const auto& scheduler = TaskScheduler::instance();
+    const auto stats = scheduler.get_stats();
+    std::cout << "Task pool: " << scheduler.get_num_threads() << " threads, " << stats.tasks << " tasks, "
+              << stats.steals << " steals, busy " << stats.busy_ms << " ms, idle " << stats.idle_ms
+              << " ms, efficiency " << stats.efficiency() * 100.0 << "%" << std::endl;
+}
+
+void save_profile(const std::string& path) {
+    if (path.empty()) return;
+    if (!Profiler::enabled()) {
+        std::cerr << "Warning: Built without SPHMESH_PROFILE, no profile written to " << path << std::endl;
+        return;
+    }
+    Profiler::instance().print(std::cout);
+    Profiler::instance().save_json(path);
+}
+
+int invalid_value(const std::string& option, const char* value) {
+    std::cerr << "Error: Invalid value " << value << " for " << option << std::endl;
+    print_usage();
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2 || !std::strcmp(argv[1], "-h") || !std::strcmp(argv[1], "--help")) {
+        print_usage();
+        return argc < 2 ? -1 : 0;
+    }
+
+    const bool batch_mode = !std::strcmp(argv[1], "--batch");
+    if (batch_mode && argc < 3) {
+        print_usage();
+        return -1;
+    }
+    const int first_option = batch_mode ? 3 : 2;
+    std::string input = argv[first_option - 1], output, profile_path;
+    MeshingPipeline::Options options;
+    MeshingBatch::Options batch_options;
+    for (int i = first_option; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "-o" && has_value) output = argv[++i];
+        else if (arg == "--simplify" && has_value) {
+            if (!parse_float(argv[++i], options.import.simplify_tolerance)) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--max-steps" && has_value) {
+            if (!parse_int(argv[++i], options.max_steps)) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--energy-ratio" && has_value) {
+            if (!parse_float(argv[++i], options.energy_ratio)) return invalid_value(arg, argv[i]);
+        }
+        else if (arg == "--mode" && has_value) {
+            const std::string mode = argv[++i];
+            if (mode == "greedy") options.quad_mode = Qmorph::Mode::Greedy;
+            else if (mode == "matching") options.quad_mode = Qmorph::Mode::Matching;
+            else if (mode == "front") options.quad_mode = Qmorph::Mode::AdvancingFront;
+            else { std::cerr << "Error: Unknown quad mode " << mode << std::endl; return -1; }
+        }
+        else if (arg == "--all-quad") options.all_quad = true;
+        else if (arg == "--no-all-quad") options.all_quad = false;
+        else if (arg == "--triangles") options.convert_quads = false;
+        else if (arg == "--smooth" && has_value) {
+            const std::string method = argv[++i];
+            options.smooth = method != "none";
+            if (method == "laplacian") options.smooth_method = MeshSmoother::Method::Laplacian;
+            else if (method == "angle") options.smooth_method = MeshSmoother::Method::AngleBased;
+            else if (method == "optimization") options.smooth_method = MeshSmoother::Method::Optimization;
+            else if (method != "none") { std::cerr << "Error: Unknown smoothing method " << method << std::endl; return -1; }
+        }
+        else if (arg == "--renumber" && has_value) {
+            const std::string order = argv[++i];
+            options.renumber = order != "none";
+            if (order == "rcm") options.vertex_order = MeshRenumbering::VertexOrder::RCM;
+            else if (order == "hilbert") options.vertex_order = MeshRenumbering::VertexOrder::Hilbert;
+            else if (order != "none") { std::cerr << "Error: Unknown renumbering " << order << std::endl; return -1; }
+        }
+        else if (arg == "--quality") options.report_quality = true;
+        else if (arg == "--profile" && has_value) profile_path = argv[++i];
+        else if (arg == "--threads" && has_value) {
+            int threads = 0;
+            if (!parse_int(argv[++i], threads) || threads < 0) return invalid_value(arg, argv[i]);
+            TaskScheduler::instance().set_num_threads(threads);
+        }
+        else if (batch_mode && arg == "-j" && has_value) {
+            int workers = 0;
+            if (!parse_int(argv[++i], workers) || workers < 0) return invalid_value(arg, argv[i]);
+            batch_options.num_workers = workers;
+        }
+        else if (batch_mode && arg == "--out-dir" && has_value) batch_options.output_dir = argv[++i];
+        else if (batch_mode && arg == "--format" && has_value) {
+            batch_options.output_extension = argv[++i];
+            if (batch_options.output_extension.empty() || batch_options.output_extension.front() != '.') batch_options.output_extension.insert(0, ".");
+        }
+        else if (batch_mode && arg == "--results" && has_value) batch_options.results_path = argv[++i];
+        else {
+            std::cerr << "Error: Unknown or incomplete option " << arg << std::endl;
+            print_usage();
+            return -1;
+        }
+    }
+
+    if (batch_mode) {
+        batch_options.pipeline = options;
+        MeshingBatch batch;
+        batch.set_options(batch_options);
+        if (!batch.load_manifest(input)) return -1;
+        const bool ok = batch.run();
+        print_scheduler_stats();
+        save_profile(profile_path);
+        return ok ? 0 : -1;
+    }
+
+    MeshingPipeline pipeline;
+    pipeline.set_options(options);
+    const bool ok = (input == "--lake") ? pipeline.run(get_lake_shape_vertices(), {}, output)
+                                        : pipeline.run(input, output);
+    pipeline.print_stats(std::cout);
+    print_scheduler_stats();
+    save_profile(profile_path);
+    return ok ? 0 : -1;
+}
@@ -5,28 +5,31 @@
 #include <iostream>
 #include <cmath> // for sin, cos
 #include <random> // for random numbers
+#include "Utils.h"
 //float M_PI = 3.1415926535f;
-// һ򵥵ĺ01֮
-float random_float(float min, float max) {
+// 一个简单的函数，用于生成0到1之间的随机浮点数
+inline float random_float(float min, float max) {
     static std::mt19937 generator(std::random_device{}());
     std::uniform_real_distribution<float> distribution(min, max);
     return distribution(generator);
 }
 
-std::vector<glm::vec2> create_complex_lake(int num_vertices, float avg_radius, float irregularity, float spikeyness) {
+// 新增：按给定的随机数发生器生成湖泊边界，供下面两个版本共用
+template <typename RandomFloat>
+std::vector<glm::vec2> create_complex_lake_with(int num_vertices, float avg_radius, float irregularity, float spikeyness, RandomFloat&& random_float) {
     std::vector<glm::vec2> vertices;
     float angle_step = 2.0f * 3.1415926535f / num_vertices;
 
     for (int i = 0; i < num_vertices; ++i) {
         float angle = i * angle_step;
 
-        // Բΰ뾶
+        // 基础圆形半径
         float base_radius = avg_radius;
 
-        // ӲŶ
+        // 添加不规则性扰动
         float radius = base_radius + random_float(-irregularity, irregularity);
 
-        // һЩ""
+        // 添加一些随机的"尖刺"
         if (random_float(0.0f, 1.0f) < spikeyness) {
             radius *= random_float(1.1f, 1.3f);
         }
@@ -42,7 +45,19 @@ std::vector<glm::vec2> create_complex_lake(int num_vertices, float avg_radius, f
     return vertices;
 }
 
-// ȡһӵġƺı߽״
+inline std::vector<glm::vec2> create_complex_lake(int num_vertices, float avg_radius, float irregularity, float spikeyness) {
+    return create_complex_lake_with(num_vertices, avg_radius, irregularity, spikeyness, random_float);
+}
+
+// 新增：固定种子的版本，相同的参数与种子总是得到相同的边界，与标准库实现无关 (基准测试用)
+inline std::vector<glm::vec2> create_complex_lake(int num_vertices, float avg_radius, float irregularity, float spikeyness, unsigned int seed) {
+    std::mt19937 generator(seed);
+    return create_complex_lake_with(num_vertices, avg_radius, irregularity, spikeyness, [&](float min, float max) {
+        return seeded_uniform(generator, min, max);
+    });
+}
+
+// 函数：获取一个更复杂的、类似湖泊的边界形状
 inline std::vector<glm::vec2> get_lake_shape_vertices() {
     std::vector<glm::vec2> vertices = {
         {2.2f, 8.1f}, {4.5f, 9.2f}, {7.3f, 8.5f}, {9.1f, 6.7f},
@@ -52,7 +67,7 @@ inline std::vector<glm::vec2> get_lake_shape_vertices() {
         {-2.5f, 7.1f}, {0.1f, 6.5f}
     };
 
-    // һʹߴʺϵǰͼ
+    // 归一化处理，使其尺寸适合当前视图
     if (vertices.empty()) return {};
 
     glm::vec2 min_coords = vertices[0];
@@ -66,7 +81,7 @@ inline std::vector<glm::vec2> get_lake_shape_vertices() {
     glm::vec2 center = (min_coords + max_coords) * 0.5f;
     glm::vec2 size = max_coords - min_coords;
     float max_dim = std::max(size.x, size.y);
-    float target_size = 10.0f; // Ŀߴ
+    float target_size = 10.0f; // 目标尺寸
     float scale = (max_dim > 1e-6) ? (target_size / max_dim) : 1.0f;
     for (auto& v : vertices) {
         v = (v - center) * scale;